@@ -0,0 +1,150 @@
+# Compares two suite_bench --json reports
+#
+#     cmake -DBASELINE=baseline.json -DCURRENT=current.json -P benchmarks/compare.cmake
+#
+# and prints the benchmarks in both with their time per unit, the change, and the current IPC and cache misses per unit
+# when the counters were readable. A benchmark regressed when it got more than THRESHOLD percent slower, 5 by default,
+# and by more than the median errors of both runs together. Any regression fails the script, so CI can run it as is.
+
+cmake_minimum_required(VERSION 3.27)
+
+if(NOT DEFINED BASELINE OR NOT DEFINED CURRENT)
+    message(FATAL_ERROR "Usage: cmake -DBASELINE=<report> -DCURRENT=<report> [-DTHRESHOLD=<percent>] -P compare.cmake")
+endif()
+if(NOT DEFINED THRESHOLD)
+    set(THRESHOLD 5)
+endif()
+
+file(READ "${BASELINE}" baseline)
+file(READ "${CURRENT}" current)
+
+# CMake only does integer math, so values become thousandths, rounded, and empty for null. string(JSON) hands numbers
+# back in full double precision, like 5.5339999999999998 for the report's 5.534.
+function(thousandths value out)
+    if(value MATCHES "^(-?)([0-9]+)(\\.([0-9]*))?$")
+        set(sign "${CMAKE_MATCH_1}")
+        set(whole "${CMAKE_MATCH_2}")
+        string(SUBSTRING "${CMAKE_MATCH_4}0000" 0 4 digits)
+        string(REGEX REPLACE "^0+([0-9])" "\\1" digits "${digits}")
+        math(EXPR result "${sign}((${whole} * 10000 + ${digits} + 5) / 10)")
+        set(${out} ${result} PARENT_SCOPE)
+    elseif(value MATCHES "e-")
+        set(${out} 0 PARENT_SCOPE)
+    else()
+        set(${out} "" PARENT_SCOPE)
+    endif()
+endfunction()
+
+# Thousandths back to three decimals
+function(decimal thousandths out)
+    set(sign "")
+    if(thousandths LESS 0)
+        set(sign "-")
+        math(EXPR thousandths "-(${thousandths})")
+    endif()
+    math(EXPR whole "${thousandths} / 1000")
+    math(EXPR fraction "${thousandths} % 1000 + 1000")
+    string(SUBSTRING "${fraction}" 1 3 fraction)
+    set(${out} "${sign}${whole}.${fraction}" PARENT_SCOPE)
+endfunction()
+
+# Tenths of a percent as a signed percentage with one decimal
+function(percent tenths out)
+    set(sign "+")
+    if(tenths LESS 0)
+        set(sign "-")
+        math(EXPR tenths "-(${tenths})")
+    endif()
+    math(EXPR whole "${tenths} / 10")
+    math(EXPR fraction "${tenths} % 10")
+    set(${out} "${sign}${whole}.${fraction}%" PARENT_SCOPE)
+endfunction()
+
+string(JSON baseline_sets GET "${baseline}" working_sets)
+string(JSON current_sets GET "${current}" working_sets)
+if(NOT baseline_sets STREQUAL current_sets)
+    message(WARNING "The reports have different working set sizes, they likely come from different machines")
+endif()
+
+string(JSON baseline_count LENGTH "${baseline}" results)
+math(EXPR baseline_last "${baseline_count} - 1")
+foreach(i RANGE ${baseline_last})
+    string(JSON title GET "${baseline}" results ${i} title)
+    string(JSON name GET "${baseline}" results ${i} name)
+    string(JSON ns GET "${baseline}" results ${i} ns)
+    string(JSON error GET "${baseline}" results ${i} error)
+    string(MD5 id "${title} / ${name}")
+    set(baseline_ns_${id} ${ns})
+    set(baseline_error_${id} ${error})
+    set(baseline_key_${id} "${title} / ${name}")
+    list(APPEND baseline_ids ${id})
+endforeach()
+
+set(regressions 0)
+string(JSON current_count LENGTH "${current}" results)
+math(EXPR current_last "${current_count} - 1")
+foreach(i RANGE ${current_last})
+    string(JSON title GET "${current}" results ${i} title)
+    string(JSON name GET "${current}" results ${i} name)
+    string(JSON unit GET "${current}" results ${i} unit)
+    string(JSON ns GET "${current}" results ${i} ns)
+    string(JSON error GET "${current}" results ${i} error)
+    string(JSON ipc GET "${current}" results ${i} ipc)
+    string(JSON misses GET "${current}" results ${i} cache_misses)
+    string(MD5 id "${title} / ${name}")
+    list(REMOVE_ITEM baseline_ids ${id})
+
+    thousandths("${ns}" after)
+    decimal(${after} shown_ns)
+    thousandths("${ipc}" ipc)
+    thousandths("${misses}" misses)
+
+    set(counters "")
+    if(NOT ipc STREQUAL "")
+        decimal(${ipc} ipc)
+        string(APPEND counters ", IPC ${ipc}")
+    endif()
+    if(NOT misses STREQUAL "")
+        decimal(${misses} misses)
+        string(APPEND counters ", ${misses} cache misses/${unit}")
+    endif()
+
+    if(NOT DEFINED baseline_ns_${id})
+        message(STATUS "${title} / ${name}: ${shown_ns} ns/${unit}, not in the baseline${counters}")
+        continue()
+    endif()
+
+    thousandths("${baseline_ns_${id}}" before)
+    thousandths("${baseline_error_${id}}" before_error)
+    thousandths("${error}" after_error)
+    decimal(${before} shown_before)
+    if(before LESS_EQUAL 0)
+        message(STATUS "${title} / ${name}: ${shown_ns} ns/${unit}, below the baseline's resolution${counters}")
+        continue()
+    endif()
+
+    math(EXPR change "(${after} - ${before}) * 1000 / ${before}")
+    math(EXPR noise "(${before_error} + ${after_error}) / 100")
+    math(EXPR limit "${THRESHOLD} * 10")
+    percent(${change} shown)
+
+    set(verdict "")
+    if(change GREATER limit AND change GREATER noise)
+        set(verdict " REGRESSION")
+        math(EXPR regressions "${regressions} + 1")
+    elseif(change LESS -${limit} AND change LESS -${noise})
+        set(verdict " improved")
+    endif()
+    message(STATUS
+        "${title} / ${name}: ${shown_before} -> ${shown_ns} ns/${unit}, ${shown}${counters}${verdict}"
+    )
+endforeach()
+
+foreach(id IN LISTS baseline_ids)
+    message(STATUS "${baseline_key_${id}}: only in the baseline")
+endforeach()
+
+if(regressions GREATER 0)
+    message(FATAL_ERROR "${regressions} benchmarks regressed by more than ${THRESHOLD}% against ${BASELINE}")
+endif()
+message(STATUS "No regressions against ${BASELINE}")
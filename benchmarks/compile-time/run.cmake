@@ -0,0 +1,102 @@
+# Compile time of a consumer of admat through the headers and through import admat;
+#
+#     cmake -P benchmarks/compile-time/run.cmake
+#
+# configures the consumer project next to this script in build/compile-time, and prints the time to build the module
+# interface, then the ADMAT_CONSUMER_TUS translation units including the headers, then the same ones importing the
+# module. Every run starts from an empty build directory, and the fastest of RUNS is printed. Options, as -D before -P:
+#
+#     TUS        translation units per consumer, 200 by default
+#     HEADERS    headers the header consumer includes, "admat/mat.hpp;admat/vec.hpp" by default
+#     RUNS       runs to take the fastest of, 3 by default
+#     JOBS       parallel compile jobs, the logical core count by default
+#     BUILD_DIR  build directory, build/compile-time by default
+#     GENERATOR  Ninja by default. Makefiles cannot build modules.
+#     BUILD_TYPE Release by default
+#
+# Compiler and flags come from the environment, CXX and CXXFLAGS, as for any configure.
+
+cmake_minimum_required(VERSION 3.28)
+
+get_filename_component(source_dir "${CMAKE_CURRENT_LIST_DIR}" ABSOLUTE)
+get_filename_component(root_dir "${CMAKE_CURRENT_LIST_DIR}/../.." ABSOLUTE)
+
+if(NOT DEFINED TUS)
+    set(TUS 200)
+endif()
+if(NOT DEFINED HEADERS)
+    set(HEADERS "admat/mat.hpp;admat/vec.hpp")
+endif()
+if(NOT DEFINED RUNS)
+    set(RUNS 3)
+endif()
+if(NOT DEFINED JOBS)
+    cmake_host_system_information(RESULT JOBS QUERY NUMBER_OF_LOGICAL_CORES)
+endif()
+if(NOT DEFINED BUILD_DIR)
+    set(BUILD_DIR "${root_dir}/build/compile-time")
+endif()
+if(NOT DEFINED GENERATOR)
+    set(GENERATOR Ninja)
+endif()
+if(NOT DEFINED BUILD_TYPE)
+    set(BUILD_TYPE Release)
+endif()
+
+# Microseconds since the epoch
+function(now out)
+    string(TIMESTAMP value "%s%f" UTC)
+    set(${out} ${value} PARENT_SCOPE)
+endfunction()
+
+# Builds target in BUILD_DIR and sets out to the wall time in milliseconds
+function(timed_build target out)
+    now(start)
+    execute_process(
+        COMMAND "${CMAKE_COMMAND}" --build "${BUILD_DIR}" --target ${target} --parallel ${JOBS}
+        RESULT_VARIABLE result
+        OUTPUT_VARIABLE output
+        ERROR_VARIABLE  output
+    )
+    now(stop)
+    if(NOT result EQUAL 0)
+        message(FATAL_ERROR "Building ${target} failed:\n${output}")
+    endif()
+    math(EXPR elapsed "(${stop} - ${start}) / 1000")
+    set(${out} ${elapsed} PARENT_SCOPE)
+endfunction()
+
+foreach(run RANGE 1 ${RUNS})
+    file(REMOVE_RECURSE "${BUILD_DIR}")
+    execute_process(
+        COMMAND "${CMAKE_COMMAND}" -S "${source_dir}" -B "${BUILD_DIR}" -G "${GENERATOR}"
+                "-DCMAKE_BUILD_TYPE=${BUILD_TYPE}"
+                "-DADMAT_CONSUMER_TUS=${TUS}"
+                "-DADMAT_CONSUMER_HEADERS=${HEADERS}"
+        RESULT_VARIABLE result
+        OUTPUT_VARIABLE output
+        ERROR_VARIABLE  output
+    )
+    if(NOT result EQUAL 0)
+        message(FATAL_ERROR "Configuring ${source_dir} failed:\n${output}")
+    endif()
+
+    # The module first, so the module consumer is timed on its own. Nothing else is built by then, the header
+    # consumer starts from the same empty tree.
+    timed_build(admat_module module_ms)
+    timed_build(consumer_headers headers_ms)
+    timed_build(consumer_module import_ms)
+    message(STATUS "Run ${run}: module interface ${module_ms} ms, headers ${headers_ms} ms, import ${import_ms} ms")
+
+    foreach(step module headers import)
+        if(NOT DEFINED best_${step} OR ${step}_ms LESS best_${step})
+            set(best_${step} ${${step}_ms})
+        endif()
+    endforeach()
+endforeach()
+
+math(EXPR import_total "${best_module} + ${best_import}")
+message(STATUS "")
+message(STATUS "${TUS} translation units, ${JOBS} jobs, fastest of ${RUNS}")
+message(STATUS "  #include ${HEADERS}: ${best_headers} ms")
+message(STATUS "  import admat;: ${best_import} ms, ${import_total} ms with the module interface")
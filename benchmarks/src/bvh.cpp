@@ -0,0 +1,210 @@
+#include "harness.hpp"
+#include <admat/bvh.hpp>
+#include <nanobench.h>
+#include <random>
+#include <thread>
+#include <vector>
+
+using namespace admat;
+using namespace ankerl;
+
+struct mesh {
+    std::vector<vec3> vertices;
+    std::vector<std::uint32_t> indices;
+};
+
+// Rolling terrain of 2 * size * size triangles over [-size, size] in x and z
+auto heightfield(std::uint32_t size) -> mesh {
+    auto result = mesh{};
+    for(std::uint32_t z = 0; z <= size; ++z) {
+        for(std::uint32_t x = 0; x <= size; ++x) {
+            auto fx = static_cast<float>(x) * 2.0f - static_cast<float>(size);
+            auto fz = static_cast<float>(z) * 2.0f - static_cast<float>(size);
+            result.vertices.push_back(vec3{fx, std::sin(fx * 0.05f) * std::cos(fz * 0.07f) * 20.0f, fz});
+        }
+    }
+
+    for(std::uint32_t z = 0; z < size; ++z) {
+        for(std::uint32_t x = 0; x < size; ++x) {
+            auto corner = z * (size + 1) + x;
+            result.indices.insert(result.indices.end(), {corner, corner + size + 1, corner + 1});
+            result.indices.insert(result.indices.end(), {corner + 1, corner + size + 1, corner + size + 2});
+        }
+    }
+    return result;
+}
+
+// Rays from above the terrain pointing down at it at random angles
+auto random_rays(std::uint32_t size, std::size_t count) -> std::vector<ray> {
+    auto gen    = std::mt19937(harness::seed);
+    auto coords = std::uniform_real_distribution{-static_cast<float>(size), static_cast<float>(size)};
+    auto tilt   = std::uniform_real_distribution{-0.5f, 0.5f};
+
+    auto rays = std::vector<ray>{};
+    for(std::size_t i = 0; i < count; ++i) {
+        rays.push_back(ray{{coords(gen), 50.0f, coords(gen)}, {tilt(gen), -1.0f, tilt(gen)}});
+    }
+    return rays;
+}
+
+// One thread per chunk, enough to show the parallel build without a thread pool
+struct thread_executor {
+    template<typename Fn>
+    auto operator()(std::size_t count, std::size_t grain, Fn&& fn) const -> void {
+        auto threads = std::vector<std::jthread>{};
+        for(std::size_t begin = 0; begin < count; begin += grain) {
+            threads.emplace_back([&fn, begin, end = std::min(begin + grain, count)] { fn(begin, end); });
+        }
+    }
+};
+
+auto build(std::uint32_t size) {
+    auto terrain = heightfield(size);
+    auto bounds  = triangle_bounds(terrain.vertices, terrain.indices);
+
+    auto bench = nanobench::Bench()
+                     .title("bvh build " + std::to_string(bounds.size()) + " triangles")
+                     .unit("triangle")
+                     .batch(bounds.size())
+                     .relative(true)
+                     .epochs(3)
+                     .epochIterations(1);
+    bench.run("serial", [&] { nanobench::doNotOptimizeAway(bvh(bounds).nodes().data()); });
+    bench.run("chunked binning", [&] {
+        nanobench::doNotOptimizeAway(bvh(bounds, thread_executor{}, 65536).nodes().data());
+    });
+
+    auto tree = bvh(bounds);
+    bench.run("refit", [&] {
+        tree.refit(bounds);
+        nanobench::doNotOptimizeAway(tree.nodes().data());
+    });
+}
+
+auto closest_hit(std::uint32_t size, bool brute_force) {
+    auto terrain = heightfield(size);
+    auto tree    = bvh(triangle_bounds(terrain.vertices, terrain.indices));
+    auto rays    = random_rays(size, 1024);
+    auto next    = std::size_t{0};
+
+    auto bench = nanobench::Bench()
+                     .title("closest hit " + std::to_string(terrain.indices.size() / 3) + " triangles")
+                     .unit("ray")
+                     .relative(true);
+    if(brute_force) {
+        bench.run("brute force", [&] {
+            const auto& r = rays[next++ % rays.size()];
+            auto closest  = miss;
+            for(std::size_t i = 0; i < terrain.indices.size(); i += 3) {
+                auto hit = intersect(r,
+                                     terrain.vertices[terrain.indices[i]],
+                                     terrain.vertices[terrain.indices[i + 1]],
+                                     terrain.vertices[terrain.indices[i + 2]]);
+                closest  = std::min(closest, hit.t);
+            }
+            nanobench::doNotOptimizeAway(closest);
+        });
+    }
+    bench.run("admat bvh closest hit", [&] {
+        nanobench::doNotOptimizeAway(closest_hit(tree, terrain.vertices, terrain.indices, rays[next++ % rays.size()]));
+    });
+    bench.run("admat bvh any hit", [&] {
+        nanobench::doNotOptimizeAway(any_hit(tree, terrain.vertices, terrain.indices, rays[next++ % rays.size()]));
+    });
+}
+
+auto overlap(std::uint32_t size) {
+    auto terrain = heightfield(size);
+    auto tree    = bvh(triangle_bounds(terrain.vertices, terrain.indices));
+    auto rays    = random_rays(size, 1024);
+    auto next    = std::size_t{0};
+
+    auto bench = nanobench::Bench().title("overlap queries").unit("query").relative(true);
+    bench.run("admat bvh sphere query", [&] {
+        auto hits = std::size_t{0};
+        auto at   = rays[next++ % rays.size()].origin;
+        tree.query(sphere{{at.x, 0.0f, at.z}, 8.0f}, [&](std::uint32_t /*prim*/) { ++hits; });
+        nanobench::doNotOptimizeAway(hits);
+    });
+}
+
+// One ray against a few thousand triangles or boxes, and a packet of rays against one box
+auto packets() {
+    auto terrain   = heightfield(32);
+    auto triangles = triangle_soa::from_indexed(terrain.vertices, terrain.indices);
+    auto boxes     = aabb_soa{};
+    for(const auto& box : triangle_bounds(terrain.vertices, terrain.indices)) {
+        boxes.push_back(box);
+    }
+
+    auto rays = random_rays(32, 1024);
+    auto next = std::size_t{0};
+    auto hits = std::vector<std::uint64_t>((triangles.size() + 63) / 64);
+    auto t    = std::vector<float>(triangles.size());
+
+    auto bench = nanobench::Bench()
+                     .title("ray against " + std::to_string(triangles.size()) + " triangles")
+                     .unit("ray")
+                     .relative(true);
+    bench.run("scalar closest", [&] {
+        const auto& r = rays[next++ % rays.size()];
+        auto closest  = miss;
+        for(std::size_t i = 0; i < terrain.indices.size(); i += 3) {
+            auto hit = intersect(r,
+                                 terrain.vertices[terrain.indices[i]],
+                                 terrain.vertices[terrain.indices[i + 1]],
+                                 terrain.vertices[terrain.indices[i + 2]]);
+            closest  = std::min(closest, hit.t);
+        }
+        nanobench::doNotOptimizeAway(closest);
+    });
+    bench.run("admat packet closest", [&] {
+        nanobench::doNotOptimizeAway(closest_hit(rays[next++ % rays.size()], triangles));
+    });
+    bench.run("admat packet hit mask", [&] {
+        intersect(rays[next++ % rays.size()], triangles, hits, t);
+        nanobench::doNotOptimizeAway(hits.data());
+    });
+    bench.run("scalar boxes", [&] {
+        const auto& r = rays[next++ % rays.size()];
+        auto inv      = inverse_direction(r);
+        for(std::size_t i = 0; i < boxes.size(); ++i) {
+            t[i] = intersect(r.origin, inv, boxes[i], miss);
+        }
+        nanobench::doNotOptimizeAway(t.data());
+    });
+    bench.run("admat packet boxes", [&] {
+        intersect(rays[next++ % rays.size()], boxes, hits, t);
+        nanobench::doNotOptimizeAway(hits.data());
+    });
+
+    auto packet     = ray_soa{};
+    auto packet_box = aabb{{-8.0f, -20.0f, -8.0f}, {8.0f, 20.0f, 8.0f}};
+    for(const auto& r : rays) {
+        packet.push_back(r);
+    }
+
+    auto rays_bench =
+        nanobench::Bench().title("1024 rays against one box").unit("ray").batch(rays.size()).relative(true);
+    rays_bench.run("scalar", [&] {
+        for(std::size_t i = 0; i < rays.size(); ++i) {
+            t[i] = intersect(rays[i], packet_box);
+        }
+        nanobench::doNotOptimizeAway(t.data());
+    });
+    rays_bench.run("admat packet", [&] {
+        intersect(packet, packet_box, hits, t);
+        nanobench::doNotOptimizeAway(hits.data());
+    });
+}
+
+auto main() -> int {
+    // 2 * 181^2 ~ 65k and 2 * 708^2 ~ 1M triangles
+    build(181);
+    build(708);
+    closest_hit(181, true);
+    closest_hit(708, false);
+    overlap(708);
+    packets();
+    return 0;
+}
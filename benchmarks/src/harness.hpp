@@ -0,0 +1,219 @@
+#pragma once
+
+// Shared by the benchmark executables: one seeded generator, working set sizes from the cache hierarchy, a last level
+// cache miss counter, and the JSON report benchmarks/compare.cmake reads.
+
+#include <nanobench.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iomanip>
+#include <optional>
+#include <ostream>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace harness {
+
+inline constexpr std::uint32_t seed = 42;
+
+// Every random input comes from here, so two runs of a binary see the same data
+inline auto generator() -> std::mt19937& {
+    static auto gen = std::mt19937(seed);
+    return gen;
+}
+
+struct working_set {
+    std::string name;
+    std::size_t bytes;
+};
+
+// Half of each cache level, so inputs and outputs stay resident, and four times the last level for memory. glibc
+// reports the sizes, elsewhere they are typical desktop ones.
+inline auto working_sets() -> std::vector<working_set> {
+    auto size = [](long reported, std::size_t fallback) {
+        return reported > 0 ? static_cast<std::size_t>(reported) : fallback;
+    };
+
+#if defined(__linux__) && defined(__GLIBC__)
+    auto l1 = size(sysconf(_SC_LEVEL1_DCACHE_SIZE), 32 * 1024);
+    auto l2 = size(sysconf(_SC_LEVEL2_CACHE_SIZE), 1024 * 1024);
+    auto l3 = size(sysconf(_SC_LEVEL3_CACHE_SIZE), 32 * 1024 * 1024);
+#else
+    auto l1 = size(0, 32 * 1024);
+    auto l2 = size(0, 1024 * 1024);
+    auto l3 = size(0, 32 * 1024 * 1024);
+#endif
+    l2 = std::max(l2, l1 * 2);
+    l3 = std::max(l3, l2 * 2);
+
+    return {{"L1", l1 / 2}, {"L2", l2 / 2}, {"L3", l3 / 2}, {"DRAM", l3 * 4}};
+}
+
+// Last level cache misses of the calling thread, through perf_event_open on Linux. Elsewhere, or when the kernel does
+// not allow it, available() is false and count() returns nothing.
+class cache_miss_counter {
+public:
+    cache_miss_counter() {
+#if defined(__linux__)
+        auto attr           = perf_event_attr{};
+        attr.type           = PERF_TYPE_HARDWARE;
+        attr.size           = sizeof(attr);
+        attr.config         = PERF_COUNT_HW_CACHE_MISSES;
+        attr.disabled       = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv     = 1;
+        fd_                 = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+#endif
+    }
+
+    cache_miss_counter(const cache_miss_counter&)                    = delete;
+    auto operator=(const cache_miss_counter&) -> cache_miss_counter& = delete;
+
+    ~cache_miss_counter() {
+#if defined(__linux__)
+        if(fd_ >= 0) {
+            close(fd_);
+        }
+#endif
+    }
+
+    auto available() const -> bool {
+        return fd_ >= 0;
+    }
+
+    template<typename Fn>
+    auto count(Fn&& fn) -> std::optional<std::uint64_t> {
+#if defined(__linux__)
+        if(available()) {
+            auto value = std::uint64_t{0};
+            ioctl(fd_, PERF_EVENT_IOC_RESET, 0);
+            ioctl(fd_, PERF_EVENT_IOC_ENABLE, 0);
+            fn();
+            ioctl(fd_, PERF_EVENT_IOC_DISABLE, 0);
+            if(read(fd_, &value, sizeof(value)) == static_cast<ssize_t>(sizeof(value))) {
+                return value;
+            }
+            return std::nullopt;
+        }
+#endif
+        fn();
+        return std::nullopt;
+    }
+
+private:
+    int fd_ = -1;
+};
+
+// Results of every benchmark run through it, written as one JSON document. Values are per unit of the bench's batch:
+// nanoseconds, the median absolute error in percent, and the CPU counters nanobench read, null when it could not.
+class report {
+public:
+    // bench.run(name, op), then the cache misses of one more epoch's worth of op calls, outside of nanobench's timing
+    template<typename Op>
+    auto run(ankerl::nanobench::Bench& bench, const std::string& name, Op&& op) -> void {
+        bench.run(name, op);
+        const auto& result = bench.results().back();
+
+        auto epochs = static_cast<double>(std::max<std::size_t>(result.config().mNumEpochs, 1));
+        auto calls  = std::max<std::uint64_t>(
+            static_cast<std::uint64_t>(result.sum(ankerl::nanobench::Result::Measure::iterations) / epochs), 1);
+        auto misses = counter_.count([&] {
+            for(std::uint64_t i = 0; i < calls; ++i) {
+                op();
+            }
+        });
+
+        auto per_unit = std::optional<double>{};
+        if(misses) {
+            per_unit = static_cast<double>(*misses) / (static_cast<double>(calls) * result.config().mBatch);
+        }
+        entries_.push_back(entry{result, per_unit});
+    }
+
+    auto write(std::ostream& out, const std::vector<working_set>& sets) const -> void {
+        using measure = ankerl::nanobench::Result::Measure;
+
+        out << std::fixed << std::setprecision(3) << "{\n    \"seed\": " << seed << ",\n    \"working_sets\": {";
+        for(std::size_t i = 0; i < sets.size(); ++i) {
+            out << (i == 0 ? "" : ", ") << '"' << sets[i].name << "\": " << sets[i].bytes;
+        }
+        out << "},\n    \"results\": [\n";
+
+        for(std::size_t i = 0; i < entries_.size(); ++i) {
+            const auto& result = entries_[i].result;
+            const auto& config = result.config();
+
+            auto per_unit = [&](measure m) -> std::optional<double> {
+                if(!result.has(m)) {
+                    return std::nullopt;
+                }
+                return result.median(m) / config.mBatch;
+            };
+            auto cycles       = per_unit(measure::cpucycles);
+            auto instructions = per_unit(measure::instructions);
+            auto ipc          = std::optional<double>{};
+            if(cycles && instructions && *cycles > 0.0) {
+                ipc = *instructions / *cycles;
+            }
+
+            out << "        {\"title\": ";
+            write_string(out, config.mBenchmarkTitle);
+            out << ", \"name\": ";
+            write_string(out, config.mBenchmarkName);
+            out << ", \"unit\": ";
+            write_string(out, config.mUnit);
+            out << ", \"batch\": " << config.mBatch;
+            out << ", \"ns\": " << result.median(measure::elapsed) / config.mBatch * 1e9;
+            out << ", \"error\": " << result.medianAbsolutePercentError(measure::elapsed) * 100.0;
+            write_field(out, "cycles", cycles);
+            write_field(out, "instructions", instructions);
+            write_field(out, "ipc", ipc);
+            write_field(out, "branch_misses", per_unit(measure::branchmisses));
+            write_field(out, "cache_misses", entries_[i].cache_misses);
+            out << '}' << (i + 1 == entries_.size() ? "\n" : ",\n");
+        }
+        out << "    ]\n}\n";
+    }
+
+private:
+    struct entry {
+        ankerl::nanobench::Result result;
+        std::optional<double> cache_misses;
+    };
+
+    static auto write_string(std::ostream& out, std::string_view text) -> void {
+        out << '"';
+        for(auto c : text) {
+            if(c == '"' || c == '\\') {
+                out << '\\';
+            }
+            out << c;
+        }
+        out << '"';
+    }
+
+    static auto write_field(std::ostream& out, std::string_view name, std::optional<double> value) -> void {
+        out << ", \"" << name << "\": ";
+        if(value) {
+            out << *value;
+        } else {
+            out << "null";
+        }
+    }
+
+    cache_miss_counter counter_;
+    std::vector<entry> entries_;
+};
+
+} // namespace harness
@@ -1,18 +1,30 @@
 #define GLM_FORCE_PURE
 #define GLM_FORCE_DEPTH_ZERO_TO_ONE
 
+#include "harness.hpp"
+#include <admat/affine.hpp>
+#include <admat/batch.hpp>
+#include <admat/bounds.hpp>
+#include <admat/dispatch.hpp>
+#include <admat/frustum.hpp>
+#include <admat/hierarchy.hpp>
 #include <admat/mat.hpp>
+#include <admat/parallel.hpp>
+#include <admat/quat.hpp>
+#include <admat/rebase.hpp>
 #include <glm/ext.hpp>
 #include <glm/glm.hpp>
 #include <nanobench.h>
+#include <cmath>
 #include <random>
+#include <string>
+#include <vector>
 
 using namespace admat;
 using namespace ankerl;
 
 auto random_mat4() -> mat4 {
-    auto dev  = std::random_device{};
-    auto gen  = std::mt19937(dev());
+    auto& gen = harness::generator();
     auto dist = std::uniform_real_distribution{0.0f, 5.0f};
 
     return mat4{
@@ -24,8 +36,7 @@ auto random_mat4() -> mat4 {
 }
 
 auto random_glm() -> glm::mat4 {
-    auto dev  = std::random_device{};
-    auto gen  = std::mt19937(dev());
+    auto& gen = harness::generator();
     auto dist = std::uniform_real_distribution{0.0f, 100.0f};
     return {
         {dist(gen), dist(gen), dist(gen), dist(gen)},
@@ -41,6 +52,21 @@ auto inverse() {
 
     auto bench = nanobench::Bench().title("inverse").relative(true);
     bench.run("admat inverse", [&] { nanobench::doNotOptimizeAway(inverse(m1)); });
+    bench.run("admat inverse_and_determinant", [&] { nanobench::doNotOptimizeAway(inverse_and_determinant(m1)); });
+    bench.run("glm inverse", [&] { nanobench::doNotOptimizeAway(glm::inverse(m2)); });
+}
+
+auto rigid_inverse() {
+    auto m1 = translation(1.0f, -2.0f, 3.0f) * rotation({0.3f, 1.0f, -0.5f}, 0.7f);
+    auto m2 = glm::translate(glm::mat4{1.0f}, {1.0f, -2.0f, 3.0f}) *
+              glm::rotate(glm::mat4{1.0f}, 0.7f, {0.3f, 1.0f, -0.5f});
+
+    auto bench = nanobench::Bench().title("rigid inverse").relative(true);
+    bench.run("admat inverse", [&] { nanobench::doNotOptimizeAway(inverse(m1)); });
+    bench.run("admat rigid_inverse", [&] { nanobench::doNotOptimizeAway(rigid_inverse(m1)); });
+    bench.run("admat look_at_inverse", [&] {
+        nanobench::doNotOptimizeAway(look_at_inverse({4.0f, -2.0f, 7.0f}, {-1.0f, 3.0f, 0.5f}, {0.0f, 1.0f, 0.0f}));
+    });
     bench.run("glm inverse", [&] { nanobench::doNotOptimizeAway(glm::inverse(m2)); });
 }
 
@@ -62,6 +88,230 @@ auto multiplication() {
     bench.run("glm multiplication", [&] { nanobench::doNotOptimizeAway(m2 * m2); });
 }
 
+auto affine_transform() {
+    auto m1 = translation(1.0f, -2.0f, 3.0f) * rotation({0.3f, 1.0f, -0.5f}, 0.7f) * scaling(2.0f, 0.5f, 1.5f);
+    auto m2 = translation(-4.0f, 0.5f, 2.0f) * rotation({1.0f, 0.0f, 0.2f}, -1.1f);
+    auto a1 = affine::from_mat4(m1);
+    auto a2 = affine::from_mat4(m2);
+
+    auto bench = nanobench::Bench().title("affine").relative(true);
+    bench.run("admat mat4 multiplication", [&] { nanobench::doNotOptimizeAway(m1 * m2); });
+    bench.run("admat affine multiplication", [&] { nanobench::doNotOptimizeAway(a1 * a2); });
+    bench.run("admat mat4 inverse", [&] { nanobench::doNotOptimizeAway(inverse(m1)); });
+    bench.run("admat affine inverse", [&] { nanobench::doNotOptimizeAway(inverse(a1)); });
+}
+
+auto vector_multiplication() {
+    auto m1 = random_mat4();
+    auto m2 = random_glm();
+    auto v1 = vec4{1.0f, 2.0f, 3.0f, 1.0f};
+    auto v2 = glm::vec4{1.0f, 2.0f, 3.0f, 1.0f};
+
+    auto bench = nanobench::Bench().title("mat4 * vec4").relative(true);
+    bench.run("admat mat4 * vec4", [&] { nanobench::doNotOptimizeAway(m1 * v1); });
+    bench.run("glm mat4 * vec4", [&] { nanobench::doNotOptimizeAway(m2 * v2); });
+}
+
+auto batch_transform() {
+    auto m1 = random_mat4();
+    auto m2 = random_glm();
+
+    auto points     = std::vector<vec3>(100'000, vec3{1.0f, 2.0f, 3.0f});
+    auto glm_points = std::vector<glm::vec3>(100'000, glm::vec3{1.0f, 2.0f, 3.0f});
+    auto result     = std::vector<vec3>(points.size());
+    auto glm_result = std::vector<glm::vec3>(points.size());
+
+    auto bench = nanobench::Bench().title("transform 100k points").relative(true).batch(points.size());
+    bench.run("admat mat4 * vec4 loop", [&] {
+        for(std::size_t i = 0; i < points.size(); ++i) {
+            auto out  = m1 * vec4{points[i].x, points[i].y, points[i].z, 1.0f};
+            result[i] = vec3{out.w, out.x, out.y};
+        }
+        nanobench::doNotOptimizeAway(result.data());
+    });
+    bench.run("admat transform_points", [&] {
+        transform_points(m1, points, result);
+        nanobench::doNotOptimizeAway(result.data());
+    });
+#if defined(ADMAT_KERNELS)
+    bench.run("admat dispatch::transform_points", [&] {
+        dispatch::transform_points(m1, points, result);
+        nanobench::doNotOptimizeAway(result.data());
+    });
+#endif
+    bench.run("glm loop", [&] {
+        for(std::size_t i = 0; i < glm_points.size(); ++i) {
+            glm_result[i] = glm::vec3(m2 * glm::vec4(glm_points[i], 1.0f));
+        }
+        nanobench::doNotOptimizeAway(glm_result.data());
+    });
+}
+
+auto hierarchy_update() {
+    constexpr std::size_t count = 100'000;
+
+    // Random tree where every parent precedes its children
+    auto gen     = std::mt19937(harness::seed);
+    auto parents = std::vector<hierarchy::node>(count, hierarchy::no_parent);
+    auto locals  = std::vector<mat4>(count);
+    for(std::size_t i = 0; i < count; ++i) {
+        if(i >= 16) {
+            parents[i] = static_cast<hierarchy::node>(std::uniform_int_distribution<std::size_t>{0, i - 1}(gen));
+        }
+        locals[i] = translation(1.0f, 0.0f, 0.0f) * rotation({0.0f, 1.0f, 0.0f}, 0.01f * static_cast<float>(i));
+    }
+
+    auto worlds = std::vector<mat4>(count);
+    auto tree   = hierarchy(parents, locals);
+
+    auto bench = nanobench::Bench().title("hierarchy update").relative(true).minEpochIterations(10);
+    bench.run("parent index loop", [&] {
+        for(std::size_t i = 0; i < count; ++i) {
+            worlds[i] = parents[i] == hierarchy::no_parent ? locals[i] : worlds[parents[i]] * locals[i];
+        }
+        nanobench::doNotOptimizeAway(worlds.data());
+    });
+    bench.run("admat hierarchy full", [&] {
+        for(hierarchy::node id = 0; id < 16; ++id) {
+            tree.set_local(id, locals[id]);
+        }
+        tree.update();
+        nanobench::doNotOptimizeAway(tree.world(0));
+    });
+    bench.run("admat hierarchy 1% dirty", [&] {
+        for(hierarchy::node id = 0; id < count; id += 100) {
+            tree.set_local(id, locals[id]);
+        }
+        tree.update();
+        nanobench::doNotOptimizeAway(tree.world(0));
+    });
+}
+
+auto bounds_transform() {
+    constexpr std::size_t count = 100'000;
+
+    auto gen    = std::mt19937(harness::seed);
+    auto coords = std::uniform_real_distribution{-100.0f, 100.0f};
+    auto size   = std::uniform_real_distribution{0.1f, 4.0f};
+
+    auto boxes = aabb_soa(count);
+    auto mats  = std::vector<mat4>(count);
+    for(std::size_t i = 0; i < count; ++i) {
+        auto mid = vec3{coords(gen), coords(gen), coords(gen)};
+        boxes.set(i, aabb::from_center_extent(mid, {size(gen), size(gen), size(gen)}));
+        mats[i] = translation(mid) * rotation({0.3f, 1.0f, -0.5f}, 0.01f * static_cast<float>(i));
+    }
+    auto moved = aabb_soa(count);
+
+    auto bench = nanobench::Bench().title("aabb transform 100k").relative(true).minEpochIterations(10);
+    bench.run("8 corners through operator*", [&] {
+        for(std::size_t i = 0; i < count; ++i) {
+            auto box    = boxes[i];
+            auto result = aabb::empty();
+            for(std::size_t corner = 0; corner < 8; ++corner) {
+                auto point = mats[i] * vec4{(corner & 1) != 0 ? box.max.x : box.min.x,
+                                            (corner & 2) != 0 ? box.max.y : box.min.y,
+                                            (corner & 4) != 0 ? box.max.z : box.min.z,
+                                            1.0f};
+                result     = merge(result, vec3{point.w, point.x, point.y});
+            }
+            moved.set(i, result);
+        }
+        nanobench::doNotOptimizeAway(moved.min.x.data());
+    });
+    bench.run("admat arvo per object matrix", [&] {
+        transform(mats, boxes, moved);
+        nanobench::doNotOptimizeAway(moved.min.x.data());
+    });
+    bench.run("admat arvo shared matrix", [&] {
+        transform(mats[0], boxes, moved);
+        nanobench::doNotOptimizeAway(moved.min.x.data());
+    });
+}
+
+auto frustum_cull() {
+    constexpr std::size_t count = 200'000;
+
+    auto gen      = std::mt19937(harness::seed);
+    auto position = std::uniform_real_distribution{-200.0f, 200.0f};
+    auto size     = std::uniform_real_distribution{0.1f, 4.0f};
+
+    auto centers = vec3_soa(count);
+    auto radii   = std::vector<float>(count);
+    for(std::size_t i = 0; i < count; ++i) {
+        centers.set(i, {position(gen), position(gen), position(gen)});
+        radii[i] = size(gen);
+    }
+
+    auto view = frustum::from_mat4(perspective(0.9f, 16.0f / 9.0f, 0.1f, 150.0f) *
+                                   look_at({0.0f, 0.0f, 0.0f}, {1.0f, 0.2f, -1.0f}, {0.0f, 1.0f, 0.0f}));
+    auto bits = std::vector<std::uint64_t>((count + 63) / 64);
+
+    auto bench = nanobench::Bench().title("frustum cull 200k spheres").relative(true).minEpochIterations(10);
+    bench.run("scalar visible loop", [&] {
+        std::fill(bits.begin(), bits.end(), std::uint64_t{0});
+        for(std::size_t i = 0; i < count; ++i) {
+            bits[i / 64] |= std::uint64_t{visible(view, centers[i], radii[i])} << (i % 64);
+        }
+        nanobench::doNotOptimizeAway(bits.data());
+    });
+    bench.run("admat cull_spheres", [&] {
+        cull_spheres(view, centers, radii, bits);
+        nanobench::doNotOptimizeAway(bits.data());
+    });
+}
+
+auto parallel_transform() {
+    constexpr std::size_t count = 4'000'000;
+
+    auto mat    = random_mat4();
+    auto points = std::vector<vec3>(count, vec3{1.0f, 2.0f, 3.0f});
+    auto result = std::vector<vec3>(count);
+
+    // Scaling over pool sizes up to the hardware threads, against the single threaded kernel
+    auto bench = nanobench::Bench().title("transform 4M points threaded").relative(true).batch(count);
+    bench.run("admat transform_points", [&] {
+        transform_points(mat, points, result);
+        nanobench::doNotOptimizeAway(result.data());
+    });
+
+    auto hardware = std::max(std::thread::hardware_concurrency(), 1u);
+    for(std::size_t threads = 1; threads <= hardware; threads *= 2) {
+        auto pool = thread_pool(threads - 1);
+        bench.run("admat thread_pool " + std::to_string(threads) + " threads", [&] {
+            transform_points(pool, mat, points, result);
+            nanobench::doNotOptimizeAway(result.data());
+        });
+    }
+}
+
+auto camera_rebase() {
+    constexpr std::size_t count = 500'000;
+
+    auto origin    = dvec3{6378100.125, -2500010.5, 1234560.75};
+    auto positions = std::vector<dvec3>{};
+    for(std::size_t i = 0; i < count; ++i) {
+        auto f = static_cast<double>(i);
+        positions.push_back(dvec3{6378137.0 + f * 0.731, -2500000.25 - f * 0.117, 1234567.5 + f * 0.003});
+    }
+    auto result = std::vector<vec3>(count);
+
+    // The hand written loop rebase replaces, one conversion per component
+    auto bench = nanobench::Bench().title("rebase 500k positions").relative(true).batch(count);
+    bench.run("scalar loop", [&] {
+        for(std::size_t i = 0; i < count; ++i) {
+            result[i] = vec3{static_cast<float>(positions[i].x - origin.x),
+                             static_cast<float>(positions[i].y - origin.y),
+                             static_cast<float>(positions[i].z - origin.z)};
+        }
+        nanobench::doNotOptimizeAway(result.data());
+    });
+    bench.run("admat rebase", [&] {
+        rebase(origin, positions, result);
+        nanobench::doNotOptimizeAway(result.data());
+    });
+}
+
 auto determinant() {
     auto m1 = random_mat4();
     auto m2 = random_glm();
@@ -89,6 +339,70 @@ auto rotation() {
     bench.run("glm rotate", [&] { nanobench::doNotOptimizeAway(glm::rotate(m2, 1.3f, {1.0f, 0.0f, 0.0f})); });
 }
 
+auto batch_rotations() {
+    constexpr std::size_t count = 100'000;
+
+    auto axes       = std::vector<vec3>{};
+    auto glm_axes   = std::vector<glm::vec3>{};
+    auto angles     = std::vector<float>{};
+    auto euler      = std::vector<vec3>{};
+    auto result     = std::vector<mat4>(count);
+    auto glm_result = std::vector<glm::mat4>(count);
+    for(std::size_t i = 0; i < count; ++i) {
+        auto f = static_cast<float>(i);
+        axes.push_back(normalize(vec3{std::sin(f), std::cos(f * 0.7f), 0.5f}));
+        glm_axes.push_back(glm::vec3{axes.back().x, axes.back().y, axes.back().z});
+        angles.push_back(f * 0.001f - 50.0f);
+        euler.push_back(vec3{f * 0.0003f, -f * 0.0002f, f * 0.0001f});
+    }
+
+    auto bench = nanobench::Bench().title("100k rotation matrices").relative(true).batch(count);
+    bench.run("admat rotation() loop", [&] {
+        for(std::size_t i = 0; i < count; ++i) {
+            result[i] = rotation(axes[i], angles[i]);
+        }
+        nanobench::doNotOptimizeAway(result.data());
+    });
+    bench.run("admat rotations", [&] {
+        rotations(axes, angles, result);
+        nanobench::doNotOptimizeAway(result.data());
+    });
+#if defined(ADMAT_KERNELS)
+    bench.run("admat dispatch::rotations", [&] {
+        dispatch::rotations(axes, angles, result);
+        nanobench::doNotOptimizeAway(result.data());
+    });
+#endif
+    bench.run("admat euler_rotations", [&] {
+        euler_rotations(euler, result);
+        nanobench::doNotOptimizeAway(result.data());
+    });
+    bench.run("glm rotate loop", [&] {
+        for(std::size_t i = 0; i < count; ++i) {
+            glm_result[i] = glm::rotate(glm::mat4{1.0f}, angles[i], glm_axes[i]);
+        }
+        nanobench::doNotOptimizeAway(glm_result.data());
+    });
+}
+
+auto quaternion_rotation() {
+    auto q1 = quat::from_axis_angle({1.0f, 0.0f, 0.0f}, 1.3f);
+    auto q2 = quat::from_axis_angle({0.0f, 1.0f, 0.0f}, 0.4f);
+    auto m1 = rotation({1.0f, 0.0f, 0.0f}, 1.3f);
+    auto m2 = rotation({0.0f, 1.0f, 0.0f}, 0.4f);
+    auto g1 = glm::angleAxis(1.3f, glm::vec3{1.0f, 0.0f, 0.0f});
+    auto g2 = glm::angleAxis(0.4f, glm::vec3{0.0f, 1.0f, 0.0f});
+
+    auto bench = nanobench::Bench().title("quaternion rotation").relative(true);
+    bench.run("admat rotation() * rotation()", [&] { nanobench::doNotOptimizeAway(m1 * m2); });
+    bench.run("admat quat * quat", [&] { nanobench::doNotOptimizeAway(q1 * q2); });
+    bench.run("admat rotation(quat * quat)", [&] { nanobench::doNotOptimizeAway(rotation(q1 * q2)); });
+    bench.run("admat slerp", [&] { nanobench::doNotOptimizeAway(slerp(q1, q2, 0.3f)); });
+    bench.run("admat nlerp", [&] { nanobench::doNotOptimizeAway(nlerp(q1, q2, 0.3f)); });
+    bench.run("glm quat * quat", [&] { nanobench::doNotOptimizeAway(g1 * g2); });
+    bench.run("glm slerp", [&] { nanobench::doNotOptimizeAway(glm::slerp(g1, g2, 0.3f)); });
+}
+
 auto create_perspective() {
     auto bench = nanobench::Bench().title("perspective").relative(true);
     bench.run("admat perspective",
@@ -107,11 +421,22 @@ auto create_orthographic() {
 
 auto main() -> int {
     inverse();
+    rigid_inverse();
     addition();
     multiplication();
+    affine_transform();
+    vector_multiplication();
+    batch_transform();
+    hierarchy_update();
+    bounds_transform();
+    frustum_cull();
+    parallel_transform();
+    camera_rebase();
     determinant();
     transpose();
     rotation();
+    batch_rotations();
+    quaternion_rotation();
     create_perspective();
     create_orthographic();
 
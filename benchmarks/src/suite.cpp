@@ -0,0 +1,299 @@
+// Regression suite: the latency of single operations, and the throughput of the span kernels with inputs sized for each
+// cache level and for memory. Inputs come from harness::generator(), so runs are comparable.
+//
+//     suite_bench --json current.json
+//     cmake -DBASELINE=baseline.json -DCURRENT=current.json -P benchmarks/compare.cmake
+//
+// A baseline is a --json output of a known good build, on the machine the comparison runs on. Committed ones live in
+// benchmarks/baselines/<machine>.json, where the suite_baseline target records them and ctest compares against them,
+// see benchmarks/baselines/README.md.
+
+#include "harness.hpp"
+#include <admat/batch.hpp>
+#include <admat/expr.hpp>
+#include <admat/fast.hpp>
+#include <admat/frustum.hpp>
+#include <admat/half.hpp>
+#include <admat/mat.hpp>
+#include <admat/quat.hpp>
+#include <admat/rebase.hpp>
+#include <admat/soa.hpp>
+#include <admat/vec.hpp>
+#include <nanobench.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <random>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace admat;
+using namespace ankerl;
+
+namespace {
+
+auto random_vec3(float lower, float upper) -> vec3 {
+    auto dist = std::uniform_real_distribution{lower, upper};
+    auto& gen = harness::generator();
+    return vec3{dist(gen), dist(gen), dist(gen)};
+}
+
+// Each op feeds its result into the next, so these time the latency of one call rather than how many overlap. The
+// chains converge or stay on unit vectors and rotations, away from denormals and overflow.
+auto latency(harness::report& report) {
+    auto bench = nanobench::Bench().title("latency").unit("op");
+
+    auto v4     = vec4{0.25f, -1.0f, 2.0f, 0.5f};
+    auto offset = vec4{0.5f, 0.25f, -0.75f, 1.0f};
+    report.run(bench, "vec4 a * s + b", [&] {
+        v4 = v4 * 0.5f + offset;
+        nanobench::doNotOptimizeAway(v4);
+    });
+
+    auto v3   = random_vec3(-1.0f, 1.0f);
+    auto step = random_vec3(-0.1f, 0.1f);
+    report.run(bench, "vec3 normalize", [&] {
+        v3 = normalize(v3 + step);
+        nanobench::doNotOptimizeAway(v3);
+    });
+    report.run(bench, "vec3 fast::normalize", [&] {
+        v3 = fast::normalize(v3 + step);
+        nanobench::doNotOptimizeAway(v3);
+    });
+
+    auto turn = rotation(normalize(random_vec3(-1.0f, 1.0f)), 0.01f);
+    auto mat  = translation(random_vec3(-10.0f, 10.0f)) * turn;
+    report.run(bench, "mat4 * mat4", [&] {
+        mat = mat * turn;
+        nanobench::doNotOptimizeAway(mat);
+    });
+    report.run(bench, "mat4 * vec4", [&] {
+        v4 = turn * v4;
+        nanobench::doNotOptimizeAway(v4);
+    });
+    report.run(bench, "mat4 inverse", [&] {
+        mat = inverse(mat);
+        nanobench::doNotOptimizeAway(mat);
+    });
+
+    auto q     = quat::from_axis_angle(normalize(random_vec3(-1.0f, 1.0f)), 0.3f);
+    auto q_rot = quat::from_axis_angle(normalize(random_vec3(-1.0f, 1.0f)), 0.01f);
+    report.run(bench, "quat * quat", [&] {
+        q = q * q_rot;
+        nanobench::doNotOptimizeAway(q);
+    });
+
+    auto angle = 0.5f;
+    report.run(bench, "fast::sincos", [&] {
+        angle = fast::sincos(angle).cos;
+        nanobench::doNotOptimizeAway(angle);
+    });
+}
+
+// Runs kernel once per working set. setup(count) sizes and fills its buffers first, count being the elements that fit
+// when each takes element_bytes of inputs and outputs together.
+template<typename Setup, typename Kernel>
+auto throughput(harness::report& report,
+                const std::vector<harness::working_set>& sets,
+                const std::string& title,
+                std::size_t element_bytes,
+                Setup&& setup,
+                Kernel&& kernel) {
+    auto bench = nanobench::Bench().title(title).unit("element");
+    for(const auto& set : sets) {
+        auto count = std::max<std::size_t>(set.bytes / element_bytes / 64 * 64, 64);
+        setup(count);
+        bench.batch(count);
+        report.run(bench, set.name, kernel);
+    }
+}
+
+auto span_kernels(harness::report& report, const std::vector<harness::working_set>& sets) {
+    auto mat     = translation(random_vec3(-10.0f, 10.0f)) * rotation(normalize(random_vec3(-1.0f, 1.0f)), 0.7f);
+    auto points  = std::vector<vec3>{};
+    auto vec3s   = std::vector<vec3>{};
+    auto a       = std::vector<vec4>{};
+    auto b       = std::vector<vec4>{};
+    auto vec4s   = std::vector<vec4>{};
+    auto halves  = std::vector<half4>{};
+    auto angles  = std::vector<float>{};
+    auto sines   = std::vector<float>{};
+    auto cosines = std::vector<float>{};
+    auto origins = std::vector<dvec3>{};
+    auto soa     = vec3_soa{};
+    auto normed  = vec3_soa{};
+    auto spheres = sphere_soa{};
+    auto bits    = std::vector<std::uint64_t>{};
+
+    // The memory working sets are large, so each kernel gives its buffers back before the next one fills its own
+    auto release = [&] {
+        points  = {};
+        vec3s   = {};
+        a       = {};
+        b       = {};
+        vec4s   = {};
+        halves  = {};
+        angles  = {};
+        sines   = {};
+        cosines = {};
+        origins = {};
+        soa     = {};
+        normed  = {};
+        spheres = {};
+        bits    = {};
+    };
+
+    auto fill_points = [&](std::size_t count) {
+        points.clear();
+        for(std::size_t i = 0; i < count; ++i) {
+            points.push_back(random_vec3(-100.0f, 100.0f));
+        }
+        vec3s.resize(count);
+    };
+
+    throughput(report, sets, "transform_points", 2 * sizeof(vec3), fill_points, [&] {
+        transform_points(mat, points, vec3s);
+        nanobench::doNotOptimizeAway(vec3s.data());
+    });
+
+    release();
+
+    throughput(
+        report,
+        sets,
+        "vec3_soa normalize",
+        2 * sizeof(vec3),
+        [&](std::size_t count) {
+            fill_points(count);
+            soa    = vec3_soa::from_aos(points);
+            normed = vec3_soa(count);
+        },
+        [&] {
+            normalize(soa, normed);
+            nanobench::doNotOptimizeAway(normed.x.data());
+        });
+
+    release();
+
+    throughput(
+        report,
+        sets,
+        "fast::sincos",
+        3 * sizeof(float),
+        [&](std::size_t count) {
+            auto dist = std::uniform_real_distribution{-100.0f, 100.0f};
+            angles.clear();
+            for(std::size_t i = 0; i < count; ++i) {
+                angles.push_back(dist(harness::generator()));
+            }
+            sines.resize(count);
+            cosines.resize(count);
+        },
+        [&] {
+            fast::sincos(angles, sines, cosines);
+            nanobench::doNotOptimizeAway(sines.data());
+        });
+
+    release();
+
+    auto fill_vec4s = [&](std::size_t count) {
+        auto dist = std::uniform_real_distribution{-500.0f, 500.0f};
+        auto& gen = harness::generator();
+        a.clear();
+        b.clear();
+        for(std::size_t i = 0; i < count; ++i) {
+            a.push_back(vec4{dist(gen), dist(gen), dist(gen), dist(gen)});
+            b.push_back(vec4{dist(gen), dist(gen), dist(gen), dist(gen)});
+        }
+        vec4s.resize(count);
+        halves.resize(count);
+    };
+
+    throughput(report, sets, "to_half", sizeof(vec4) + sizeof(half4), fill_vec4s, [&] {
+        to_half(a, halves);
+        nanobench::doNotOptimizeAway(halves.data());
+    });
+
+    release();
+
+    throughput(report, sets, "lazy a * s + b", 3 * sizeof(vec4), fill_vec4s, [&] {
+        lazy(vec4s) = lazy(a) * 0.5f + lazy(b);
+        nanobench::doNotOptimizeAway(vec4s.data());
+    });
+
+    release();
+
+    throughput(
+        report,
+        sets,
+        "rebase",
+        sizeof(dvec3) + sizeof(vec3),
+        [&](std::size_t count) {
+            auto dist = std::uniform_real_distribution{-1000.0, 1000.0};
+            auto& gen = harness::generator();
+            origins.clear();
+            for(std::size_t i = 0; i < count; ++i) {
+                origins.push_back(dvec3{6378137.0 + dist(gen), dist(gen), dist(gen)});
+            }
+            vec3s.resize(count);
+        },
+        [&] {
+            rebase(dvec3{6378100.0, 3.0, -7.5}, origins, vec3s);
+            nanobench::doNotOptimizeAway(vec3s.data());
+        });
+
+    release();
+
+    auto view = frustum::from_mat4(perspective(0.9f, 16.0f / 9.0f, 0.1f, 150.0f) *
+                                   look_at({0.0f, 0.0f, 0.0f}, {1.0f, 0.2f, -1.0f}, {0.0f, 1.0f, 0.0f}));
+
+    throughput(
+        report,
+        sets,
+        "cull spheres",
+        sizeof(sphere),
+        [&](std::size_t count) {
+            auto radius = std::uniform_real_distribution{0.1f, 4.0f};
+            spheres     = sphere_soa{};
+            for(std::size_t i = 0; i < count; ++i) {
+                spheres.push_back(sphere{random_vec3(-200.0f, 200.0f), radius(harness::generator())});
+            }
+            bits.resize((count + 63) / 64);
+        },
+        [&] {
+            cull(view, spheres, bits);
+            nanobench::doNotOptimizeAway(bits.data());
+        });
+}
+
+} // namespace
+
+auto main(int argc, char** argv) -> int {
+    auto json = std::string{};
+    auto args = std::span(argv, static_cast<std::size_t>(argc));
+    for(std::size_t i = 1; i + 1 < args.size(); ++i) {
+        if(std::string_view{args[i]} == "--json") {
+            json = args[i + 1];
+        }
+    }
+
+    auto sets   = harness::working_sets();
+    auto report = harness::report{};
+    latency(report);
+    span_kernels(report, sets);
+
+    if(!json.empty()) {
+        auto out = std::ofstream(json);
+        report.write(out, sets);
+        if(!out) {
+            std::fprintf(stderr, "could not write %s\n", json.c_str());
+            return 1;
+        }
+    }
+    return 0;
+}
@@ -1,23 +1,27 @@
+#include "harness.hpp"
+#include <admat/expr.hpp>
+#include <admat/fast.hpp>
+#include <admat/half.hpp>
+#include <admat/soa.hpp>
 #include <admat/vec.hpp>
 #include <glm/ext.hpp>
 #include <glm/glm.hpp>
 #include <nanobench.h>
 #include <random>
+#include <vector>
 
 using namespace admat;
 using namespace ankerl;
 
 auto random_vec4() -> vec4 {
-    auto dev  = std::random_device{};
-    auto gen  = std::mt19937(dev());
+    auto& gen = harness::generator();
     auto dist = std::uniform_real_distribution{0.0f, 500.0f};
 
     return vec4{dist(gen), dist(gen), dist(gen), dist(gen)};
 }
 
 auto random_glm() -> glm::vec4 {
-    auto dev  = std::random_device{};
-    auto gen  = std::mt19937(dev());
+    auto& gen = harness::generator();
     auto dist = std::uniform_real_distribution{0.0f, 100.0f};
     return {dist(gen), dist(gen), dist(gen), dist(gen)};
 }
@@ -31,21 +35,150 @@ auto vec4_ops() {
     auto bench_add = nanobench::Bench().title("addition").relative(true);
     bench_add.run("admat addition", [&] { nanobench::doNotOptimizeAway(av1 + av2); });
     bench_add.run("glm addition", [&] { nanobench::doNotOptimizeAway(gv1 + gv2); });
-    
-    auto bench_sub = nanobench::Bench().title("addition").relative(true);
+
+    auto bench_sub = nanobench::Bench().title("subtraction").relative(true);
     bench_sub.run("admat subtraction", [&] { nanobench::doNotOptimizeAway(av1 - av2); });
     bench_sub.run("glm subtraction", [&] { nanobench::doNotOptimizeAway(gv1 - gv2); });
-    
-    auto bench_mul = nanobench::Bench().title("addition").relative(true);
+
+    auto bench_mul = nanobench::Bench().title("multiplication").relative(true);
     bench_mul.run("admat multiplication", [&] { nanobench::doNotOptimizeAway(av1 * av2); });
     bench_mul.run("glm multiplication", [&] { nanobench::doNotOptimizeAway(gv1 * gv2); });
-    
-    auto bench_div = nanobench::Bench().title("addition").relative(true);
+
+    auto bench_div = nanobench::Bench().title("division").relative(true);
     bench_div.run("admat division", [&] { nanobench::doNotOptimizeAway(av1 / av2); });
     bench_div.run("glm division", [&] { nanobench::doNotOptimizeAway(gv1 / gv2); });
 }
 
+auto batch_normalize() {
+    auto aos    = std::vector<vec3>(100'000, vec3{1.0f, 2.0f, 3.0f});
+    auto result = std::vector<vec3>(aos.size());
+    auto soa    = vec3_soa::from_aos(aos);
+    auto normed = vec3_soa(aos.size());
+
+    auto bench = nanobench::Bench().title("normalize 100k vec3").relative(true).batch(aos.size());
+    bench.run("admat aos normalize loop", [&] {
+        for(std::size_t i = 0; i < aos.size(); ++i) {
+            result[i] = normalize(aos[i]);
+        }
+        nanobench::doNotOptimizeAway(result.data());
+    });
+    bench.run("admat soa normalize", [&] {
+        normalize(soa, normed);
+        nanobench::doNotOptimizeAway(normed.x.data());
+    });
+}
+
+auto array_expression() {
+    constexpr std::size_t count = 1'000'000;
+
+    auto a   = std::vector<vec4>(count, random_vec4());
+    auto b   = std::vector<vec4>(count, random_vec4());
+    auto tmp = std::vector<vec4>(count);
+    auto out = std::vector<vec4>(count);
+    auto s   = 0.5f;
+
+    // 16 MB per array, well past the last level cache, so each pass is bound by memory
+    auto bench = nanobench::Bench().title("out = a * s + b, 1M vec4").relative(true).batch(count);
+    bench.run("operator pass per step", [&] {
+        for(std::size_t i = 0; i < count; ++i) {
+            tmp[i] = a[i] * s;
+        }
+        for(std::size_t i = 0; i < count; ++i) {
+            out[i] = tmp[i] + b[i];
+        }
+        nanobench::doNotOptimizeAway(out.data());
+    });
+    bench.run("operator loop", [&] {
+        for(std::size_t i = 0; i < count; ++i) {
+            out[i] = a[i] * s + b[i];
+        }
+        nanobench::doNotOptimizeAway(out.data());
+    });
+    bench.run("admat lazy", [&] {
+        lazy(out) = lazy(a) * s + lazy(b);
+        nanobench::doNotOptimizeAway(out.data());
+    });
+}
+
+auto half_conversion() {
+    constexpr std::size_t count = 4'000'000;
+
+    auto vecs   = std::vector<vec4>(count, random_vec4());
+    auto halves = std::vector<half4>(count);
+    auto back   = std::vector<vec4>(count);
+
+    // Throughput in bytes read plus written, so the results read as GB/s
+    auto bytes = count * (sizeof(vec4) + sizeof(half4));
+    auto bench = nanobench::Bench().title("half conversion 4M vec4").unit("byte").batch(bytes);
+    bench.run("scalar to_half", [&] {
+        for(std::size_t i = 0; i < count; ++i) {
+            halves[i] = to_half(vecs[i]);
+        }
+        nanobench::doNotOptimizeAway(halves.data());
+    });
+    bench.run("admat to_half", [&] {
+        to_half(vecs, halves);
+        nanobench::doNotOptimizeAway(halves.data());
+    });
+    bench.run("scalar to_float", [&] {
+        for(std::size_t i = 0; i < count; ++i) {
+            back[i] = to_float(halves[i]);
+        }
+        nanobench::doNotOptimizeAway(back.data());
+    });
+    bench.run("admat to_float", [&] {
+        to_float(halves, back);
+        nanobench::doNotOptimizeAway(back.data());
+    });
+}
+
+auto fast_math() {
+    constexpr std::size_t count = 100'000;
+
+    auto vecs   = std::vector<vec3>{};
+    auto angles = std::vector<float>{};
+    for(std::size_t i = 0; i < count; ++i) {
+        auto v = random_vec4();
+        vecs.push_back(vec3{v.w, v.x - 250.0f, v.y});
+        angles.push_back(v.z * 0.01f - 2.5f);
+    }
+    auto units = std::vector<vec3>(count);
+    auto sines = std::vector<fast::sin_cos>(count);
+
+    auto bench_normalize = nanobench::Bench().title("fast normalize 100k vec3").relative(true).batch(count);
+    bench_normalize.run("admat normalize", [&] {
+        for(std::size_t i = 0; i < count; ++i) {
+            units[i] = normalize(vecs[i]);
+        }
+        nanobench::doNotOptimizeAway(units.data());
+    });
+    bench_normalize.run("admat fast::normalize", [&] {
+        for(std::size_t i = 0; i < count; ++i) {
+            units[i] = fast::normalize(vecs[i]);
+        }
+        nanobench::doNotOptimizeAway(units.data());
+    });
+
+    auto bench_sincos = nanobench::Bench().title("sin and cos of 100k angles").relative(true).batch(count);
+    bench_sincos.run("std::sin, std::cos", [&] {
+        for(std::size_t i = 0; i < count; ++i) {
+            sines[i] = fast::sin_cos{std::sin(angles[i]), std::cos(angles[i])};
+        }
+        nanobench::doNotOptimizeAway(sines.data());
+    });
+    bench_sincos.run("admat fast::sincos", [&] {
+        for(std::size_t i = 0; i < count; ++i) {
+            sines[i] = fast::sincos(angles[i]);
+        }
+        nanobench::doNotOptimizeAway(sines.data());
+    });
+}
+
 auto main() -> int {
     vec4_ops();
+    batch_normalize();
+    array_expression();
+    half_conversion();
+    fast_math();
     return 0;
 }
\ No newline at end of file
@@ -1 +0,0 @@
-include("${CMAKE_CURRENT_LIST_DIR}/admatTargets.cmake")
\ No newline at end of file
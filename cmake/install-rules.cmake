@@ -10,14 +10,27 @@ include(GNUInstallDirs)
 include(CMakePackageConfigHelpers)
 
 # Set up export components
+set(admat_targets admat_admat)
+set(admat_module_args "")
+set(admat_export_args "")
+if(TARGET admat_kernels)
+    list(APPEND admat_targets admat_kernels)
+endif()
+if(TARGET admat_module)
+    list(APPEND admat_targets admat_module)
+    set(admat_module_args FILE_SET admat_modules DESTINATION "${CMAKE_INSTALL_INCLUDEDIR}/admat")
+    set(admat_export_args CXX_MODULES_DIRECTORY modules)
+endif()
+
 install(
-    TARGETS admat_admat
+    TARGETS ${admat_targets}
     EXPORT admatTargets
     RUNTIME COMPONENT admat_Runtime
     LIBRARY COMPONENT admat_Runtime
     NAMELINK_COMPONENT admat_Development
     ARCHIVE COMPONENT admat_Development
     FILE_SET admat_headers
+    ${admat_module_args}
 )
 
 # Write package file for installations
@@ -36,10 +49,11 @@ mark_as_advanced(admat_INSTALL_CMAKEDIR)
 
 # Install config file to the install directory
 # Config file is used by find_package() (I assume)
+# It is configured so it only looks for the dependencies this build links
+configure_file(cmake/install-config.cmake.in "${package}Config.cmake" @ONLY)
 install(
-    FILES cmake/install-config.cmake
+    FILES "${PROJECT_BINARY_DIR}/${package}Config.cmake"
     DESTINATION "${admat_INSTALL_CMAKEDIR}"
-    RENAME "${package}Config.cmake"
     COMPONENT admat_Development
 )
 
@@ -57,6 +71,7 @@ install(
     NAMESPACE admat::
     DESTINATION "${admat_INSTALL_CMAKEDIR}"
     COMPONENT admat_Development
+    ${admat_export_args}
 )
 
 # Include CPack
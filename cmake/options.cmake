@@ -1 +1,4 @@
-option(ADMAT_BUILD_BENCH "Build benchmarks for admat" OFF)
\ No newline at end of file
+option(ADMAT_BUILD_BENCH "Build benchmarks for admat" OFF)
+option(ADMAT_BUILD_KERNELS "Build admat::kernels, the admat::dispatch kernels precompiled once per instruction set tier" OFF)
+option(ADMAT_BUILD_MODULE "Build admat::module, an import admat; C++20 module over the headers. Needs CMake 3.28 and Ninja or Visual Studio" OFF)
+option(ADMAT_THREADS "Build admat::thread_pool on std::thread, otherwise it runs jobs on the caller" ON)
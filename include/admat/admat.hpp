@@ -1,4 +1,21 @@
 #pragma once
 
+#include "admat/affine.hpp"
+#include "admat/batch.hpp"
+#include "admat/bounds.hpp"
+#include "admat/bvh.hpp"
+#include "admat/dispatch.hpp"
+#include "admat/encoding.hpp"
+#include "admat/executor.hpp"
+#include "admat/expr.hpp"
+#include "admat/fast.hpp"
+#include "admat/frustum.hpp"
+#include "admat/half.hpp"
+#include "admat/hierarchy.hpp"
+#include "admat/intersect.hpp"
 #include "admat/mat.hpp"
+#include "admat/parallel.hpp"
+#include "admat/quat.hpp"
+#include "admat/rebase.hpp"
+#include "admat/soa.hpp"
 #include "admat/vec.hpp"
\ No newline at end of file
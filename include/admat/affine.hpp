@@ -0,0 +1,182 @@
+#pragma once
+
+#include "admat/mat.hpp"
+#include "admat/simd.hpp"
+#include "admat/vec.hpp"
+
+#include <cassert>
+#include <type_traits>
+
+namespace admat {
+
+// Upper 3x4 block of a mat4 whose last row is 0 0 0 1, stored as rows. Each row holds the 3x3 part in w, x, y
+// (in vec4 member order) and the translation in z, so one row dotted with {point, 1} is one output coordinate.
+struct affine {
+    vec4 x;
+    vec4 y;
+    vec4 z;
+
+    static consteval auto identity() -> affine {
+        return affine{
+            {1, 0, 0, 0},
+            {0, 1, 0, 0},
+            {0, 0, 1, 0},
+        };
+    }
+
+    // Drops the last row of mat, which is assumed to be 0 0 0 1
+    static constexpr auto from_mat4(const mat4& mat) -> affine {
+        return affine{
+            {mat.w.w, mat.x.w, mat.y.w, mat.z.w},
+            {mat.w.x, mat.x.x, mat.y.x, mat.z.x},
+            {mat.w.y, mat.x.y, mat.y.y, mat.z.y},
+        };
+    }
+};
+
+static_assert(std::is_standard_layout_v<affine> && std::is_trivial_v<affine>, "affine not pod");
+
+constexpr auto to_mat4(const affine& aff) -> mat4 {
+    return mat4{aff.x, aff.y, aff.z, {0, 0, 0, 1}};
+}
+
+namespace simd {
+
+// Cross product of the first three lanes, the last lane is zero
+inline auto cross(const f32x4& lhs, const f32x4& rhs) -> f32x4 {
+    auto lhs_yzx = shuffle<1, 2, 0, 3>(lhs);
+    auto rhs_yzx = shuffle<1, 2, 0, 3>(rhs);
+    return shuffle<1, 2, 0, 3>(sub(mul(lhs, rhs_yzx), mul(lhs_yzx, rhs)));
+}
+
+// One row of lhs * rhs, the implicit last row of rhs contributes only the translation
+inline auto compose(const f32x4& row, const f32x4& r0, const f32x4& r1, const f32x4& r2, const f32x4& unit_w)
+    -> f32x4 {
+    auto result = mul(shuffle<3, 3, 3, 3>(row), unit_w);
+    result      = fmadd(shuffle<2, 2, 2, 2>(row), r2, result);
+    result      = fmadd(shuffle<1, 1, 1, 1>(row), r1, result);
+    return fmadd(shuffle<0, 0, 0, 0>(row), r0, result);
+}
+
+} // namespace simd
+
+// Same result as to_mat4(lhs) * to_mat4(rhs), applies rhs first
+constexpr auto operator*(const affine& lhs, const affine& rhs) -> affine {
+    if(!std::is_constant_evaluated()) {
+        auto r0     = simd::load(rhs.x);
+        auto r1     = simd::load(rhs.y);
+        auto r2     = simd::load(rhs.z);
+        auto unit_w = simd::set(0.0f, 0.0f, 0.0f, 1.0f);
+
+        return affine{
+            simd::store<vec4>(simd::compose(simd::load(lhs.x), r0, r1, r2, unit_w)),
+            simd::store<vec4>(simd::compose(simd::load(lhs.y), r0, r1, r2, unit_w)),
+            simd::store<vec4>(simd::compose(simd::load(lhs.z), r0, r1, r2, unit_w)),
+        };
+    }
+
+    auto compose = [&](const vec4& row) {
+        return row.w * rhs.x + row.x * rhs.y + row.y * rhs.z + vec4{0, 0, 0, row.z};
+    };
+
+    return affine{compose(lhs.x), compose(lhs.y), compose(lhs.z)};
+}
+
+constexpr auto transform_point(const affine& aff, const vec3& point) -> vec3 {
+    return vec3{
+        aff.x.w * point.x + aff.x.x * point.y + aff.x.y * point.z + aff.x.z,
+        aff.y.w * point.x + aff.y.x * point.y + aff.y.y * point.z + aff.y.z,
+        aff.z.w * point.x + aff.z.x * point.y + aff.z.y * point.z + aff.z.z,
+    };
+}
+
+// Ignores translation
+constexpr auto transform_direction(const affine& aff, const vec3& dir) -> vec3 {
+    return vec3{
+        aff.x.w * dir.x + aff.x.x * dir.y + aff.x.y * dir.z,
+        aff.y.w * dir.x + aff.y.x * dir.y + aff.y.y * dir.z,
+        aff.z.w * dir.x + aff.z.x * dir.y + aff.z.y * dir.z,
+    };
+}
+
+// Inverts the 3x3 part from the cross products of its columns and moves the translation through it.
+// The 3x3 part must be invertible.
+constexpr auto inverse(const affine& aff) -> affine {
+    if(!std::is_constant_evaluated()) {
+        auto cols = simd::transpose(simd::f32x4x4{
+            .w = simd::load(aff.x),
+            .x = simd::load(aff.y),
+            .y = simd::load(aff.z),
+            .z = simd::set(0.0f, 0.0f, 0.0f, 1.0f),
+        });
+
+        auto r0  = simd::cross(cols.x, cols.y);
+        auto r1  = simd::cross(cols.y, cols.w);
+        auto r2  = simd::cross(cols.w, cols.x);
+        auto rcp = simd::broadcast(1.0f / simd::dot(cols.w, r0));
+
+        r0 = simd::mul(r0, rcp);
+        r1 = simd::mul(r1, rcp);
+        r2 = simd::mul(r2, rcp);
+
+        // The rows end in a zero lane, which keeps the 1 at the end of cols.z out of the dot products
+        auto unit_w = simd::set(0.0f, 0.0f, 0.0f, 1.0f);
+        return affine{
+            simd::store<vec4>(simd::fmadd(unit_w, simd::broadcast(-simd::dot(r0, cols.z)), r0)),
+            simd::store<vec4>(simd::fmadd(unit_w, simd::broadcast(-simd::dot(r1, cols.z)), r1)),
+            simd::store<vec4>(simd::fmadd(unit_w, simd::broadcast(-simd::dot(r2, cols.z)), r2)),
+        };
+    }
+
+    auto c0 = vec3{aff.x.w, aff.y.w, aff.z.w};
+    auto c1 = vec3{aff.x.x, aff.y.x, aff.z.x};
+    auto c2 = vec3{aff.x.y, aff.y.y, aff.z.y};
+    auto t  = vec3{aff.x.z, aff.y.z, aff.z.z};
+
+    auto r0  = cross(c1, c2);
+    auto rcp = 1.0f / dot(c0, r0);
+    r0       = r0 * rcp;
+    auto r1  = cross(c2, c0) * rcp;
+    auto r2  = cross(c0, c1) * rcp;
+
+    return affine{
+        {r0.x, r0.y, r0.z, -dot(r0, t)},
+        {r1.x, r1.y, r1.z, -dot(r1, t)},
+        {r2.x, r2.y, r2.z, -dot(r2, t)},
+    };
+}
+
+// Inverse when the 3x3 part is orthonormal, a transpose instead of a 3x3 inverse. Checked in debug builds.
+constexpr auto rigid_inverse(const affine& aff) -> affine {
+    assert(is_rigid(to_mat4(aff)));
+
+    if(!std::is_constant_evaluated()) {
+        auto cols = simd::transpose(simd::f32x4x4{
+            .w = simd::load(aff.x),
+            .x = simd::load(aff.y),
+            .y = simd::load(aff.z),
+            .z = simd::broadcast(0.0f),
+        });
+
+        // Columns of the rotation end in a zero lane, cols.z is the translation
+        auto unit_w = simd::set(0.0f, 0.0f, 0.0f, 1.0f);
+        return affine{
+            simd::store<vec4>(simd::fmadd(unit_w, simd::broadcast(-simd::dot(cols.w, cols.z)), cols.w)),
+            simd::store<vec4>(simd::fmadd(unit_w, simd::broadcast(-simd::dot(cols.x, cols.z)), cols.x)),
+            simd::store<vec4>(simd::fmadd(unit_w, simd::broadcast(-simd::dot(cols.y, cols.z)), cols.y)),
+        };
+    }
+
+    auto c0 = vec3{aff.x.w, aff.y.w, aff.z.w};
+    auto c1 = vec3{aff.x.x, aff.y.x, aff.z.x};
+    auto c2 = vec3{aff.x.y, aff.y.y, aff.z.y};
+    auto t  = vec3{aff.x.z, aff.y.z, aff.z.z};
+
+    return affine{
+        {c0.x, c0.y, c0.z, -dot(c0, t)},
+        {c1.x, c1.y, c1.z, -dot(c1, t)},
+        {c2.x, c2.y, c2.z, -dot(c2, t)},
+    };
+}
+
+} // namespace admat
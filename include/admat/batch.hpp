@@ -0,0 +1,401 @@
+#pragma once
+
+#include "admat/executor.hpp"
+#include "admat/fast.hpp"
+#include "admat/mat.hpp"
+#include "admat/simd.hpp"
+#include "admat/vec.hpp"
+
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <span>
+
+namespace admat {
+
+namespace simd {
+
+// linear * in[i] + offset for simd::wide_width vec3 at a time. The block is fully read into registers before it is
+// written back, so out may be the same span as in.
+inline auto transform_vec3(const mat3& linear, const vec3& offset, std::span<const vec3> in, std::span<vec3> out)
+    -> void {
+    auto m00 = wide_broadcast(linear.x.x);
+    auto m01 = wide_broadcast(linear.y.x);
+    auto m02 = wide_broadcast(linear.z.x);
+    auto m03 = wide_broadcast(offset.x);
+    auto m10 = wide_broadcast(linear.x.y);
+    auto m11 = wide_broadcast(linear.y.y);
+    auto m12 = wide_broadcast(linear.z.y);
+    auto m13 = wide_broadcast(offset.y);
+    auto m20 = wide_broadcast(linear.x.z);
+    auto m21 = wide_broadcast(linear.y.z);
+    auto m22 = wide_broadcast(linear.z.z);
+    auto m23 = wide_broadcast(offset.z);
+
+    std::size_t i = 0;
+    for(; i + wide_width <= in.size(); i += wide_width) {
+        alignas(64) std::array<float, wide_width> xs{};
+        alignas(64) std::array<float, wide_width> ys{};
+        alignas(64) std::array<float, wide_width> zs{};
+
+        for(std::size_t lane = 0; lane < wide_width; ++lane) {
+            xs[lane] = in[i + lane].x;
+            ys[lane] = in[i + lane].y;
+            zs[lane] = in[i + lane].z;
+        }
+
+        auto x = wide_load(xs.data());
+        auto y = wide_load(ys.data());
+        auto z = wide_load(zs.data());
+
+        wide_store(xs.data(), fmadd(m00, x, fmadd(m01, y, fmadd(m02, z, m03))));
+        wide_store(ys.data(), fmadd(m10, x, fmadd(m11, y, fmadd(m12, z, m13))));
+        wide_store(zs.data(), fmadd(m20, x, fmadd(m21, y, fmadd(m22, z, m23))));
+
+        for(std::size_t lane = 0; lane < wide_width; ++lane) {
+            out[i + lane] = vec3{xs[lane], ys[lane], zs[lane]};
+        }
+    }
+
+    for(; i < in.size(); ++i) {
+        out[i] = linear * in[i] + offset;
+    }
+}
+
+template<bool translate>
+inline auto transform_vec3(const mat4& mat, std::span<const vec3> in, std::span<vec3> out) -> void {
+    auto offset = translate ? vec3{mat.z.w, mat.z.x, mat.z.y} : vec3{};
+    transform_vec3(linear_part(mat), offset, in, out);
+}
+
+// Transforms simd::wide_width / 4 vec4 per register, one vec4 per 128 bit group
+inline auto transform_vec4(const mat4& mat, std::span<const vec4> in, std::span<vec4> out) -> void {
+    constexpr auto per_register = wide_width / 4;
+
+    if(in.empty()) {
+        return;
+    }
+
+    auto c0 = wide_broadcast(load(mat.w));
+    auto c1 = wide_broadcast(load(mat.x));
+    auto c2 = wide_broadcast(load(mat.y));
+    auto c3 = wide_broadcast(load(mat.z));
+
+    // vec4 is four packed floats, so a span of them is one contiguous float array
+    const auto* src = &in.data()->w;
+    auto* dst       = &out.data()->w;
+
+    std::size_t i = 0;
+    for(; i + per_register <= in.size(); i += per_register) {
+        auto vec    = wide_load(src + i * 4); // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+        auto result = mul(c0, wide_splat<0>(vec));
+        result      = fmadd(c1, wide_splat<1>(vec), result);
+        result      = fmadd(c2, wide_splat<2>(vec), result);
+        result      = fmadd(c3, wide_splat<3>(vec), result);
+        wide_store(dst + i * 4, result); // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    }
+
+    for(; i < in.size(); ++i) {
+        out[i] = mat * in[i];
+    }
+}
+
+// Gathers lane_count(tag) vec3 from the front of in, one register per member
+template<typename Tag>
+inline auto gather_vec3(Tag tag, std::span<const vec3> in) {
+    constexpr auto lanes = lane_count(Tag{});
+
+    alignas(64) std::array<std::array<float, lanes>, 3> members{};
+    for(std::size_t lane = 0; lane < lanes; ++lane) {
+        members[0][lane] = in[lane].x;
+        members[1][lane] = in[lane].y;
+        members[2][lane] = in[lane].z;
+    }
+    return std::array{load_lanes(tag, members[0].data()),
+                      load_lanes(tag, members[1].data()),
+                      load_lanes(tag, members[2].data())};
+}
+
+// Writes lane_count(tag) rotation matrices to the front of out, from their 3x3 entries in row major order, one
+// register per entry
+template<typename Tag, typename Reg>
+inline auto store_rotations(Tag /*tag*/, const std::array<Reg, 9>& entries, std::span<mat4> out) -> void {
+    constexpr auto lanes = lane_count(Tag{});
+
+    alignas(64) std::array<std::array<float, lanes>, 9> values{};
+    for(std::size_t entry = 0; entry < 9; ++entry) {
+        store_lanes(values[entry].data(), entries[entry]);
+    }
+
+    for(std::size_t lane = 0; lane < lanes; ++lane) {
+        out[lane] = mat4::from_cols(vec4{values[0][lane], values[3][lane], values[6][lane], 0.0f},
+                                    vec4{values[1][lane], values[4][lane], values[7][lane], 0.0f},
+                                    vec4{values[2][lane], values[5][lane], values[8][lane], 0.0f},
+                                    vec4{0.0f, 0.0f, 0.0f, 1.0f});
+    }
+}
+
+// The same entries as rotation(), lane by lane
+inline auto rotations(std::span<const vec3> axes, std::span<const float> angles, std::span<mat4> out) -> void {
+    for_each_block(axes.size(), [&](std::size_t i, auto tag) {
+        auto [x, y, z]  = gather_vec3(tag, axes.subspan(i));
+        auto [sin, cos] = sincos(tag, load_lanes(tag, &angles[i]));
+
+        auto length = sqrt(add(mul(x, x), add(mul(y, y), mul(z, z))));
+        x           = div(x, length);
+        y           = div(y, length);
+        z           = div(z, length);
+
+        auto t  = sub(broadcast(tag, 1.0f), cos);
+        auto xt = mul(x, t);
+        auto yt = mul(y, t);
+        auto zt = mul(z, t);
+        auto xs = mul(x, sin);
+        auto ys = mul(y, sin);
+        auto zs = mul(z, sin);
+
+        store_rotations(tag,
+                        std::array{fmadd(x, xt, cos),
+                                   sub(mul(y, xt), zs),
+                                   fmadd(z, xt, ys),
+                                   fmadd(x, yt, zs),
+                                   fmadd(y, yt, cos),
+                                   sub(mul(z, yt), xs),
+                                   sub(mul(x, zt), ys),
+                                   fmadd(y, zt, xs),
+                                   fmadd(z, zt, cos)},
+                        out.subspan(i));
+    });
+}
+
+// The same entries as euler_rotation(), lane by lane
+inline auto euler_rotations(std::span<const vec3> radians, std::span<mat4> out) -> void {
+    for_each_block(radians.size(), [&](std::size_t i, auto tag) {
+        auto [x, y, z] = gather_vec3(tag, radians.subspan(i));
+        auto [sx, cx]  = sincos(tag, x);
+        auto [sy, cy]  = sincos(tag, y);
+        auto [sz, cz]  = sincos(tag, z);
+
+        auto sxsy = mul(sx, sy);
+        auto cxsy = mul(cx, sy);
+
+        store_rotations(tag,
+                        std::array{mul(cy, cz),
+                                   sub(mul(sxsy, cz), mul(cx, sz)),
+                                   fmadd(cxsy, cz, mul(sx, sz)),
+                                   mul(cy, sz),
+                                   fmadd(sxsy, sz, mul(cx, cz)),
+                                   sub(mul(cxsy, sz), mul(sx, cz)),
+                                   sub(broadcast(tag, 0.0f), sy),
+                                   mul(sx, cy),
+                                   mul(cx, cy)},
+                        out.subspan(i));
+    });
+}
+
+// The same entries as yaw_pitch_roll_rotation(), lane by lane, with yaw, pitch and roll in x, y and z
+inline auto yaw_pitch_roll_rotations(std::span<const vec3> angles, std::span<mat4> out) -> void {
+    for_each_block(angles.size(), [&](std::size_t i, auto tag) {
+        auto [yaw, pitch, roll] = gather_vec3(tag, angles.subspan(i));
+        auto [sy, cy]           = sincos(tag, yaw);
+        auto [sp, cp]           = sincos(tag, pitch);
+        auto [sr, cr]           = sincos(tag, roll);
+
+        auto sysp = mul(sy, sp);
+        auto cysp = mul(cy, sp);
+
+        store_rotations(tag,
+                        std::array{fmadd(sysp, sr, mul(cy, cr)),
+                                   sub(mul(sysp, cr), mul(cy, sr)),
+                                   mul(sy, cp),
+                                   mul(cp, sr),
+                                   mul(cp, cr),
+                                   sub(broadcast(tag, 0.0f), sp),
+                                   sub(mul(cysp, sr), mul(sy, cr)),
+                                   fmadd(cysp, cr, mul(sy, sr)),
+                                   mul(cy, cp)},
+                        out.subspan(i));
+    });
+}
+
+} // namespace simd
+
+// Transforms points (implicit w of 1) by mat and drops the resulting w, no perspective divide.
+// out must hold at least in.size() elements and may be the same span as in.
+inline auto transform_points(const mat4& mat, std::span<const vec3> in, std::span<vec3> out) -> void {
+    assert(out.size() >= in.size());
+    simd::transform_vec3<true>(mat, in, out);
+}
+
+// Transforms directions (implicit w of 0) by mat, ignoring translation.
+// out must hold at least in.size() elements and may be the same span as in.
+inline auto transform_directions(const mat4& mat, std::span<const vec3> in, std::span<vec3> out) -> void {
+    assert(out.size() >= in.size());
+    simd::transform_vec3<false>(mat, in, out);
+}
+
+// mat * in[i] for every element. out must hold at least in.size() elements and may be the same span as in.
+inline auto transform(const mat4& mat, std::span<const vec4> in, std::span<vec4> out) -> void {
+    assert(out.size() >= in.size());
+    simd::transform_vec4(mat, in, out);
+}
+
+// linear * in[i] for every element, e.g. normals through normal_matrix without padding them out to a mat4.
+// out must hold at least in.size() elements and may be the same span as in.
+inline auto transform(const mat3& linear, std::span<const vec3> in, std::span<vec3> out) -> void {
+    assert(out.size() >= in.size());
+    simd::transform_vec3(linear, vec3{}, in, out);
+}
+
+// lhs[i] * rhs[i] for every element, e.g. parent world transforms with local ones. out must hold at least lhs.size()
+// elements and may be the same span as either input.
+inline auto multiply(std::span<const mat4> lhs, std::span<const mat4> rhs, std::span<mat4> out) -> void {
+    assert(rhs.size() >= lhs.size() && out.size() >= lhs.size());
+    for(std::size_t i = 0; i < lhs.size(); ++i) {
+        out[i] = lhs[i] * rhs[i];
+    }
+}
+
+// lhs * rhs[i] for every element, e.g. one view projection with many model matrices. out must hold at least
+// rhs.size() elements and may be the same span as rhs.
+inline auto multiply(const mat4& lhs, std::span<const mat4> rhs, std::span<mat4> out) -> void {
+    assert(out.size() >= rhs.size());
+    for(std::size_t i = 0; i < rhs.size(); ++i) {
+        out[i] = lhs * rhs[i];
+    }
+}
+
+// Rotation matrices for many objects at once, simd::wide_width at a time. The sines and cosines come from the span
+// kernel of fast::sincos, so entries can differ from the single matrix functions by a few ulp, and every angle must
+// be at most 8192 in magnitude. out must hold at least as many elements as the inputs.
+
+// rotation(axes[i], angles[i]) for every element
+inline auto rotations(std::span<const vec3> axes, std::span<const float> angles, std::span<mat4> out) -> void {
+    assert(angles.size() >= axes.size() && out.size() >= axes.size());
+    simd::rotations(axes, angles, out);
+}
+
+// euler_rotation(radians[i]) for every element
+inline auto euler_rotations(std::span<const vec3> radians, std::span<mat4> out) -> void {
+    assert(out.size() >= radians.size());
+    simd::euler_rotations(radians, out);
+}
+
+// yaw_pitch_roll_rotation(angles[i].x, angles[i].y, angles[i].z) for every element
+inline auto yaw_pitch_roll_rotations(std::span<const vec3> angles, std::span<mat4> out) -> void {
+    assert(out.size() >= angles.size());
+    simd::yaw_pitch_roll_rotations(angles, out);
+}
+
+// Executor versions of the above, run through exec in chunks of grain elements. Chunks never share an element, so
+// out may still be the same span as in.
+
+template<typename Executor>
+inline auto transform_points(Executor&& exec,
+                             const mat4& mat,
+                             std::span<const vec3> in,
+                             std::span<vec3> out,
+                             std::size_t grain = default_grain) -> void {
+    assert(out.size() >= in.size());
+    parallel_for(exec, in.size(), grain, [&](std::size_t begin, std::size_t end) {
+        simd::transform_vec3<true>(mat, in.subspan(begin, end - begin), out.subspan(begin, end - begin));
+    });
+}
+
+template<typename Executor>
+inline auto transform_directions(Executor&& exec,
+                                 const mat4& mat,
+                                 std::span<const vec3> in,
+                                 std::span<vec3> out,
+                                 std::size_t grain = default_grain) -> void {
+    assert(out.size() >= in.size());
+    parallel_for(exec, in.size(), grain, [&](std::size_t begin, std::size_t end) {
+        simd::transform_vec3<false>(mat, in.subspan(begin, end - begin), out.subspan(begin, end - begin));
+    });
+}
+
+template<typename Executor>
+inline auto transform(Executor&& exec,
+                      const mat4& mat,
+                      std::span<const vec4> in,
+                      std::span<vec4> out,
+                      std::size_t grain = default_grain) -> void {
+    assert(out.size() >= in.size());
+    parallel_for(exec, in.size(), grain, [&](std::size_t begin, std::size_t end) {
+        simd::transform_vec4(mat, in.subspan(begin, end - begin), out.subspan(begin, end - begin));
+    });
+}
+
+template<typename Executor>
+inline auto transform(Executor&& exec,
+                      const mat3& linear,
+                      std::span<const vec3> in,
+                      std::span<vec3> out,
+                      std::size_t grain = default_grain) -> void {
+    assert(out.size() >= in.size());
+    parallel_for(exec, in.size(), grain, [&](std::size_t begin, std::size_t end) {
+        simd::transform_vec3(linear, vec3{}, in.subspan(begin, end - begin), out.subspan(begin, end - begin));
+    });
+}
+
+template<typename Executor>
+inline auto multiply(Executor&& exec,
+                     std::span<const mat4> lhs,
+                     std::span<const mat4> rhs,
+                     std::span<mat4> out,
+                     std::size_t grain = default_grain) -> void {
+    assert(rhs.size() >= lhs.size() && out.size() >= lhs.size());
+    parallel_for(exec, lhs.size(), grain, [&](std::size_t begin, std::size_t end) {
+        multiply(lhs.subspan(begin, end - begin), rhs.subspan(begin, end - begin), out.subspan(begin, end - begin));
+    });
+}
+
+template<typename Executor>
+inline auto multiply(Executor&& exec,
+                     const mat4& lhs,
+                     std::span<const mat4> rhs,
+                     std::span<mat4> out,
+                     std::size_t grain = default_grain) -> void {
+    assert(out.size() >= rhs.size());
+    parallel_for(exec, rhs.size(), grain, [&](std::size_t begin, std::size_t end) {
+        multiply(lhs, rhs.subspan(begin, end - begin), out.subspan(begin, end - begin));
+    });
+}
+
+template<typename Executor>
+inline auto rotations(Executor&& exec,
+                      std::span<const vec3> axes,
+                      std::span<const float> angles,
+                      std::span<mat4> out,
+                      std::size_t grain = default_grain) -> void {
+    assert(angles.size() >= axes.size() && out.size() >= axes.size());
+    parallel_for(exec, axes.size(), grain, [&](std::size_t begin, std::size_t end) {
+        simd::rotations(axes.subspan(begin, end - begin),
+                        angles.subspan(begin, end - begin),
+                        out.subspan(begin, end - begin));
+    });
+}
+
+template<typename Executor>
+inline auto euler_rotations(Executor&& exec,
+                            std::span<const vec3> radians,
+                            std::span<mat4> out,
+                            std::size_t grain = default_grain) -> void {
+    assert(out.size() >= radians.size());
+    parallel_for(exec, radians.size(), grain, [&](std::size_t begin, std::size_t end) {
+        simd::euler_rotations(radians.subspan(begin, end - begin), out.subspan(begin, end - begin));
+    });
+}
+
+template<typename Executor>
+inline auto yaw_pitch_roll_rotations(Executor&& exec,
+                                     std::span<const vec3> angles,
+                                     std::span<mat4> out,
+                                     std::size_t grain = default_grain) -> void {
+    assert(out.size() >= angles.size());
+    parallel_for(exec, angles.size(), grain, [&](std::size_t begin, std::size_t end) {
+        simd::yaw_pitch_roll_rotations(angles.subspan(begin, end - begin), out.subspan(begin, end - begin));
+    });
+}
+
+} // namespace admat
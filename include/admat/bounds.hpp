@@ -0,0 +1,452 @@
+#pragma once
+
+#include "admat/executor.hpp"
+#include "admat/mat.hpp"
+#include "admat/simd.hpp"
+#include "admat/soa.hpp"
+#include "admat/vec.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <type_traits>
+
+namespace admat {
+
+// Axis-aligned box, empty when any component of min is greater than the same component of max
+struct aabb {
+    vec3 min;
+    vec3 max;
+
+    // Merging anything into the empty box yields that thing
+    static consteval auto empty() -> aabb {
+        return aabb{
+            {std::numeric_limits<float>::max(), std::numeric_limits<float>::max(), std::numeric_limits<float>::max()},
+            {std::numeric_limits<float>::lowest(),
+             std::numeric_limits<float>::lowest(),
+             std::numeric_limits<float>::lowest()},
+        };
+    }
+
+    static constexpr auto from_center_extent(const vec3& center, const vec3& extent) -> aabb {
+        return aabb{center - extent, center + extent};
+    }
+};
+
+struct sphere {
+    vec3 center;
+    float radius;
+};
+
+static_assert(std::is_standard_layout_v<aabb> && std::is_trivial_v<aabb>, "aabb not pod");
+static_assert(std::is_standard_layout_v<sphere> && std::is_trivial_v<sphere>, "sphere not pod");
+
+constexpr auto center(const aabb& box) -> vec3 {
+    return (box.min + box.max) * 0.5f;
+}
+
+// Half the size along each axis
+constexpr auto extent(const aabb& box) -> vec3 {
+    return (box.max - box.min) * 0.5f;
+}
+
+constexpr auto merge(const aabb& lhs, const aabb& rhs) -> aabb {
+    return aabb{
+        {std::min(lhs.min.x, rhs.min.x), std::min(lhs.min.y, rhs.min.y), std::min(lhs.min.z, rhs.min.z)},
+        {std::max(lhs.max.x, rhs.max.x), std::max(lhs.max.y, rhs.max.y), std::max(lhs.max.z, rhs.max.z)},
+    };
+}
+
+constexpr auto merge(const aabb& box, const vec3& point) -> aabb {
+    return merge(box, aabb{point, point});
+}
+
+// Points on the boundary are contained
+constexpr auto contains(const aabb& box, const vec3& point) -> bool {
+    return point.x >= box.min.x && point.y >= box.min.y && point.z >= box.min.z && point.x <= box.max.x &&
+           point.y <= box.max.y && point.z <= box.max.z;
+}
+
+constexpr auto contains(const aabb& outer, const aabb& inner) -> bool {
+    return contains(outer, inner.min) && contains(outer, inner.max);
+}
+
+// Touching boxes overlap
+constexpr auto overlaps(const aabb& lhs, const aabb& rhs) -> bool {
+    return lhs.min.x <= rhs.max.x && lhs.min.y <= rhs.max.y && lhs.min.z <= rhs.max.z && rhs.min.x <= lhs.max.x &&
+           rhs.min.y <= lhs.max.y && rhs.min.z <= lhs.max.z;
+}
+
+// Smallest sphere enclosing both
+constexpr auto merge(const sphere& lhs, const sphere& rhs) -> sphere {
+    auto offset = rhs.center - lhs.center;
+    auto dist   = std::sqrt(dot(offset, offset));
+
+    if(dist + rhs.radius <= lhs.radius) {
+        return lhs;
+    }
+    if(dist + lhs.radius <= rhs.radius) {
+        return rhs;
+    }
+
+    auto radius = (dist + lhs.radius + rhs.radius) * 0.5f;
+    return sphere{lhs.center + offset * ((radius - lhs.radius) / dist), radius};
+}
+
+constexpr auto contains(const sphere& bounds, const vec3& point) -> bool {
+    auto offset = point - bounds.center;
+    return dot(offset, offset) <= bounds.radius * bounds.radius;
+}
+
+constexpr auto contains(const sphere& outer, const sphere& inner) -> bool {
+    auto offset = inner.center - outer.center;
+    return inner.radius <= outer.radius &&
+           dot(offset, offset) <= (outer.radius - inner.radius) * (outer.radius - inner.radius);
+}
+
+constexpr auto overlaps(const sphere& lhs, const sphere& rhs) -> bool {
+    auto offset = rhs.center - lhs.center;
+    auto reach  = lhs.radius + rhs.radius;
+    return dot(offset, offset) <= reach * reach;
+}
+
+// Distance from the sphere center to the closest point of the box
+constexpr auto overlaps(const aabb& box, const sphere& bounds) -> bool {
+    auto closest = vec3{
+        std::clamp(bounds.center.x, box.min.x, box.max.x),
+        std::clamp(bounds.center.y, box.min.y, box.max.y),
+        std::clamp(bounds.center.z, box.min.z, box.max.z),
+    };
+    return contains(bounds, closest);
+}
+
+// Arvo's method: the center goes through mat and the extent through the absolute value of its 3x3 part, which gives
+// the same box as transforming all 8 corners. mat is assumed to be affine.
+constexpr auto transform(const mat4& mat, const aabb& box) -> aabb {
+    auto mid  = center(box);
+    auto half = extent(box);
+
+    if(!std::is_constant_evaluated()) {
+        auto c0 = simd::load(mat.w);
+        auto c1 = simd::load(mat.x);
+        auto c2 = simd::load(mat.y);
+        auto c3 = simd::load(mat.z);
+
+        auto new_mid  = simd::transform(c0, c1, c2, c3, vec4{mid.x, mid.y, mid.z, 1.0f});
+        auto new_half = simd::transform(
+            simd::abs(c0), simd::abs(c1), simd::abs(c2), simd::broadcast(0.0f), vec4{half.x, half.y, half.z, 0.0f});
+
+        auto min = simd::store<vec4>(simd::sub(new_mid, new_half));
+        auto max = simd::store<vec4>(simd::add(new_mid, new_half));
+        return aabb{{min.w, min.x, min.y}, {max.w, max.x, max.y}};
+    }
+
+    auto new_mid  = mat * vec4{mid.x, mid.y, mid.z, 1.0f};
+    auto new_half = vec3{
+        std::abs(mat.w.w) * half.x + std::abs(mat.x.w) * half.y + std::abs(mat.y.w) * half.z,
+        std::abs(mat.w.x) * half.x + std::abs(mat.x.x) * half.y + std::abs(mat.y.x) * half.z,
+        std::abs(mat.w.y) * half.x + std::abs(mat.x.y) * half.y + std::abs(mat.y.y) * half.z,
+    };
+    return aabb::from_center_extent({new_mid.w, new_mid.x, new_mid.y}, new_half);
+}
+
+// The radius is scaled by the longest axis of mat, so the result stays enclosing under non-uniform scale
+constexpr auto transform(const mat4& mat, const sphere& bounds) -> sphere {
+    auto new_center = mat * vec4{bounds.center.x, bounds.center.y, bounds.center.z, 1.0f};
+    auto scale      = std::max({
+        mat.w.w * mat.w.w + mat.w.x * mat.w.x + mat.w.y * mat.w.y,
+        mat.x.w * mat.x.w + mat.x.x * mat.x.x + mat.x.y * mat.x.y,
+        mat.y.w * mat.y.w + mat.y.x * mat.y.x + mat.y.y * mat.y.y,
+    });
+    return sphere{{new_center.w, new_center.x, new_center.y}, bounds.radius * std::sqrt(scale)};
+}
+
+// Structure of arrays storage for aabb
+struct aabb_soa {
+    vec3_soa min;
+    vec3_soa max;
+
+    aabb_soa() = default;
+    explicit aabb_soa(std::size_t count) : min(count), max(count) {}
+
+    auto size() const -> std::size_t {
+        return min.size();
+    }
+
+    auto resize(std::size_t count) -> void {
+        min.resize(count);
+        max.resize(count);
+    }
+
+    auto push_back(const aabb& box) -> void {
+        min.push_back(box.min);
+        max.push_back(box.max);
+    }
+
+    auto set(std::size_t idx, const aabb& box) -> void {
+        min.set(idx, box.min);
+        max.set(idx, box.max);
+    }
+
+    auto operator[](std::size_t idx) const -> aabb {
+        return aabb{min[idx], max[idx]};
+    }
+};
+
+// Structure of arrays storage for sphere
+struct sphere_soa {
+    vec3_soa center;
+    aligned_vector<float> radius;
+
+    sphere_soa() = default;
+    explicit sphere_soa(std::size_t count) : center(count), radius(count) {}
+
+    auto size() const -> std::size_t {
+        return radius.size();
+    }
+
+    auto resize(std::size_t count) -> void {
+        center.resize(count);
+        radius.resize(count);
+    }
+
+    auto push_back(const sphere& bounds) -> void {
+        center.push_back(bounds.center);
+        radius.push_back(bounds.radius);
+    }
+
+    auto set(std::size_t idx, const sphere& bounds) -> void {
+        center.set(idx, bounds.center);
+        radius[idx] = bounds.radius;
+    }
+
+    auto operator[](std::size_t idx) const -> sphere {
+        return sphere{center[idx], radius[idx]};
+    }
+};
+
+// Batched versions of the functions above. Element i of the inputs produces element i of out. Outputs are resized
+// to the input size and may be one of the inputs. Tests write one bit per element, bit i % 64 of word i / 64, and
+// need one word per 64 elements.
+
+inline auto merge(const aabb_soa& lhs, const aabb_soa& rhs, aabb_soa& out) -> void {
+    assert(lhs.size() == rhs.size());
+    out.resize(lhs.size());
+
+    simd::for_each_block(lhs.size(), [&](std::size_t i, auto tag) {
+        auto lower = [&](const float* a, const float* b, float* result) {
+            simd::store_lanes(result, simd::min(simd::load_lanes(tag, a), simd::load_lanes(tag, b)));
+        };
+        auto upper = [&](const float* a, const float* b, float* result) {
+            simd::store_lanes(result, simd::max(simd::load_lanes(tag, a), simd::load_lanes(tag, b)));
+        };
+
+        lower(&lhs.min.x[i], &rhs.min.x[i], &out.min.x[i]);
+        lower(&lhs.min.y[i], &rhs.min.y[i], &out.min.y[i]);
+        lower(&lhs.min.z[i], &rhs.min.z[i], &out.min.z[i]);
+        upper(&lhs.max.x[i], &rhs.max.x[i], &out.max.x[i]);
+        upper(&lhs.max.y[i], &rhs.max.y[i], &out.max.y[i]);
+        upper(&lhs.max.z[i], &rhs.max.z[i], &out.max.z[i]);
+    });
+}
+
+inline auto contains(const aabb_soa& boxes, const vec3& point, std::span<std::uint64_t> out) -> void {
+    assert(out.size() * 64 >= boxes.size());
+
+    simd::for_each_block(boxes.size(), [&](std::size_t i, auto tag) {
+        auto x = simd::broadcast(tag, point.x);
+        auto y = simd::broadcast(tag, point.y);
+        auto z = simd::broadcast(tag, point.z);
+
+        auto outside = simd::bitmask(simd::less(x, simd::load_lanes(tag, &boxes.min.x[i]))) |
+                       simd::bitmask(simd::less(y, simd::load_lanes(tag, &boxes.min.y[i]))) |
+                       simd::bitmask(simd::less(z, simd::load_lanes(tag, &boxes.min.z[i]))) |
+                       simd::bitmask(simd::less(simd::load_lanes(tag, &boxes.max.x[i]), x)) |
+                       simd::bitmask(simd::less(simd::load_lanes(tag, &boxes.max.y[i]), y)) |
+                       simd::bitmask(simd::less(simd::load_lanes(tag, &boxes.max.z[i]), z));
+        simd::store_bits(tag, out, i, ~outside);
+    });
+}
+
+inline auto overlaps(const aabb& query, const aabb_soa& boxes, std::span<std::uint64_t> out) -> void {
+    assert(out.size() * 64 >= boxes.size());
+
+    simd::for_each_block(boxes.size(), [&](std::size_t i, auto tag) {
+        auto separated = [&](float query_min, float query_max, const float* min, const float* max) {
+            return simd::bitmask(simd::less(simd::broadcast(tag, query_max), simd::load_lanes(tag, min))) |
+                   simd::bitmask(simd::less(simd::load_lanes(tag, max), simd::broadcast(tag, query_min)));
+        };
+
+        auto outside = separated(query.min.x, query.max.x, &boxes.min.x[i], &boxes.max.x[i]) |
+                       separated(query.min.y, query.max.y, &boxes.min.y[i], &boxes.max.y[i]) |
+                       separated(query.min.z, query.max.z, &boxes.min.z[i], &boxes.max.z[i]);
+        simd::store_bits(tag, out, i, ~outside);
+    });
+}
+
+// Arvo transform of every box by the same matrix
+inline auto transform(const mat4& mat, const aabb_soa& boxes, aabb_soa& out) -> void {
+    out.resize(boxes.size());
+
+    simd::for_each_block(boxes.size(), [&](std::size_t i, auto tag) {
+        auto half  = simd::broadcast(tag, 0.5f);
+        auto min_x = simd::load_lanes(tag, &boxes.min.x[i]);
+        auto min_y = simd::load_lanes(tag, &boxes.min.y[i]);
+        auto min_z = simd::load_lanes(tag, &boxes.min.z[i]);
+        auto max_x = simd::load_lanes(tag, &boxes.max.x[i]);
+        auto max_y = simd::load_lanes(tag, &boxes.max.y[i]);
+        auto max_z = simd::load_lanes(tag, &boxes.max.z[i]);
+
+        auto mid_x  = simd::mul(simd::add(min_x, max_x), half);
+        auto mid_y  = simd::mul(simd::add(min_y, max_y), half);
+        auto mid_z  = simd::mul(simd::add(min_z, max_z), half);
+        auto half_x = simd::mul(simd::sub(max_x, min_x), half);
+        auto half_y = simd::mul(simd::sub(max_y, min_y), half);
+        auto half_z = simd::mul(simd::sub(max_z, min_z), half);
+
+        // Row r of mat is {mat.w[r], mat.x[r], mat.y[r], mat.z[r]}
+        auto row = [&](float m0, float m1, float m2, float m3, float* min, float* max) {
+            auto mid = simd::fmadd(simd::broadcast(tag, m0), mid_x, simd::broadcast(tag, m3));
+            mid      = simd::fmadd(simd::broadcast(tag, m1), mid_y, mid);
+            mid      = simd::fmadd(simd::broadcast(tag, m2), mid_z, mid);
+
+            auto size = simd::mul(simd::broadcast(tag, std::abs(m0)), half_x);
+            size      = simd::fmadd(simd::broadcast(tag, std::abs(m1)), half_y, size);
+            size      = simd::fmadd(simd::broadcast(tag, std::abs(m2)), half_z, size);
+
+            simd::store_lanes(min, simd::sub(mid, size));
+            simd::store_lanes(max, simd::add(mid, size));
+        };
+
+        row(mat.w.w, mat.x.w, mat.y.w, mat.z.w, &out.min.x[i], &out.max.x[i]);
+        row(mat.w.x, mat.x.x, mat.y.x, mat.z.x, &out.min.y[i], &out.max.y[i]);
+        row(mat.w.y, mat.x.y, mat.y.y, mat.z.y, &out.min.z[i], &out.max.z[i]);
+    });
+}
+
+// Arvo transform of box i by mats[i], e.g. local bounds to world bounds. Each box is one 4 lane transform.
+inline auto transform(std::span<const mat4> mats, const aabb_soa& boxes, aabb_soa& out) -> void {
+    assert(mats.size() == boxes.size());
+    out.resize(boxes.size());
+
+    for(std::size_t i = 0; i < boxes.size(); ++i) {
+        out.set(i, transform(mats[i], boxes[i]));
+    }
+}
+
+// The same through exec, in chunks of grain boxes. out is resized on the calling thread before any chunk runs.
+template<typename Executor>
+inline auto transform(Executor&& exec,
+                      std::span<const mat4> mats,
+                      const aabb_soa& boxes,
+                      aabb_soa& out,
+                      std::size_t grain = default_grain) -> void {
+    assert(mats.size() == boxes.size());
+    out.resize(boxes.size());
+
+    parallel_for(exec, boxes.size(), grain, [&](std::size_t begin, std::size_t end) {
+        for(auto i = begin; i < end; ++i) {
+            out.set(i, transform(mats[i], boxes[i]));
+        }
+    });
+}
+
+inline auto merge(const sphere_soa& lhs, const sphere_soa& rhs, sphere_soa& out) -> void {
+    assert(lhs.size() == rhs.size());
+    out.resize(lhs.size());
+
+    simd::for_each_block(lhs.size(), [&](std::size_t i, auto tag) {
+        auto lx = simd::load_lanes(tag, &lhs.center.x[i]);
+        auto ly = simd::load_lanes(tag, &lhs.center.y[i]);
+        auto lz = simd::load_lanes(tag, &lhs.center.z[i]);
+        auto lr = simd::load_lanes(tag, &lhs.radius[i]);
+        auto rx = simd::load_lanes(tag, &rhs.center.x[i]);
+        auto ry = simd::load_lanes(tag, &rhs.center.y[i]);
+        auto rz = simd::load_lanes(tag, &rhs.center.z[i]);
+        auto rr = simd::load_lanes(tag, &rhs.radius[i]);
+
+        auto dx   = simd::sub(rx, lx);
+        auto dy   = simd::sub(ry, ly);
+        auto dz   = simd::sub(rz, lz);
+        auto dist = simd::sqrt(simd::fmadd(dx, dx, simd::fmadd(dy, dy, simd::mul(dz, dz))));
+
+        // Lanes where one sphere holds the other divide by a zero distance here, select throws those away
+        auto radius = simd::mul(simd::add(dist, simd::add(lr, rr)), simd::broadcast(tag, 0.5f));
+        auto t      = simd::div(simd::sub(radius, lr), dist);
+
+        auto lhs_short = simd::less(lr, simd::add(dist, rr));
+        auto rhs_short = simd::less(rr, simd::add(dist, lr));
+        auto pick      = [&](const auto& merged, const auto& left, const auto& right) {
+            return simd::select(lhs_short, simd::select(rhs_short, merged, right), left);
+        };
+
+        simd::store_lanes(&out.center.x[i], pick(simd::fmadd(dx, t, lx), lx, rx));
+        simd::store_lanes(&out.center.y[i], pick(simd::fmadd(dy, t, ly), ly, ry));
+        simd::store_lanes(&out.center.z[i], pick(simd::fmadd(dz, t, lz), lz, rz));
+        simd::store_lanes(&out.radius[i], pick(radius, lr, rr));
+    });
+}
+
+inline auto contains(const sphere_soa& spheres, const vec3& point, std::span<std::uint64_t> out) -> void {
+    assert(out.size() * 64 >= spheres.size());
+
+    simd::for_each_block(spheres.size(), [&](std::size_t i, auto tag) {
+        auto dx = simd::sub(simd::broadcast(tag, point.x), simd::load_lanes(tag, &spheres.center.x[i]));
+        auto dy = simd::sub(simd::broadcast(tag, point.y), simd::load_lanes(tag, &spheres.center.y[i]));
+        auto dz = simd::sub(simd::broadcast(tag, point.z), simd::load_lanes(tag, &spheres.center.z[i]));
+        auto r  = simd::load_lanes(tag, &spheres.radius[i]);
+
+        auto squared = simd::fmadd(dx, dx, simd::fmadd(dy, dy, simd::mul(dz, dz)));
+        simd::store_bits(tag, out, i, ~simd::bitmask(simd::less(simd::mul(r, r), squared)));
+    });
+}
+
+inline auto overlaps(const sphere& query, const sphere_soa& spheres, std::span<std::uint64_t> out) -> void {
+    assert(out.size() * 64 >= spheres.size());
+
+    simd::for_each_block(spheres.size(), [&](std::size_t i, auto tag) {
+        auto dx    = simd::sub(simd::broadcast(tag, query.center.x), simd::load_lanes(tag, &spheres.center.x[i]));
+        auto dy    = simd::sub(simd::broadcast(tag, query.center.y), simd::load_lanes(tag, &spheres.center.y[i]));
+        auto dz    = simd::sub(simd::broadcast(tag, query.center.z), simd::load_lanes(tag, &spheres.center.z[i]));
+        auto reach = simd::add(simd::broadcast(tag, query.radius), simd::load_lanes(tag, &spheres.radius[i]));
+
+        auto squared = simd::fmadd(dx, dx, simd::fmadd(dy, dy, simd::mul(dz, dz)));
+        simd::store_bits(tag, out, i, ~simd::bitmask(simd::less(simd::mul(reach, reach), squared)));
+    });
+}
+
+// Center through mat, radius scaled by the longest axis of mat, same as transform(mat, sphere)
+inline auto transform(const mat4& mat, const sphere_soa& spheres, sphere_soa& out) -> void {
+    out.resize(spheres.size());
+
+    auto scale = std::sqrt(std::max({
+        mat.w.w * mat.w.w + mat.w.x * mat.w.x + mat.w.y * mat.w.y,
+        mat.x.w * mat.x.w + mat.x.x * mat.x.x + mat.x.y * mat.x.y,
+        mat.y.w * mat.y.w + mat.y.x * mat.y.x + mat.y.y * mat.y.y,
+    }));
+
+    simd::for_each_block(spheres.size(), [&](std::size_t i, auto tag) {
+        auto x = simd::load_lanes(tag, &spheres.center.x[i]);
+        auto y = simd::load_lanes(tag, &spheres.center.y[i]);
+        auto z = simd::load_lanes(tag, &spheres.center.z[i]);
+
+        auto row = [&](float m0, float m1, float m2, float m3) {
+            auto result = simd::fmadd(simd::broadcast(tag, m0), x, simd::broadcast(tag, m3));
+            result      = simd::fmadd(simd::broadcast(tag, m1), y, result);
+            return simd::fmadd(simd::broadcast(tag, m2), z, result);
+        };
+
+        auto r = simd::load_lanes(tag, &spheres.radius[i]);
+
+        simd::store_lanes(&out.center.x[i], row(mat.w.w, mat.x.w, mat.y.w, mat.z.w));
+        simd::store_lanes(&out.center.y[i], row(mat.w.x, mat.x.x, mat.y.x, mat.z.x));
+        simd::store_lanes(&out.center.z[i], row(mat.w.y, mat.x.y, mat.y.y, mat.z.y));
+        simd::store_lanes(&out.radius[i], simd::mul(r, simd::broadcast(tag, scale)));
+    });
+}
+
+} // namespace admat
@@ -0,0 +1,525 @@
+#pragma once
+
+#include "admat/bounds.hpp"
+#include "admat/executor.hpp"
+#include "admat/intersect.hpp"
+#include "admat/simd.hpp"
+#include "admat/vec.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <vector>
+
+namespace admat {
+
+// Bounding volume hierarchy over primitives given only by their bounds, built with binned SAH. Nodes are stored
+// depth first in one array, so the left child of a node is the next node and the whole tree is one allocation.
+// Queries report primitive indices, exact primitive tests are left to the caller.
+class bvh {
+public:
+    // Interior nodes have count 0, their children are at index + 1 and at first. Leaves hold the primitives
+    // primitives()[first, first + count).
+    struct node {
+        aabb bounds;
+        std::uint32_t first;
+        std::uint32_t count;
+    };
+
+    static_assert(sizeof(node) == 32, "bvh node should be half a cache line");
+
+    // Nodes of up to max_leaf_size primitives are leaves, larger ones are always split
+    static constexpr std::size_t bin_count         = 16;
+    static constexpr std::uint32_t max_leaf_size   = 4;
+    static constexpr std::uint32_t max_depth       = 64;
+    static constexpr std::size_t default_bin_grain = 16384;
+
+    bvh() = default;
+
+    explicit bvh(std::span<const aabb> bounds) : bvh(bounds, serial_executor{}) {}
+
+    // Nodes holding more than grain primitives are binned in grain sized chunks handed to exec
+    template<typename Executor>
+    bvh(std::span<const aabb> bounds, Executor&& exec, std::size_t grain = default_bin_grain) {
+        assert(bounds.size() < std::numeric_limits<std::uint32_t>::max());
+        assert(grain > 0);
+
+        if(bounds.empty()) {
+            return;
+        }
+
+        primitives_.resize(bounds.size());
+        auto refs = std::vector<reference>(bounds.size());
+        exec(bounds.size(), grain, [&](std::size_t begin, std::size_t end) {
+            for(auto i = begin; i < end; ++i) {
+                primitives_[i] = static_cast<std::uint32_t>(i);
+                refs[i]        = make_reference(bounds[i]);
+            }
+        });
+
+        build(refs, exec, grain);
+    }
+
+    // Recomputes node bounds bottom up for primitives that moved, keeping the topology. Quality degrades as the
+    // primitives drift from where they were at build time.
+    auto refit(std::span<const aabb> bounds) -> void {
+        assert(bounds.size() == primitives_.size());
+
+        // Children always come after their parent
+        for(auto idx = nodes_.size(); idx-- > 0;) {
+            auto& current = nodes_[idx];
+            if(current.count > 0) {
+                current.bounds = aabb::empty();
+                for(auto i = current.first; i < current.first + current.count; ++i) {
+                    current.bounds = merge(current.bounds, bounds[primitives_[i]]);
+                }
+            } else {
+                current.bounds = merge(nodes_[idx + 1].bounds, nodes_[current.first].bounds);
+            }
+        }
+    }
+
+    auto nodes() const -> std::span<const node> {
+        return nodes_;
+    }
+
+    // Primitive indices in leaf order
+    auto primitives() const -> std::span<const std::uint32_t> {
+        return primitives_;
+    }
+
+    auto empty() const -> bool {
+        return nodes_.empty();
+    }
+
+    // Calls fn(primitive) once for each primitive in a leaf whose bounds overlap box. That includes every primitive
+    // whose own bounds overlap box, plus possibly a few of their leaf neighbours.
+    template<typename Fn>
+    auto query(const aabb& box, Fn&& fn) const -> void {
+        traverse([&](const aabb& bounds) { return overlaps(bounds, box); }, fn);
+    }
+
+    // Same as the aabb query, for leaves overlapping the sphere
+    template<typename Fn>
+    auto query(const sphere& bounds, Fn&& fn) const -> void {
+        traverse([&](const aabb& box) { return overlaps(box, bounds); }, fn);
+    }
+
+    // Closest hit. intersect(primitive, t_max) returns the distance of a hit closer than t_max, or miss. Leaves are
+    // visited front to back and skipped once they start beyond the closest hit so far. Returns that distance.
+    template<typename Intersect>
+    auto raycast(const ray& r, float t_max, Intersect&& intersect_primitive) const -> float {
+        return cast<false>(r, t_max, intersect_primitive);
+    }
+
+    // Any hit closer than t_max, stops at the first one
+    template<typename Intersect>
+    auto occluded(const ray& r, float t_max, Intersect&& intersect_primitive) const -> bool {
+        return cast<true>(r, t_max, intersect_primitive) < t_max;
+    }
+
+private:
+    // Bounds as a pair of registers, the fourth lane is ignored
+    struct range {
+        simd::f32x4 lower = simd::broadcast(std::numeric_limits<float>::max());
+        simd::f32x4 upper = simd::broadcast(-std::numeric_limits<float>::max());
+
+        auto merge(simd::f32x4 low, simd::f32x4 high) -> void {
+            lower = simd::min(lower, low);
+            upper = simd::max(upper, high);
+        }
+
+        auto merge(const range& other) -> void {
+            merge(other.lower, other.upper);
+        }
+
+        auto box() const -> aabb {
+            auto low  = simd::store<std::array<float, 4>>(lower);
+            auto high = simd::store<std::array<float, 4>>(upper);
+            return aabb{{low[0], low[1], low[2]}, {high[0], high[1], high[2]}};
+        }
+    };
+
+    struct bin {
+        range bounds;
+        std::uint32_t count = 0;
+    };
+
+    using bins = std::array<std::array<bin, bin_count>, 3>;
+
+    // The bounds of a primitive as the build reads them, moved around in step with primitives_ so binning and
+    // partitioning walk memory in order instead of gathering through primitive indices
+    struct reference {
+        simd::f32x4 lower;
+        simd::f32x4 upper;
+
+        auto centroid() const -> simd::f32x4 {
+            return simd::mul(simd::add(lower, upper), simd::broadcast(0.5f));
+        }
+    };
+
+    struct task {
+        std::uint32_t first;
+        std::uint32_t count;
+        std::uint32_t parent;
+        std::uint32_t depth;
+        aabb bounds;
+        range centroids;
+    };
+
+    struct split {
+        std::uint32_t axis;
+        std::uint32_t bin;
+        float cost;
+        aabb left;
+        aabb right;
+    };
+
+    static constexpr std::uint32_t no_parent = std::numeric_limits<std::uint32_t>::max();
+
+    static auto make_reference(const aabb& box) -> reference {
+        auto lower = std::array<float, 4>{box.min.x, box.min.y, box.min.z, 0.0f};
+        auto upper = std::array<float, 4>{box.max.x, box.max.y, box.max.z, 0.0f};
+        return reference{simd::load(lower), simd::load(upper)};
+    }
+
+    // Surface area up to a constant factor, 0 for an empty box
+    static constexpr auto area(const aabb& box) -> float {
+        auto size = box.max - box.min;
+        if(size.x < 0.0f || size.y < 0.0f || size.z < 0.0f) {
+            return 0.0f;
+        }
+        return size.x * size.y + size.y * size.z + size.z * size.x;
+    }
+
+    // Runs fn(chunk, begin, end) over [first, first + count) at once, or in chunks of grain through exec when larger
+    template<typename Executor, typename Fn>
+    static auto chunked(Executor& exec, std::size_t grain, std::uint32_t first, std::uint32_t count, Fn&& fn)
+        -> void {
+        if(count <= grain) {
+            fn(std::size_t{0}, std::size_t{first}, std::size_t{first} + count);
+            return;
+        }
+
+        auto chunks = (count + grain - 1) / grain;
+        exec(chunks, 1, [&](std::size_t begin, std::size_t end) {
+            for(auto chunk = begin; chunk < end; ++chunk) {
+                auto lo = first + chunk * grain;
+                fn(chunk, lo, std::min(lo + grain, std::size_t{first} + count));
+            }
+        });
+    }
+
+    // Bounds of refs [first, first + count) and of their centroids
+    template<typename Executor>
+    static auto measure(std::span<const reference> refs,
+                        Executor& exec,
+                        std::size_t grain,
+                        std::uint32_t first,
+                        std::uint32_t count) -> std::array<range, 2> {
+        auto chunk_ranges = std::vector<std::array<range, 2>>((count + grain - 1) / grain);
+        chunked(exec, grain, first, count, [&](std::size_t chunk, std::size_t lo, std::size_t hi) {
+            auto& [local_bounds, local_centroids] = chunk_ranges[chunk];
+            for(auto i = lo; i < hi; ++i) {
+                local_bounds.merge(refs[i].lower, refs[i].upper);
+                local_centroids.merge(refs[i].centroid(), refs[i].centroid());
+            }
+        });
+
+        auto result = std::array<range, 2>{};
+        for(const auto& [local_bounds, local_centroids] : chunk_ranges) {
+            result[0].merge(local_bounds);
+            result[1].merge(local_centroids);
+        }
+        return result;
+    }
+
+    // Children get their bounds from the bins of the chosen split and their centroid bounds from the partition, so
+    // each reference is read twice per level: once to bin it and once to partition it.
+    template<typename Executor>
+    auto build(std::span<reference> refs, Executor& exec, std::size_t grain) -> void {
+        nodes_.reserve(refs.size());
+
+        auto count         = static_cast<std::uint32_t>(refs.size());
+        auto [all, middle] = measure(refs, exec, grain, 0, count);
+        auto stack         = std::vector<task>{{0, count, no_parent, 0, all.box(), middle}};
+        auto chunk_bins    = std::vector<bins>{};
+        while(!stack.empty()) {
+            auto job = stack.back();
+            stack.pop_back();
+
+            // The left child is pushed last, so it always lands right after its parent
+            auto idx = static_cast<std::uint32_t>(nodes_.size());
+            if(job.parent != no_parent) {
+                nodes_[job.parent].first = idx;
+            }
+
+            nodes_.push_back(node{job.bounds, job.first, job.count});
+            if(job.count <= max_leaf_size || job.depth + 1 >= max_depth) {
+                continue;
+            }
+
+            nodes_[idx].count = 0;
+            auto half         = job.count / 2;
+            auto left         = task{job.first, half, no_parent, job.depth + 1, {}, job.centroids};
+            auto right        = task{job.first + half, job.count - half, idx, job.depth + 1, {}, job.centroids};
+
+            // Every primitive goes into one bin per axis, then each of the bin_count - 1 planes is scored
+            auto centroids = job.centroids.box();
+            auto to_bin    = [](float min, float max) {
+                return max > min ? static_cast<float>(bin_count) / (max - min) : 0.0f;
+            };
+            auto scale = std::array<float, 4>{
+                to_bin(centroids.min.x, centroids.max.x),
+                to_bin(centroids.min.y, centroids.max.y),
+                to_bin(centroids.min.z, centroids.max.z),
+                0.0f,
+            };
+
+            if(scale[0] > 0.0f || scale[1] > 0.0f || scale[2] > 0.0f) {
+                auto origin  = job.centroids.lower;
+                auto factor  = simd::load(scale);
+                auto offsets = [&](const reference& ref) {
+                    return simd::store<std::array<float, 4>>(simd::mul(simd::sub(ref.centroid(), origin), factor));
+                };
+
+                chunk_bins.assign((job.count + grain - 1) / grain, bins{});
+                chunked(exec, grain, job.first, job.count, [&](std::size_t chunk, std::size_t lo, std::size_t hi) {
+                    auto& local = chunk_bins[chunk];
+                    for(auto i = lo; i < hi; ++i) {
+                        auto offset = offsets(refs[i]);
+                        for(std::uint32_t axis = 0; axis < 3; ++axis) {
+                            auto& target = local[axis][bin_index(offset[axis])];
+                            target.bounds.merge(refs[i].lower, refs[i].upper);
+                            ++target.count;
+                        }
+                    }
+                });
+
+                auto best = best_split(chunk_bins, job.bounds, centroids);
+
+                // Partition in place, gathering the centroid bounds of both sides on the way
+                auto lo         = job.first;
+                auto hi         = job.first + job.count;
+                left.centroids  = range{};
+                right.centroids = range{};
+                while(lo < hi) {
+                    auto centroid = refs[lo].centroid();
+                    if(bin_index(offsets(refs[lo])[best.axis]) <= best.bin) {
+                        left.centroids.merge(centroid, centroid);
+                        ++lo;
+                    } else {
+                        right.centroids.merge(centroid, centroid);
+                        --hi;
+                        std::swap(refs[lo], refs[hi]);
+                        std::swap(primitives_[lo], primitives_[hi]);
+                    }
+                }
+
+                left.count   = lo - job.first;
+                left.bounds  = best.left;
+                right.first  = lo;
+                right.count  = job.count - left.count;
+                right.bounds = best.right;
+            } else {
+                // Every centroid is in the same spot and any split is as good as another
+                left.bounds  = measure(refs, exec, grain, left.first, left.count)[0].box();
+                right.bounds = measure(refs, exec, grain, right.first, right.count)[0].box();
+            }
+
+            stack.push_back(right);
+            stack.push_back(left);
+        }
+    }
+
+    // offset is the centroid's distance from the low end of the centroid bounds, in bins
+    static auto bin_index(float offset) -> std::uint32_t {
+        return std::min(static_cast<std::uint32_t>(std::max(offset, 0.0f)), static_cast<std::uint32_t>(bin_count - 1));
+    }
+
+    // Lowest SAH cost (1 for the traversal plus the expected primitive tests) over every axis and plane, with the
+    // plane after bin best.bin. Only axes the centroids span are tried, and on those the first and last bin are never
+    // empty, so some plane always splits the node.
+    static auto best_split(std::span<const bins> chunk_bins, const aabb& node_bounds, const aabb& centroids)
+        -> split {
+        auto best      = split{0, 0, std::numeric_limits<float>::max(), aabb::empty(), aabb::empty()};
+        auto node_area = area(node_bounds);
+
+        for(std::uint32_t axis = 0; axis < 3; ++axis) {
+            if(!(centroids.max[axis] > centroids.min[axis])) {
+                continue;
+            }
+
+            auto merged = chunk_bins[0][axis];
+            for(const auto& local : chunk_bins.subspan(1)) {
+                for(std::size_t b = 0; b < bin_count; ++b) {
+                    merged[b].bounds.merge(local[axis][b].bounds);
+                    merged[b].count += local[axis][b].count;
+                }
+            }
+
+            // Sweep from the right to get the cost of everything after each plane
+            auto right_bounds = std::array<aabb, bin_count>{};
+            auto right_cost   = std::array<float, bin_count>{};
+            auto right        = std::array<std::uint32_t, bin_count>{};
+            auto acc          = bin{};
+            for(auto b = bin_count - 1; b > 0; --b) {
+                acc.bounds.merge(merged[b].bounds);
+                acc.count          += merged[b].count;
+                right_bounds[b - 1] = acc.bounds.box();
+                right_cost[b - 1]   = area(right_bounds[b - 1]) * static_cast<float>(acc.count);
+                right[b - 1]        = acc.count;
+            }
+
+            acc = bin{};
+            for(std::size_t b = 0; b + 1 < bin_count; ++b) {
+                acc.bounds.merge(merged[b].bounds);
+                acc.count      += merged[b].count;
+                auto left_bounds = acc.bounds.box();
+                auto cost = 1.0f + (area(left_bounds) * static_cast<float>(acc.count) + right_cost[b]) / node_area;
+                if(acc.count > 0 && right[b] > 0 && cost < best.cost) {
+                    best = split{axis, static_cast<std::uint32_t>(b), cost, left_bounds, right_bounds[b]};
+                }
+            }
+        }
+        return best;
+    }
+
+    template<typename Accept, typename Fn>
+    auto traverse(Accept&& accept, Fn& fn) const -> void {
+        if(nodes_.empty()) {
+            return;
+        }
+
+        auto stack = std::array<std::uint32_t, max_depth>{};
+        auto top   = std::size_t{0};
+
+        stack[top++] = 0;
+        while(top > 0) {
+            const auto& current = nodes_[stack[--top]];
+            if(!accept(current.bounds)) {
+                continue;
+            }
+
+            if(current.count > 0) {
+                for(auto i = current.first; i < current.first + current.count; ++i) {
+                    fn(primitives_[i]);
+                }
+            } else {
+                stack[top++] = current.first;
+                stack[top++] = static_cast<std::uint32_t>(&current - nodes_.data()) + 1;
+            }
+        }
+    }
+
+    template<bool any, typename Intersect>
+    auto cast(const ray& r, float t_max, Intersect& intersect_primitive) const -> float {
+        if(nodes_.empty()) {
+            return miss;
+        }
+
+        struct entry {
+            std::uint32_t node;
+            float t;
+        };
+
+        auto inv     = inverse_direction(r);
+        auto closest = t_max;
+        auto stack   = std::array<entry, max_depth>{};
+        auto top     = std::size_t{0};
+
+        auto root_t = intersect(r.origin, inv, nodes_[0].bounds, closest);
+        if(root_t < miss) {
+            stack[top++] = entry{0, root_t};
+        }
+
+        while(top > 0) {
+            auto [idx, entry_t] = stack[--top];
+            if(!(entry_t < closest)) {
+                continue;
+            }
+
+            const auto& current = nodes_[idx];
+            if(current.count > 0) {
+                for(auto i = current.first; i < current.first + current.count; ++i) {
+                    closest = std::min(closest, intersect_primitive(primitives_[i], closest));
+                    if(any && closest < t_max) {
+                        return closest;
+                    }
+                }
+                continue;
+            }
+
+            // Push the far child first so the near one is popped next
+            auto near_node = idx + 1;
+            auto far_node  = current.first;
+            auto near_t    = intersect(r.origin, inv, nodes_[near_node].bounds, closest);
+            auto far_t     = intersect(r.origin, inv, nodes_[far_node].bounds, closest);
+            if(far_t < near_t) {
+                std::swap(near_node, far_node);
+                std::swap(near_t, far_t);
+            }
+
+            if(far_t < miss) {
+                stack[top++] = entry{far_node, far_t};
+            }
+            if(near_t < miss) {
+                stack[top++] = entry{near_node, near_t};
+            }
+        }
+        return closest < t_max ? closest : miss;
+    }
+
+    std::vector<node> nodes_;
+    std::vector<std::uint32_t> primitives_;
+};
+
+// Bounds of the triangles {vertices[indices[3 * i]], vertices[indices[3 * i + 1]], vertices[indices[3 * i + 2]]}
+inline auto triangle_bounds(std::span<const vec3> vertices, std::span<const std::uint32_t> indices)
+    -> std::vector<aabb> {
+    assert(indices.size() % 3 == 0);
+
+    auto bounds = std::vector<aabb>(indices.size() / 3);
+    for(std::size_t i = 0; i < bounds.size(); ++i) {
+        auto box  = aabb{vertices[indices[3 * i]], vertices[indices[3 * i]]};
+        box       = merge(box, vertices[indices[3 * i + 1]]);
+        bounds[i] = merge(box, vertices[indices[3 * i + 2]]);
+    }
+    return bounds;
+}
+
+// tree must be built over triangle_bounds(vertices, indices)
+inline auto closest_hit(const bvh& tree,
+                        std::span<const vec3> vertices,
+                        std::span<const std::uint32_t> indices,
+                        const ray& r,
+                        float t_max = miss) -> ray_hit {
+    auto result = ray_hit{0, miss, 0.0f, 0.0f};
+    tree.raycast(r, t_max, [&](std::uint32_t triangle, float closest) {
+        auto base = 3 * std::size_t{triangle};
+        auto hit  = intersect(r, vertices[indices[base]], vertices[indices[base + 1]], vertices[indices[base + 2]]);
+        if(hit.t < closest) {
+            result = ray_hit{triangle, hit.t, hit.u, hit.v};
+            return hit.t;
+        }
+        return miss;
+    });
+    return result;
+}
+
+inline auto any_hit(const bvh& tree,
+                    std::span<const vec3> vertices,
+                    std::span<const std::uint32_t> indices,
+                    const ray& r,
+                    float t_max = miss) -> bool {
+    return tree.occluded(r, t_max, [&](std::uint32_t triangle, float /*closest*/) {
+        auto base = 3 * std::size_t{triangle};
+        return intersect(r, vertices[indices[base]], vertices[indices[base + 1]], vertices[indices[base + 2]]).t;
+    });
+}
+
+} // namespace admat
@@ -0,0 +1,439 @@
+#pragma once
+
+// Runtime choice between builds of the span kernels for different instruction set tiers, so one binary compiled for
+// baseline x86-64 still runs the batch operations at AVX2 or AVX-512 width on hosts that have it. The dispatch::
+// functions share the names of the ones they route, like fast::, and pick the widest registered build the CPU
+// supports. The host is detected once per process. Setting the environment variable ADMAT_FORCE_ISA to a tier name
+// (baseline, sse4.2, avx2, avx512) caps it lower for testing, a tier above what the host supports is ignored.
+//
+// A tier is registered by one source file compiled with its flags that defines ADMAT_DISPATCH_IMPLEMENTATION before
+// including this header:
+//
+//     sse4.2   -msse4.2
+//     avx2     -mavx2 -mfma -mf16c, or /arch:AVX2 on MSVC
+//     avx512   -mavx512f -mavx512vl -mavx512bw -mavx512dq -mavx2 -mfma -mf16c, or /arch:AVX512 on MSVC
+//
+// Such a file should hold nothing else. Its kernels are flattened, every call inside them inlined, so none of the
+// wider code ends up in the inline functions the rest of the program shares. It must be compiled with optimization on
+// every compiler: unoptimized, GCC ignores flatten and MSVC may not inline, so the file emits its own wider copies of
+// those inline functions and the linker can pick them for baseline callers. Without registered tiers, or with none
+// above the tier the calling code itself is compiled for, the calls run the calling code's own build.
+//
+// The admat::kernels library, built with ADMAT_BUILD_KERNELS, holds every tier its compiler can target and defines
+// ADMAT_KERNELS for the code linking it. Its tiers are used without implementation files, and code compiled for the
+// baseline takes the baseline build from it as well, rather than compiling the kernels again in each file.
+
+#include "admat/batch.hpp"
+#include "admat/bounds.hpp"
+#include "admat/fast.hpp"
+#include "admat/frustum.hpp"
+#include "admat/half.hpp"
+#include "admat/mat.hpp"
+#include "admat/rebase.hpp"
+#include "admat/simd.hpp"
+#include "admat/vec.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <optional>
+#include <span>
+#include <string_view>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+    #define ADMAT_DISPATCH_X86 1
+    #if defined(_MSC_VER) && !defined(__clang__)
+        #include <intrin.h>
+    #else
+        #include <cpuid.h>
+    #endif
+#else
+    #define ADMAT_DISPATCH_X86 0
+#endif
+
+#if defined(_MSC_VER) && !defined(__clang__)
+    #define ADMAT_FLATTEN [[msvc::flatten]]
+#else
+    #define ADMAT_FLATTEN [[gnu::flatten]]
+#endif
+
+namespace admat::dispatch {
+
+// Ordered, each tier includes everything below it. baseline is whatever the target always has: SSE2 on x86-64, NEON
+// on arm64, plain floats elsewhere.
+enum class isa : std::uint8_t {
+    baseline,
+    sse4_2,
+    avx2,
+    avx512,
+};
+
+inline constexpr std::size_t isa_count = 4;
+
+// The tier of the code including this header, from its target flags
+#if ADMAT_SIMD_AVX512 && ADMAT_SIMD_FMA && defined(__AVX2__) && defined(__AVX512VL__) && defined(__AVX512BW__) &&      \
+    defined(__AVX512DQ__)
+    #define ADMAT_DISPATCH_TIER 3
+#elif ADMAT_SIMD_AVX && ADMAT_SIMD_FMA && defined(__AVX2__)
+    #define ADMAT_DISPATCH_TIER 2
+#elif ADMAT_SIMD_SSE && defined(__SSE4_2__)
+    #define ADMAT_DISPATCH_TIER 1
+#else
+    #define ADMAT_DISPATCH_TIER 0
+#endif
+
+inline constexpr isa compiled_isa = static_cast<isa>(ADMAT_DISPATCH_TIER);
+
+constexpr auto isa_name(isa tier) -> std::string_view {
+    switch(tier) {
+        case isa::baseline:
+            return "baseline";
+        case isa::sse4_2:
+            return "sse4.2";
+        case isa::avx2:
+            return "avx2";
+        case isa::avx512:
+            return "avx512";
+    }
+    return "baseline";
+}
+
+// The tier named like isa_name returns, nothing for any other name
+constexpr auto parse_isa(std::string_view name) -> std::optional<isa> {
+    for(std::size_t i = 0; i < isa_count; ++i) {
+        if(name == isa_name(static_cast<isa>(i))) {
+            return static_cast<isa>(i);
+        }
+    }
+    return std::nullopt;
+}
+
+namespace detail {
+
+#if ADMAT_DISPATCH_X86
+inline auto cpuid(std::uint32_t leaf) -> std::array<std::uint32_t, 4> {
+    auto regs = std::array<std::uint32_t, 4>{};
+    #if defined(_MSC_VER) && !defined(__clang__)
+    auto signed_regs = std::array<int, 4>{};
+    __cpuidex(signed_regs.data(), static_cast<int>(leaf), 0);
+    regs = std::bit_cast<std::array<std::uint32_t, 4>>(signed_regs);
+    #else
+    __cpuid_count(leaf, 0, regs[0], regs[1], regs[2], regs[3]);
+    #endif
+    return regs;
+}
+
+// Which register states the OS saves on a context switch, only valid when cpuid reports OSXSAVE
+inline auto enabled_states() -> std::uint64_t {
+    #if defined(_MSC_VER) && !defined(__clang__)
+    return _xgetbv(0);
+    #else
+    auto low  = std::uint32_t{0};
+    auto high = std::uint32_t{0};
+    __asm__("xgetbv" : "=a"(low), "=d"(high) : "c"(0));
+    return (std::uint64_t{high} << 32) | low;
+    #endif
+}
+#endif
+
+constexpr auto select_isa(isa detected, std::optional<isa> forced) -> isa {
+    return forced ? std::min(*forced, detected) : detected;
+}
+
+inline auto forced_isa() -> std::optional<isa> {
+#if defined(_MSC_VER)
+    char* value = nullptr;
+    auto size   = std::size_t{0};
+    if(_dupenv_s(&value, &size, "ADMAT_FORCE_ISA") != 0 || value == nullptr) {
+        return std::nullopt;
+    }
+    auto forced = parse_isa(value);
+    std::free(value); // NOLINT(cppcoreguidelines-no-malloc)
+    return forced;
+#else
+    const auto* value = std::getenv("ADMAT_FORCE_ISA"); // NOLINT(concurrency-mt-unsafe)
+    return value != nullptr ? parse_isa(value) : std::nullopt;
+#endif
+}
+
+} // namespace detail
+
+// The widest tier this CPU and OS can run
+inline auto detect_isa() -> isa {
+#if ADMAT_DISPATCH_X86
+    auto has      = [](std::uint32_t reg, int bit) { return ((reg >> bit) & 1u) != 0; };
+    auto max_leaf = detail::cpuid(0)[0];
+    auto features = max_leaf >= 1 ? detail::cpuid(1)[2] : 0u;
+    auto extended = max_leaf >= 7 ? detail::cpuid(7)[1] : 0u;
+    if(!has(features, 20)) {
+        return isa::baseline;
+    }
+
+    // AVX needs the OS to save the ymm registers, AVX-512 also the mask registers and the upper zmm halves
+    auto states = has(features, 27) ? detail::enabled_states() : 0;
+    auto avx2   = (states & 0x6) == 0x6 && has(features, 28) && has(features, 12) && has(features, 29) &&
+                has(extended, 5);
+    if(!avx2) {
+        return isa::sse4_2;
+    }
+
+    auto avx512 = (states & 0xe6) == 0xe6 && has(extended, 16) && has(extended, 17) && has(extended, 30) &&
+                  has(extended, 31);
+    return avx512 ? isa::avx512 : isa::avx2;
+#else
+    return isa::baseline;
+#endif
+}
+
+// detect_isa, capped by ADMAT_FORCE_ISA. Both are read on the first call only.
+inline auto active_isa() -> isa {
+    static const auto active = detail::select_isa(detect_isa(), detail::forced_isa());
+    return active;
+}
+
+// One build of every dispatched kernel
+struct kernel_table {
+    isa target;
+    void (*transform_points)(const mat4&, std::span<const vec3>, std::span<vec3>);
+    void (*transform_directions)(const mat4&, std::span<const vec3>, std::span<vec3>);
+    void (*transform_vec4)(const mat4&, std::span<const vec4>, std::span<vec4>);
+    void (*rotations)(std::span<const vec3>, std::span<const float>, std::span<mat4>);
+    void (*euler_rotations)(std::span<const vec3>, std::span<mat4>);
+    void (*yaw_pitch_roll_rotations)(std::span<const vec3>, std::span<mat4>);
+    void (*sincos)(std::span<const float>, std::span<float>, std::span<float>);
+    void (*rebase)(const dvec3&, std::span<const dvec3>, std::span<vec3>);
+    void (*to_half)(std::span<const vec4>, std::span<half4>);
+    void (*to_float)(std::span<const half4>, std::span<vec4>);
+    void (*cull_spheres)(const frustum&, const sphere_soa&, std::span<std::uint64_t>);
+    void (*cull_aabbs)(const frustum&, const aabb_soa&, std::span<std::uint64_t>);
+};
+
+namespace detail {
+
+// Registered tables by tier, constant initialized so registering works from any static initializer
+inline std::array<std::atomic<const kernel_table*>, isa_count> registered_kernels{};
+
+// The kernels as compiled in this translation unit. The tier in the name keeps builds for different tiers apart at
+// link time, so only code compiled for a tier may instantiate it. The functions are defined outside the class, not
+// inline, so an explicit instantiation declaration keeps them from being compiled again in every file.
+template<isa tier>
+struct kernel_functions {
+    static_assert(tier == compiled_isa, "instantiate kernel_functions only for the tier being compiled");
+
+    ADMAT_FLATTEN static auto transform_points(const mat4& mat, std::span<const vec3> in, std::span<vec3> out)
+        -> void;
+    ADMAT_FLATTEN static auto transform_directions(const mat4& mat, std::span<const vec3> in, std::span<vec3> out)
+        -> void;
+    ADMAT_FLATTEN static auto transform_vec4(const mat4& mat, std::span<const vec4> in, std::span<vec4> out) -> void;
+    ADMAT_FLATTEN static auto rotations(std::span<const vec3> axes, std::span<const float> angles, std::span<mat4> out)
+        -> void;
+    ADMAT_FLATTEN static auto euler_rotations(std::span<const vec3> radians, std::span<mat4> out) -> void;
+    ADMAT_FLATTEN static auto yaw_pitch_roll_rotations(std::span<const vec3> angles, std::span<mat4> out) -> void;
+    ADMAT_FLATTEN static auto sincos(std::span<const float> radians, std::span<float> sines, std::span<float> cosines)
+        -> void;
+    ADMAT_FLATTEN static auto rebase(const dvec3& origin, std::span<const dvec3> in, std::span<vec3> out) -> void;
+    ADMAT_FLATTEN static auto to_half(std::span<const vec4> in, std::span<half4> out) -> void;
+    ADMAT_FLATTEN static auto to_float(std::span<const half4> in, std::span<vec4> out) -> void;
+    ADMAT_FLATTEN static auto cull_spheres(const frustum& view,
+                                           const sphere_soa& spheres,
+                                           std::span<std::uint64_t> visible) -> void;
+    ADMAT_FLATTEN static auto cull_aabbs(const frustum& view, const aabb_soa& boxes, std::span<std::uint64_t> visible)
+        -> void;
+    ADMAT_FLATTEN static auto register_table() -> bool;
+
+    static constexpr kernel_table table = {
+        tier,
+        &transform_points,
+        &transform_directions,
+        &transform_vec4,
+        &rotations,
+        &euler_rotations,
+        &yaw_pitch_roll_rotations,
+        &sincos,
+        &rebase,
+        &to_half,
+        &to_float,
+        &cull_spheres,
+        &cull_aabbs,
+    };
+};
+
+template<isa tier>
+auto kernel_functions<tier>::transform_points(const mat4& mat, std::span<const vec3> in, std::span<vec3> out)
+    -> void {
+    admat::transform_points(mat, in, out);
+}
+
+template<isa tier>
+auto kernel_functions<tier>::transform_directions(const mat4& mat, std::span<const vec3> in, std::span<vec3> out)
+    -> void {
+    admat::transform_directions(mat, in, out);
+}
+
+template<isa tier>
+auto kernel_functions<tier>::transform_vec4(const mat4& mat, std::span<const vec4> in, std::span<vec4> out) -> void {
+    admat::transform(mat, in, out);
+}
+
+template<isa tier>
+auto kernel_functions<tier>::rotations(std::span<const vec3> axes, std::span<const float> angles, std::span<mat4> out)
+    -> void {
+    admat::rotations(axes, angles, out);
+}
+
+template<isa tier>
+auto kernel_functions<tier>::euler_rotations(std::span<const vec3> radians, std::span<mat4> out) -> void {
+    admat::euler_rotations(radians, out);
+}
+
+template<isa tier>
+auto kernel_functions<tier>::yaw_pitch_roll_rotations(std::span<const vec3> angles, std::span<mat4> out) -> void {
+    admat::yaw_pitch_roll_rotations(angles, out);
+}
+
+template<isa tier>
+auto kernel_functions<tier>::sincos(std::span<const float> radians, std::span<float> sines, std::span<float> cosines)
+    -> void {
+    fast::sincos(radians, sines, cosines);
+}
+
+template<isa tier>
+auto kernel_functions<tier>::rebase(const dvec3& origin, std::span<const dvec3> in, std::span<vec3> out) -> void {
+    admat::rebase(origin, in, out);
+}
+
+template<isa tier>
+auto kernel_functions<tier>::to_half(std::span<const vec4> in, std::span<half4> out) -> void {
+    admat::to_half(in, out);
+}
+
+template<isa tier>
+auto kernel_functions<tier>::to_float(std::span<const half4> in, std::span<vec4> out) -> void {
+    admat::to_float(in, out);
+}
+
+template<isa tier>
+auto kernel_functions<tier>::cull_spheres(const frustum& view,
+                                          const sphere_soa& spheres,
+                                          std::span<std::uint64_t> visible) -> void {
+    admat::cull(view, spheres, visible);
+}
+
+template<isa tier>
+auto kernel_functions<tier>::cull_aabbs(const frustum& view, const aabb_soa& boxes, std::span<std::uint64_t> visible)
+    -> void {
+    admat::cull(view, boxes, visible);
+}
+
+template<isa tier>
+auto kernel_functions<tier>::register_table() -> bool {
+    registered_kernels[static_cast<std::size_t>(tier)].store(&table, std::memory_order_release);
+    return true;
+}
+
+#if defined(ADMAT_KERNELS)
+// The tables of the admat::kernels library, null for tiers it does not build on this target. It holds the baseline
+// instantiation too, so code compiled for the baseline uses that one instead of compiling its own.
+extern const std::array<const kernel_table*, isa_count> library_kernels;
+
+    #if ADMAT_DISPATCH_TIER == 0 && !defined(ADMAT_DISPATCH_IMPLEMENTATION)
+extern template struct kernel_functions<isa::baseline>;
+    #endif
+#endif
+
+} // namespace detail
+
+// The widest registered table up to ceiling, or the calling code's own build when none is wider than it. Tables
+// register during static initialization, calls made before then may get a narrower one.
+inline auto kernels(isa ceiling) -> const kernel_table& {
+    for(auto tier = static_cast<std::size_t>(ceiling); tier > static_cast<std::size_t>(compiled_isa); --tier) {
+        if(const auto* table = detail::registered_kernels[tier].load(std::memory_order_acquire)) {
+            return *table;
+        }
+#if defined(ADMAT_KERNELS)
+        if(const auto* table = detail::library_kernels[tier]) {
+            return *table;
+        }
+#endif
+    }
+    return detail::kernel_functions<compiled_isa>::table;
+}
+
+inline auto kernels() -> const kernel_table& {
+    return kernels(active_isa());
+}
+
+// The batch.hpp, fast.hpp, rebase.hpp, half.hpp and frustum.hpp span functions of the same names, run by kernels().
+// Wider tiers fuse more multiply adds, so results can differ between hosts by the rounding of one operation.
+
+inline auto transform_points(const mat4& mat, std::span<const vec3> in, std::span<vec3> out) -> void {
+    kernels().transform_points(mat, in, out);
+}
+
+inline auto transform_directions(const mat4& mat, std::span<const vec3> in, std::span<vec3> out) -> void {
+    kernels().transform_directions(mat, in, out);
+}
+
+inline auto transform(const mat4& mat, std::span<const vec4> in, std::span<vec4> out) -> void {
+    kernels().transform_vec4(mat, in, out);
+}
+
+inline auto rotations(std::span<const vec3> axes, std::span<const float> angles, std::span<mat4> out) -> void {
+    kernels().rotations(axes, angles, out);
+}
+
+inline auto euler_rotations(std::span<const vec3> radians, std::span<mat4> out) -> void {
+    kernels().euler_rotations(radians, out);
+}
+
+inline auto yaw_pitch_roll_rotations(std::span<const vec3> angles, std::span<mat4> out) -> void {
+    kernels().yaw_pitch_roll_rotations(angles, out);
+}
+
+inline auto sincos(std::span<const float> radians, std::span<float> sines, std::span<float> cosines) -> void {
+    kernels().sincos(radians, sines, cosines);
+}
+
+inline auto rebase(const dvec3& origin, std::span<const dvec3> in, std::span<vec3> out) -> void {
+    kernels().rebase(origin, in, out);
+}
+
+inline auto to_half(std::span<const vec4> in, std::span<half4> out) -> void {
+    kernels().to_half(in, out);
+}
+
+inline auto to_float(std::span<const half4> in, std::span<vec4> out) -> void {
+    kernels().to_float(in, out);
+}
+
+inline auto cull(const frustum& view, const sphere_soa& spheres, std::span<std::uint64_t> visible) -> void {
+    kernels().cull_spheres(view, spheres, visible);
+}
+
+inline auto cull(const frustum& view, const aabb_soa& boxes, std::span<std::uint64_t> visible) -> void {
+    kernels().cull_aabbs(view, boxes, visible);
+}
+
+} // namespace admat::dispatch
+
+#if defined(ADMAT_DISPATCH_IMPLEMENTATION)
+    // MSVC has no macro for the optimization level, but its runtime checks cannot be combined with /O1 or /O2, so
+    // /RTC, on in the default Debug configuration, means the file is not optimized
+    #if (defined(__GNUC__) || defined(__clang__)) && !defined(__OPTIMIZE__)
+        #error "compile the files defining ADMAT_DISPATCH_IMPLEMENTATION with optimization, see admat/dispatch.hpp"
+    #elif defined(_MSC_VER) && defined(__MSVC_RUNTIME_CHECKS)
+        #error "compile the files defining ADMAT_DISPATCH_IMPLEMENTATION with /O2 and without /RTC"
+    #endif
+
+namespace admat::dispatch::detail {
+namespace {
+
+[[maybe_unused]] const bool registered = kernel_functions<compiled_isa>::register_table();
+
+} // namespace
+} // namespace admat::dispatch::detail
+#endif
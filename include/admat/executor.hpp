@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cstddef>
+
+namespace admat {
+
+// An executor is called as exec(count, grain, fn) and must run fn(begin, end) over ranges covering [0, count)
+// exactly once, each at least grain long where possible, and return once all of them have finished.
+struct serial_executor {
+    template<typename Fn>
+    auto operator()(std::size_t count, std::size_t /*grain*/, Fn&& fn) const -> void {
+        fn(std::size_t{0}, count);
+    }
+};
+
+// Elements per chunk for the span kernels. 8192 vec4 in and out is 256 KiB, so a chunk stays in a typical L2.
+inline constexpr std::size_t default_grain = 8192;
+
+// Runs fn(begin, end) over [0, count), through exec when there is more than one grain of work and directly on the
+// calling thread otherwise, so small jobs never pay for a hand off
+template<typename Executor, typename Fn>
+auto parallel_for(Executor&& exec, std::size_t count, std::size_t grain, Fn&& fn) -> void {
+    if(count > grain) {
+        exec(count, grain, fn);
+    } else if(count > 0) {
+        fn(std::size_t{0}, count);
+    }
+}
+
+} // namespace admat
@@ -0,0 +1,334 @@
+#pragma once
+
+// Lazy element wise arithmetic over spans of vec3, vec4 and float. lazy(span) wraps a span, and the operators, lerp,
+// clamp and abs only build an expression. Assigning it to a lazy output runs the whole expression as one loop, so
+//
+//     lazy(out) = lazy(a) * s + lazy(b);
+//
+// reads a and b once and writes out once, where the vec4 operators would store and reload a temporary per step.
+
+#include "admat/executor.hpp"
+#include "admat/simd.hpp"
+#include "admat/vec.hpp"
+
+#include <cassert>
+#include <concepts>
+#include <cstddef>
+#include <ranges>
+#include <span>
+#include <tuple>
+#include <type_traits>
+
+namespace admat {
+
+namespace expr {
+
+// Every operation here works per component, and vec3 and vec4 are packed floats, so a span of either is evaluated
+// as one flat float array. Nodes load a register of floats starting at float index i.
+
+template<typename T>
+concept element = std::same_as<T, float> || std::same_as<T, vec3> || std::same_as<T, vec4>;
+
+// Base of every node, so the operators below only match expressions
+struct node {};
+
+template<typename T>
+concept expression = std::derived_from<std::remove_cvref_t<T>, node>;
+
+// Plain numbers mix with expressions as a value repeated for every component
+template<typename T>
+concept operand = expression<T> || std::is_arithmetic_v<std::remove_cvref_t<T>>;
+
+// The element type shared by every non scalar argument, void when all of them are scalars
+template<typename... Ts>
+struct common_value {
+    using type = void;
+};
+
+template<typename T, typename... Ts>
+struct common_value<T, Ts...> {
+    using rest = typename common_value<Ts...>::type;
+    static_assert(std::is_void_v<T> || std::is_void_v<rest> || std::is_same_v<T, rest>,
+                  "expressions mix spans of different element types");
+    using type = std::conditional_t<std::is_void_v<T>, rest, T>;
+};
+
+// Element counts of the arguments must match, scalars have std::dynamic_extent and match anything
+inline auto common_size(std::size_t lhs, std::size_t rhs) -> std::size_t {
+    assert(lhs == std::dynamic_extent || rhs == std::dynamic_extent || lhs == rhs);
+    return lhs == std::dynamic_extent ? rhs : lhs;
+}
+
+template<typename T>
+inline auto floats(T* data) {
+    using value_type = std::remove_const_t<T>;
+    if constexpr(std::is_same_v<value_type, vec4>) {
+        return &data->w;
+    } else if constexpr(std::is_same_v<value_type, vec3>) {
+        return &data->x;
+    } else {
+        return data;
+    }
+}
+
+template<typename T>
+class view;
+
+// Writes source into out[begin, end), element indices
+template<typename T, typename Source>
+inline auto evaluate(std::span<T> out, const Source& source, std::size_t begin, std::size_t end) -> void {
+    constexpr auto components = view<T>::components;
+    if(begin == end) {
+        return;
+    }
+
+    auto* dst = floats(out.data());
+    simd::for_each_block(begin * components, end * components, [&](std::size_t i, auto tag) {
+        simd::store_lanes(dst + i, source.load(tag, i)); // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    });
+}
+
+template<typename T>
+class view : public node {
+public:
+    using value_type                        = std::remove_const_t<T>;
+    static constexpr std::size_t components = sizeof(value_type) / sizeof(float);
+
+    explicit view(std::span<T> data) : data_(data) {}
+
+    view(const view&) = default;
+    view(view&&)      = default;
+    ~view()           = default;
+
+    // Assignment writes through to the elements, like std::slice_array, rather than rebinding the span. Each
+    // element of out is computed from the same element of every input, so out may also be one of the inputs, as
+    // long as it does not partially overlap one.
+    auto operator=(const view& source) -> view&
+        requires(!std::is_const_v<T>)
+    {
+        return assign(source);
+    }
+
+    template<expression Source>
+    auto operator=(const Source& source) -> view&
+        requires(!std::is_const_v<T>)
+    {
+        return assign(source);
+    }
+
+    template<operand Source>
+    auto operator+=(const Source& source) -> view&
+        requires(!std::is_const_v<T>)
+    {
+        return assign(*this + source);
+    }
+
+    template<operand Source>
+    auto operator-=(const Source& source) -> view&
+        requires(!std::is_const_v<T>)
+    {
+        return assign(*this - source);
+    }
+
+    template<operand Source>
+    auto operator*=(const Source& source) -> view&
+        requires(!std::is_const_v<T>)
+    {
+        return assign(*this * source);
+    }
+
+    auto size() const -> std::size_t {
+        return data_.size();
+    }
+
+    auto span() const -> std::span<T> {
+        return data_;
+    }
+
+    template<typename Tag>
+    auto load(Tag tag, std::size_t i) const {
+        const auto* src = floats(data_.data());
+        return simd::load_lanes(tag, src + i); // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    }
+
+private:
+    template<typename Source>
+    auto assign(const Source& source) -> view& {
+        static_assert(std::is_same_v<typename Source::value_type, value_type>,
+                      "assigned expression has a different element type");
+        assert(source.size() == size());
+        evaluate(data_, source, 0, size());
+        return *this;
+    }
+
+    std::span<T> data_;
+};
+
+class scalar : public node {
+public:
+    using value_type = void;
+
+    explicit scalar(float value) : value_(value) {}
+
+    auto size() const -> std::size_t {
+        return std::dynamic_extent;
+    }
+
+    template<typename Tag>
+    auto load(Tag tag, std::size_t /*i*/) const {
+        return simd::broadcast(tag, value_);
+    }
+
+private:
+    float value_;
+};
+
+// Fn{}(tag, registers...) applied to the registers of every argument
+template<typename Fn, typename... Args>
+class op : public node {
+public:
+    using value_type = typename common_value<typename Args::value_type...>::type;
+
+    explicit op(const Args&... args) : args_(args...) {
+        auto count = std::dynamic_extent;
+        ((count = common_size(count, args.size())), ...);
+        size_ = count;
+    }
+
+    auto size() const -> std::size_t {
+        return size_;
+    }
+
+    template<typename Tag>
+    auto load(Tag tag, std::size_t i) const {
+        return std::apply([&](const auto&... arg) { return Fn{}(tag, arg.load(tag, i)...); }, args_);
+    }
+
+private:
+    std::tuple<Args...> args_;
+    std::size_t size_ = 0;
+};
+
+template<typename T>
+inline auto as_node(const T& value) {
+    if constexpr(expression<T>) {
+        return value;
+    } else {
+        return scalar(static_cast<float>(value));
+    }
+}
+
+template<typename Fn, typename... Args>
+inline auto make(const Args&... args) {
+    return op<Fn, decltype(as_node(args))...>(as_node(args)...);
+}
+
+struct add_fn {
+    auto operator()(auto /*tag*/, const auto& lhs, const auto& rhs) const {
+        return simd::add(lhs, rhs);
+    }
+};
+
+struct sub_fn {
+    auto operator()(auto /*tag*/, const auto& lhs, const auto& rhs) const {
+        return simd::sub(lhs, rhs);
+    }
+};
+
+struct mul_fn {
+    auto operator()(auto /*tag*/, const auto& lhs, const auto& rhs) const {
+        return simd::mul(lhs, rhs);
+    }
+};
+
+struct div_fn {
+    auto operator()(auto /*tag*/, const auto& lhs, const auto& rhs) const {
+        return simd::div(lhs, rhs);
+    }
+};
+
+// (1 - t) * from + t * to, the same form as lerp(vec4) so both give the same bits
+struct lerp_fn {
+    auto operator()(auto tag, const auto& from, const auto& to, const auto& delta) const {
+        auto delta_inv = simd::sub(simd::broadcast(tag, 1.0f), delta);
+        return simd::fmadd(to, delta, simd::mul(from, delta_inv));
+    }
+};
+
+struct clamp_fn {
+    auto operator()(auto /*tag*/, const auto& value, const auto& lower, const auto& upper) const {
+        return simd::min(simd::max(value, lower), upper);
+    }
+};
+
+struct abs_fn {
+    auto operator()(auto /*tag*/, const auto& value) const {
+        return simd::abs(value);
+    }
+};
+
+template<operand L, operand R>
+    requires(expression<L> || expression<R>)
+inline auto operator+(const L& lhs, const R& rhs) {
+    return make<add_fn>(lhs, rhs);
+}
+
+template<operand L, operand R>
+    requires(expression<L> || expression<R>)
+inline auto operator-(const L& lhs, const R& rhs) {
+    return make<sub_fn>(lhs, rhs);
+}
+
+template<operand L, operand R>
+    requires(expression<L> || expression<R>)
+inline auto operator*(const L& lhs, const R& rhs) {
+    return make<mul_fn>(lhs, rhs);
+}
+
+template<operand L, operand R>
+    requires(expression<L> || expression<R>)
+inline auto operator/(const L& lhs, const R& rhs) {
+    return make<div_fn>(lhs, rhs);
+}
+
+template<operand From, operand To, operand Delta>
+    requires(expression<From> || expression<To>)
+inline auto lerp(const From& from, const To& to, const Delta& delta) {
+    return make<lerp_fn>(from, to, delta);
+}
+
+template<expression Value, operand Lower, operand Upper>
+inline auto clamp(const Value& value, const Lower& lower, const Upper& upper) {
+    return make<clamp_fn>(value, lower, upper);
+}
+
+template<expression Value>
+inline auto abs(const Value& value) {
+    return make<abs_fn>(value);
+}
+
+} // namespace expr
+
+// Wraps a contiguous range of vec3, vec4 or float for use in expressions. The range must outlive the expression.
+template<std::ranges::contiguous_range Range>
+    requires std::ranges::borrowed_range<Range> &&
+             expr::element<std::remove_const_t<std::ranges::range_value_t<Range>>>
+inline auto lazy(Range&& range) {
+    using element_type = std::remove_reference_t<std::ranges::range_reference_t<Range>>;
+    return expr::view<element_type>(std::span<element_type>(range));
+}
+
+// Evaluates source into out through exec, in chunks of grain elements
+template<typename Executor, typename T, expr::expression Source>
+    requires(!std::is_const_v<T>)
+inline auto assign(Executor&& exec, expr::view<T> out, const Source& source, std::size_t grain = default_grain)
+    -> void {
+    static_assert(std::is_same_v<typename Source::value_type, std::remove_const_t<T>>,
+                  "assigned expression has a different element type");
+    assert(source.size() == out.size());
+    parallel_for(exec, out.size(), grain, [&](std::size_t begin, std::size_t end) {
+        expr::evaluate(out.span(), source, begin, end);
+    });
+}
+
+} // namespace admat
@@ -0,0 +1,233 @@
+#pragma once
+
+// Faster, less precise versions of the vec.hpp, mat.hpp and quat.hpp functions, for lighting, steering and anything
+// else that is fine with a few ulp. They share the exact functions' names, so qualifying a call with fast:: or a
+// using namespace admat::fast opts in. Square roots and divisions become hardware estimates refined by a Newton step,
+// sin and cos a polynomial over the angle reduced to [-pi/4, pi/4]. Worst errors against double precision, measured
+// over every float in range with and without FMA, and enforced by the tests:
+//
+//     rsqrt                 4 ulp, positive normal floats
+//     rcp                   3.5 ulp, normal floats below 2^126 in magnitude
+//     magnitude, distance   4.5 ulp
+//     normalize             5 ulp per component
+//     sin, cos, sincos      1.5 ulp for |radians| <= pi, absolute 8e-8 up to 8192
+//     tan                   5 ulp for |radians| <= pi/4, relative 4e-7 up to 1.5
+//
+// Without SSE or NEON, rsqrt and rcp are the exact operations. The span sincos runs the same reduction and polynomials
+// simd::wide_width angles at a time, within the same bounds.
+
+#include "admat/mat.hpp"
+#include "admat/quat.hpp"
+#include "admat/simd.hpp"
+#include "admat/vec.hpp"
+
+#include <array>
+#include <bit>
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <numbers>
+#include <span>
+
+namespace admat::detail {
+
+// pi/2 in three parts for the Cody and Waite reduction. The first two have few enough bits that their products with
+// any quadrant up to 8192 * 2/pi are exact.
+inline constexpr float half_pi_hi  = 1.5703125f;
+inline constexpr float half_pi_mid = 4.837512969970703125e-4f;
+inline constexpr float half_pi_lo  = 7.54978995489188216e-8f;
+
+// Minimax polynomials over [-pi/4, pi/4], from Cephes sinf and cosf
+inline constexpr std::array<float, 3> sin_poly = {-1.9515295891e-4f, 8.3321608736e-3f, -1.6666654611e-1f};
+inline constexpr std::array<float, 3> cos_poly = {2.443315711809948e-5f, -1.388731625493765e-3f, 4.166664568298827e-2f};
+
+} // namespace admat::detail
+
+namespace admat::fast {
+
+// 1 / sqrt(value). Zero, subnormals, infinity and NaN give an unspecified result.
+inline auto rsqrt(float value) -> float {
+#if ADMAT_SIMD_SSE
+    // 12 bit estimate, one Newton step about doubles the correct bits
+    auto estimate = _mm_cvtss_f32(_mm_rsqrt_ss(_mm_set_ss(value)));
+    return 0.5f * estimate * (3.0f - value * estimate * estimate);
+#elif ADMAT_SIMD_NEON
+    // 8 bit estimate, so two steps. vrsqrts is the (3 - a * b) / 2 part of one.
+    auto reg      = vdup_n_f32(value);
+    auto estimate = vrsqrte_f32(reg);
+    estimate      = vmul_f32(estimate, vrsqrts_f32(vmul_f32(reg, estimate), estimate));
+    estimate      = vmul_f32(estimate, vrsqrts_f32(vmul_f32(reg, estimate), estimate));
+    return vget_lane_f32(estimate, 0);
+#else
+    return 1.0f / std::sqrt(value);
+#endif
+}
+
+// 1 / value. Zero, subnormals, magnitudes from 2^126 up and NaN give an unspecified result.
+inline auto rcp(float value) -> float {
+#if ADMAT_SIMD_SSE
+    auto estimate = _mm_cvtss_f32(_mm_rcp_ss(_mm_set_ss(value)));
+    return estimate * (2.0f - value * estimate);
+#elif ADMAT_SIMD_NEON
+    // vrecps is the 2 - a * b part of a Newton step
+    auto reg      = vdup_n_f32(value);
+    auto estimate = vrecpe_f32(reg);
+    estimate      = vmul_f32(estimate, vrecps_f32(reg, estimate));
+    estimate      = vmul_f32(estimate, vrecps_f32(reg, estimate));
+    return vget_lane_f32(estimate, 0);
+#else
+    return 1.0f / value;
+#endif
+}
+
+template<std::size_t N>
+auto magnitude(const vec<float, N>& value) -> float {
+    auto length_sqr = dot(value, value);
+
+    // Only vectors shorter than about 1e-19 square to a subnormal, which rsqrt does not take
+    if(length_sqr < std::numeric_limits<float>::min()) {
+        return std::sqrt(length_sqr);
+    }
+    return length_sqr * rsqrt(length_sqr);
+}
+
+template<std::size_t N>
+auto normalize(const vec<float, N>& value) -> vec<float, N> {
+    return value * rsqrt(dot(value, value));
+}
+
+inline auto normalize(const quat& value) -> quat {
+    return value * rsqrt(dot(value, value));
+}
+
+template<std::size_t N>
+auto distance(const vec<float, N>& lhs, const vec<float, N>& rhs) -> float {
+    return magnitude(rhs - lhs);
+}
+
+struct sin_cos {
+    float sin;
+    float cos;
+};
+
+// Both at once, they share the range reduction. |radians| must be at most 8192, past that the reduction loses bits
+// of the angle.
+constexpr auto sincos(float radians) -> sin_cos {
+    assert(std::abs(radians) <= 8192.0f);
+
+    // Nearest multiple of pi/2, subtracted in three parts
+    auto scaled   = radians * std::numbers::inv_pi_v<float> * 2.0f;
+    auto quadrant = static_cast<std::int32_t>(scaled + (scaled < 0.0f ? -0.5f : 0.5f));
+    auto multiple = static_cast<float>(quadrant);
+    auto reduced  = radians - multiple * detail::half_pi_hi;
+    reduced       = reduced - multiple * detail::half_pi_mid;
+    reduced       = reduced - multiple * detail::half_pi_lo;
+
+    auto sqr  = reduced * reduced;
+    auto poly = [sqr](const std::array<float, 3>& coeffs) { return (coeffs[0] * sqr + coeffs[1]) * sqr + coeffs[2]; };
+    auto sin  = poly(detail::sin_poly) * sqr * reduced + reduced;
+    auto cos  = poly(detail::cos_poly) * sqr * sqr - 0.5f * sqr + 1.0f;
+
+    // Each quadrant turns the reduced angle a quarter further. Odd ones swap sin and cos, quadrants 2 and 3 negate
+    // sin, 1 and 2 negate cos. Done on the bits, the quadrants of random angles would mispredict branches.
+    auto swap     = 0u - static_cast<std::uint32_t>(quadrant & 1);
+    auto sin_bits = std::bit_cast<std::uint32_t>(sin);
+    auto cos_bits = std::bit_cast<std::uint32_t>(cos);
+    auto sin_sign = static_cast<std::uint32_t>(quadrant & 2) << 30;
+    auto cos_sign = static_cast<std::uint32_t>((quadrant + 1) & 2) << 30;
+
+    return sin_cos{
+        std::bit_cast<float>(((sin_bits & ~swap) | (cos_bits & swap)) ^ sin_sign),
+        std::bit_cast<float>(((cos_bits & ~swap) | (sin_bits & swap)) ^ cos_sign),
+    };
+}
+
+constexpr auto sin(float radians) -> float {
+    return sincos(radians).sin;
+}
+
+constexpr auto cos(float radians) -> float {
+    return sincos(radians).cos;
+}
+
+inline auto tan(float radians) -> float {
+    auto [sin, cos] = sincos(radians);
+    return sin * rcp(cos);
+}
+
+inline auto rotation(const vec3& axis, float radians) -> mat4 {
+    auto [sin, cos] = sincos(radians);
+    return detail::rotation_from(normalize(axis), sin, cos);
+}
+
+inline auto from_axis_angle(const vec3& axis, float radians) -> quat {
+    auto ax         = normalize(axis);
+    auto [sin, cos] = sincos(radians * 0.5f);
+
+    return quat{cos, ax.x * sin, ax.y * sin, ax.z * sin};
+}
+
+// Right-handed, zero to one depth, projection matrix
+inline auto perspective(float fov, float aspect, float near_plane, float far_plane) -> mat4 {
+    assert(fov > 0.0f && fov < static_cast<float>(std::numbers::pi));
+    assert(near_plane > 0.0f);
+    assert(far_plane > near_plane);
+
+    auto [sin, cos] = sincos(fov * 0.5f);
+    return detail::perspective_from(cos * rcp(sin), aspect, near_plane, far_plane);
+}
+
+} // namespace admat::fast
+
+namespace admat::simd {
+
+// fast::sincos per lane. The registers only hold floats, so the quadrant stays a float and picks the lanes to swap
+// and negate through select.
+template<typename Tag, typename Reg>
+inline auto sincos(Tag tag, const Reg& radians) -> std::array<Reg, 2> {
+    auto one      = broadcast(tag, 1.0f);
+    auto multiple = round(mul(radians, broadcast(tag, std::numbers::inv_pi_v<float> * 2.0f)));
+    auto reduced  = sub(radians, mul(multiple, broadcast(tag, admat::detail::half_pi_hi)));
+    reduced       = sub(reduced, mul(multiple, broadcast(tag, admat::detail::half_pi_mid)));
+    reduced       = sub(reduced, mul(multiple, broadcast(tag, admat::detail::half_pi_lo)));
+
+    auto sqr  = mul(reduced, reduced);
+    auto poly = [&](const std::array<float, 3>& coeffs) {
+        auto inner = fmadd(broadcast(tag, coeffs[0]), sqr, broadcast(tag, coeffs[1]));
+        return fmadd(inner, sqr, broadcast(tag, coeffs[2]));
+    };
+    auto sin = fmadd(mul(poly(admat::detail::sin_poly), sqr), reduced, reduced);
+    auto cos = add(fmadd(mul(poly(admat::detail::cos_poly), sqr), sqr, mul(broadcast(tag, -0.5f), sqr)), one);
+
+    // multiple mod 4 is multiple - 4 * floor(multiple / 4). Subtracting 3/8 before rounding floors a whole number of
+    // quarters without hitting a tie, and the same on halves tells the odd quadrants apart.
+    auto quarters = round(fmadd(multiple, broadcast(tag, 0.25f), broadcast(tag, -0.375f)));
+    auto quadrant = fmadd(quarters, broadcast(tag, -4.0f), multiple);
+    auto halves   = round(fmadd(quadrant, broadcast(tag, 0.5f), broadcast(tag, -0.25f)));
+    auto odd      = fmadd(halves, broadcast(tag, -2.0f), quadrant);
+
+    auto even     = less(odd, broadcast(tag, 0.5f));
+    auto sin_sign = select(less(quadrant, broadcast(tag, 1.5f)), one, broadcast(tag, -1.0f));
+    auto cos_sign = select(less(abs(sub(quadrant, broadcast(tag, 1.5f))), one), broadcast(tag, -1.0f), one);
+    return {mul(select(even, sin, cos), sin_sign), mul(select(even, cos, sin), cos_sign)};
+}
+
+} // namespace admat::simd
+
+namespace admat::fast {
+
+// sines[i] and cosines[i] of radians[i], each at most 8192 in magnitude. sines and cosines must hold at least
+// radians.size() elements.
+inline auto sincos(std::span<const float> radians, std::span<float> sines, std::span<float> cosines) -> void {
+    assert(sines.size() >= radians.size() && cosines.size() >= radians.size());
+
+    simd::for_each_block(radians.size(), [&](std::size_t i, auto tag) {
+        auto [sin, cos] = simd::sincos(tag, simd::load_lanes(tag, &radians[i]));
+        simd::store_lanes(&sines[i], sin);
+        simd::store_lanes(&cosines[i], cos);
+    });
+}
+
+} // namespace admat::fast
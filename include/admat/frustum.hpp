@@ -0,0 +1,241 @@
+#pragma once
+
+#include "admat/bounds.hpp"
+#include "admat/executor.hpp"
+#include "admat/mat.hpp"
+#include "admat/simd.hpp"
+#include "admat/soa.hpp"
+#include "admat/vec.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <span>
+
+namespace admat {
+
+// Points with dot(normal, point) + distance >= 0 are on the inside
+struct plane {
+    vec3 normal;
+    float distance;
+};
+
+constexpr auto signed_distance(const plane& pln, const vec3& point) -> float {
+    return dot(pln.normal, point) + pln.distance;
+}
+
+// Six inward facing planes in the order left, right, bottom, top, near, far
+struct frustum {
+    std::array<plane, 6> planes;
+
+    // Gribb-Hartmann extraction for the right-handed, zero to one depth clip space of perspective(). Pass a
+    // projection for view space planes or projection * view for world space planes.
+    static constexpr auto from_mat4(const mat4& mat) -> frustum {
+        auto row0 = vec4{mat.w.w, mat.x.w, mat.y.w, mat.z.w};
+        auto row1 = vec4{mat.w.x, mat.x.x, mat.y.x, mat.z.x};
+        auto row2 = vec4{mat.w.y, mat.x.y, mat.y.y, mat.z.y};
+        auto row3 = vec4{mat.w.z, mat.x.z, mat.y.z, mat.z.z};
+
+        auto normalized = [](const vec4& coeffs) {
+            auto normal = vec3{coeffs.w, coeffs.x, coeffs.y};
+            auto length = std::sqrt(dot(normal, normal));
+            return plane{normal / length, coeffs.z / length};
+        };
+
+        // Depth runs from 0 to w, so the near plane is row2 alone instead of row3 + row2
+        return frustum{{
+            normalized(row3 + row0),
+            normalized(row3 - row0),
+            normalized(row3 + row1),
+            normalized(row3 - row1),
+            normalized(row2),
+            normalized(row3 - row2),
+        }};
+    }
+};
+
+// Conservative, spheres that straddle two planes outside a corner count as visible
+constexpr auto visible(const frustum& view, const vec3& center, float radius) -> bool {
+    return std::ranges::all_of(view.planes, [&](const plane& pln) { return signed_distance(pln, center) >= -radius; });
+}
+
+// Tests the corner furthest along each plane normal, conservative like the sphere test
+constexpr auto visible(const frustum& view, const vec3& min, const vec3& max) -> bool {
+    return std::ranges::all_of(view.planes, [&](const plane& pln) {
+        auto corner = vec3{
+            pln.normal.x >= 0.0f ? max.x : min.x,
+            pln.normal.y >= 0.0f ? max.y : min.y,
+            pln.normal.z >= 0.0f ? max.z : min.z,
+        };
+        return signed_distance(pln, corner) >= 0.0f;
+    });
+}
+
+constexpr auto visible(const frustum& view, const sphere& bounds) -> bool {
+    return visible(view, bounds.center, bounds.radius);
+}
+
+constexpr auto visible(const frustum& view, const aabb& box) -> bool {
+    return visible(view, box.min, box.max);
+}
+
+namespace simd {
+
+// Smallest signed distance of the points to any of the planes
+template<typename Tag, typename Reg>
+inline auto nearest_plane(Tag tag, const frustum& view, const Reg& x, const Reg& y, const Reg& z) -> Reg {
+    auto nearest = broadcast(tag, std::numeric_limits<float>::max());
+    for(const auto& pln : view.planes) {
+        auto dist = fmadd(broadcast(tag, pln.normal.z), z, broadcast(tag, pln.distance));
+        dist      = fmadd(broadcast(tag, pln.normal.y), y, dist);
+        dist      = fmadd(broadcast(tag, pln.normal.x), x, dist);
+        nearest   = min(nearest, dist);
+    }
+    return nearest;
+}
+
+// cull_spheres over elements [begin, end) only. begin must be a multiple of 64, so every word written belongs to the
+// range and ranges can be culled concurrently.
+inline auto cull_spheres(const frustum& view,
+                         const vec3_soa& centers,
+                         std::span<const float> radii,
+                         std::span<std::uint64_t> visible,
+                         std::size_t begin,
+                         std::size_t end) -> void {
+    assert(begin % 64 == 0);
+    std::fill(visible.begin() + static_cast<std::ptrdiff_t>(begin / 64),
+              visible.begin() + static_cast<std::ptrdiff_t>((end + 63) / 64),
+              std::uint64_t{0});
+
+    for_each_block(begin, end, [&](std::size_t i, auto tag) {
+        auto nearest = nearest_plane(tag,
+                                     view,
+                                     load_lanes(tag, &centers.x[i]),
+                                     load_lanes(tag, &centers.y[i]),
+                                     load_lanes(tag, &centers.z[i]));
+
+        auto outside = less(add(nearest, load_lanes(tag, &radii[i])), broadcast(tag, 0.0f));
+        store_bits(tag, visible, i, ~bitmask(outside));
+    });
+}
+
+// cull_aabbs over elements [begin, end) only, with the same requirement on begin as cull_spheres
+inline auto cull_aabbs(const frustum& view,
+                       const vec3_soa& mins,
+                       const vec3_soa& maxs,
+                       std::span<std::uint64_t> visible,
+                       std::size_t begin,
+                       std::size_t end) -> void {
+    assert(begin % 64 == 0);
+    std::fill(visible.begin() + static_cast<std::ptrdiff_t>(begin / 64),
+              visible.begin() + static_cast<std::ptrdiff_t>((end + 63) / 64),
+              std::uint64_t{0});
+
+    for_each_block(begin, end, [&](std::size_t i, auto tag) {
+        auto min_x = load_lanes(tag, &mins.x[i]);
+        auto min_y = load_lanes(tag, &mins.y[i]);
+        auto min_z = load_lanes(tag, &mins.z[i]);
+        auto max_x = load_lanes(tag, &maxs.x[i]);
+        auto max_y = load_lanes(tag, &maxs.y[i]);
+        auto max_z = load_lanes(tag, &maxs.z[i]);
+
+        // The corner is picked per plane from the sign of its normal, which is the same for every lane
+        auto nearest = broadcast(tag, std::numeric_limits<float>::max());
+        for(const auto& pln : view.planes) {
+            auto dist = fmadd(broadcast(tag, pln.normal.z),
+                              pln.normal.z >= 0.0f ? max_z : min_z,
+                              broadcast(tag, pln.distance));
+            dist      = fmadd(broadcast(tag, pln.normal.y), pln.normal.y >= 0.0f ? max_y : min_y, dist);
+            dist      = fmadd(broadcast(tag, pln.normal.x), pln.normal.x >= 0.0f ? max_x : min_x, dist);
+            nearest   = min(nearest, dist);
+        }
+
+        store_bits(tag, visible, i, ~bitmask(less(nearest, broadcast(tag, 0.0f))));
+    });
+}
+
+} // namespace simd
+
+// Bit i % 64 of visible[i / 64] is set when sphere i passes visible(view, centers[i], radii[i]). Needs one word
+// per 64 spheres, the words covering the spheres are overwritten.
+inline auto cull_spheres(const frustum& view,
+                         const vec3_soa& centers,
+                         std::span<const float> radii,
+                         std::span<std::uint64_t> visible) -> void {
+    assert(radii.size() == centers.size() && visible.size() * 64 >= centers.size());
+    simd::cull_spheres(view, centers, radii, visible, 0, centers.size());
+}
+
+// Same bit layout as cull_spheres, each box is tested like visible(view, mins[i], maxs[i])
+inline auto cull_aabbs(const frustum& view,
+                       const vec3_soa& mins,
+                       const vec3_soa& maxs,
+                       std::span<std::uint64_t> visible) -> void {
+    assert(mins.size() == maxs.size() && visible.size() * 64 >= mins.size());
+    simd::cull_aabbs(view, mins, maxs, visible, 0, mins.size());
+}
+
+inline auto cull(const frustum& view, const sphere_soa& spheres, std::span<std::uint64_t> visible) -> void {
+    cull_spheres(view, spheres.center, spheres.radius, visible);
+}
+
+inline auto cull(const frustum& view, const aabb_soa& boxes, std::span<std::uint64_t> visible) -> void {
+    cull_aabbs(view, boxes.min, boxes.max, visible);
+}
+
+// Executor versions of the above, run through exec in chunks of about grain elements. Chunks are split on whole words
+// of visible, so no two of them write the same word.
+
+template<typename Executor>
+inline auto cull_spheres(Executor&& exec,
+                         const frustum& view,
+                         const vec3_soa& centers,
+                         std::span<const float> radii,
+                         std::span<std::uint64_t> visible,
+                         std::size_t grain = default_grain) -> void {
+    assert(radii.size() == centers.size() && visible.size() * 64 >= centers.size());
+    auto count = centers.size();
+    auto words = (count + 63) / 64;
+    parallel_for(exec, words, std::max(grain / 64, std::size_t{1}), [&](std::size_t first, std::size_t last) {
+        simd::cull_spheres(view, centers, radii, visible, first * 64, std::min(last * 64, count));
+    });
+}
+
+template<typename Executor>
+inline auto cull_aabbs(Executor&& exec,
+                       const frustum& view,
+                       const vec3_soa& mins,
+                       const vec3_soa& maxs,
+                       std::span<std::uint64_t> visible,
+                       std::size_t grain = default_grain) -> void {
+    assert(mins.size() == maxs.size() && visible.size() * 64 >= mins.size());
+    auto count = mins.size();
+    auto words = (count + 63) / 64;
+    parallel_for(exec, words, std::max(grain / 64, std::size_t{1}), [&](std::size_t first, std::size_t last) {
+        simd::cull_aabbs(view, mins, maxs, visible, first * 64, std::min(last * 64, count));
+    });
+}
+
+template<typename Executor>
+inline auto cull(Executor&& exec,
+                 const frustum& view,
+                 const sphere_soa& spheres,
+                 std::span<std::uint64_t> visible,
+                 std::size_t grain = default_grain) -> void {
+    cull_spheres(exec, view, spheres.center, spheres.radius, visible, grain);
+}
+
+template<typename Executor>
+inline auto cull(Executor&& exec,
+                 const frustum& view,
+                 const aabb_soa& boxes,
+                 std::span<std::uint64_t> visible,
+                 std::size_t grain = default_grain) -> void {
+    cull_aabbs(exec, view, boxes.min, boxes.max, visible, grain);
+}
+
+} // namespace admat
@@ -0,0 +1,239 @@
+#pragma once
+
+// IEEE 754 binary16 storage for vertex and animation streams, half the size of float. The types only store values,
+// convert them to vec2/vec3/vec4 to compute. The span conversions use F16C or AVX-512 when the target has them, the
+// scalar ones are constexpr and bit exact with the hardware, rounding to nearest even.
+
+#include "admat/simd.hpp"
+#include "admat/vec.hpp"
+
+#include <bit>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <type_traits>
+
+namespace admat {
+
+struct half {
+    std::uint16_t bits;
+};
+
+struct half2 {
+    half x;
+    half y;
+};
+
+// Lanes named like vec4, a vec3 fills the first three and leaves z zero
+struct half4 {
+    half w;
+    half x;
+    half y;
+    half z;
+};
+
+static_assert(sizeof(half) == 2 && sizeof(half2) == 4 && sizeof(half4) == 8, "half types are padded");
+static_assert(std::is_standard_layout_v<half4> && std::is_trivial_v<half4>, "half4 not pod");
+
+// Values above the largest half become infinity, values below the smallest subnormal round to zero. NaN stays NaN,
+// with the quiet bit set like F16C does.
+constexpr auto to_half(float value) -> half {
+    auto bits     = std::bit_cast<std::uint32_t>(value);
+    auto sign     = static_cast<std::uint32_t>((bits >> 16) & 0x8000u);
+    auto exponent = static_cast<int>((bits >> 23) & 0xffu);
+    auto mantissa = bits & 0x7fffffu;
+
+    if(exponent == 0xff) {
+        auto nan = mantissa != 0 ? 0x200u | (mantissa >> 13) : 0u;
+        return half{static_cast<std::uint16_t>(sign | 0x7c00u | nan)};
+    }
+
+    // Exponent rebiased from 127 to 15
+    auto rebiased = exponent - 127 + 15;
+    if(rebiased >= 31) {
+        return half{static_cast<std::uint16_t>(sign | 0x7c00u)};
+    }
+
+    // Drops the low shift bits of result, rounding to nearest even. A carry out of the mantissa correctly bumps the
+    // exponent, up to infinity.
+    auto round = [](std::uint32_t result, std::uint32_t dropped, int shift) {
+        auto halfway = std::uint32_t{1} << (shift - 1);
+        auto rest    = dropped & ((std::uint32_t{1} << shift) - 1);
+        return rest > halfway || (rest == halfway && (result & 1u) != 0) ? result + 1 : result;
+    };
+
+    if(rebiased <= 0) {
+        // Subnormal half, counted in units of 2^-24. Anything below 2^-25 rounds to zero.
+        if(rebiased < -10) {
+            return half{static_cast<std::uint16_t>(sign)};
+        }
+        auto significand = mantissa | 0x800000u;
+        auto shift       = 14 - rebiased;
+        return half{static_cast<std::uint16_t>(sign | round(significand >> shift, significand, shift))};
+    }
+
+    auto result = (static_cast<std::uint32_t>(rebiased) << 10) | (mantissa >> 13);
+    return half{static_cast<std::uint16_t>(sign | round(result, mantissa, 13))};
+}
+
+// Exact, every half is a float
+constexpr auto to_float(half value) -> float {
+    auto sign     = static_cast<std::uint32_t>(value.bits & 0x8000u) << 16;
+    auto exponent = static_cast<std::uint32_t>((value.bits >> 10) & 0x1fu);
+    auto mantissa = static_cast<std::uint32_t>(value.bits & 0x3ffu);
+
+    if(exponent == 0x1f) {
+        return std::bit_cast<float>(sign | 0x7f800000u | (mantissa << 13));
+    }
+
+    if(exponent == 0) {
+        if(mantissa == 0) {
+            return std::bit_cast<float>(sign);
+        }
+
+        // Subnormal, shifted up until the leading bit becomes the implicit one
+        auto rebiased = std::uint32_t{127 - 15 + 1};
+        do {
+            mantissa <<= 1;
+            --rebiased;
+        } while((mantissa & 0x400u) == 0);
+        return std::bit_cast<float>(sign | (rebiased << 23) | ((mantissa & 0x3ffu) << 13));
+    }
+
+    return std::bit_cast<float>(sign | ((exponent + 127 - 15) << 23) | (mantissa << 13));
+}
+
+constexpr auto to_half(const vec2& vec) -> half2 {
+    return half2{to_half(vec.x), to_half(vec.y)};
+}
+
+constexpr auto to_half(const vec3& vec) -> half4 {
+    return half4{to_half(vec.x), to_half(vec.y), to_half(vec.z), half{0}};
+}
+
+constexpr auto to_half(const vec4& vec) -> half4 {
+    return half4{to_half(vec.w), to_half(vec.x), to_half(vec.y), to_half(vec.z)};
+}
+
+constexpr auto to_float(const half2& value) -> vec2 {
+    return vec2{to_float(value.x), to_float(value.y)};
+}
+
+constexpr auto to_float(const half4& value) -> vec4 {
+    return vec4{to_float(value.w), to_float(value.x), to_float(value.y), to_float(value.z)};
+}
+
+namespace simd {
+
+// Packed types are runs of float or half, so vec2/vec4 spans convert as one flat array
+
+inline auto to_half(const float* in, half* out, std::size_t count) -> void {
+    std::size_t i = 0;
+    // NOLINTBEGIN(cppcoreguidelines-pro-bounds-pointer-arithmetic, cppcoreguidelines-pro-type-reinterpret-cast)
+#if ADMAT_SIMD_AVX512
+    for(; i + 16 <= count; i += 16) {
+        auto packed = _mm512_cvtps_ph(_mm512_loadu_ps(in + i), _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), packed);
+    }
+#endif
+#if ADMAT_SIMD_F16C
+    for(; i + 8 <= count; i += 8) {
+        auto packed = _mm256_cvtps_ph(_mm256_loadu_ps(in + i), _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), packed);
+    }
+#endif
+    for(; i < count; ++i) {
+        out[i] = admat::to_half(in[i]);
+    }
+    // NOLINTEND(cppcoreguidelines-pro-bounds-pointer-arithmetic, cppcoreguidelines-pro-type-reinterpret-cast)
+}
+
+inline auto to_float(const half* in, float* out, std::size_t count) -> void {
+    std::size_t i = 0;
+    // NOLINTBEGIN(cppcoreguidelines-pro-bounds-pointer-arithmetic, cppcoreguidelines-pro-type-reinterpret-cast)
+#if ADMAT_SIMD_AVX512
+    for(; i + 16 <= count; i += 16) {
+        auto packed = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i));
+        _mm512_storeu_ps(out + i, _mm512_cvtph_ps(packed));
+    }
+#endif
+#if ADMAT_SIMD_F16C
+    for(; i + 8 <= count; i += 8) {
+        auto packed = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+        _mm256_storeu_ps(out + i, _mm256_cvtph_ps(packed));
+    }
+#endif
+    for(; i < count; ++i) {
+        out[i] = admat::to_float(in[i]);
+    }
+    // NOLINTEND(cppcoreguidelines-pro-bounds-pointer-arithmetic, cppcoreguidelines-pro-type-reinterpret-cast)
+}
+
+// vec3 is not a multiple of four halves, so each one converts on its own through a 4 lane register
+inline auto to_half(std::span<const vec3> in, std::span<half4> out) -> void {
+    for(std::size_t i = 0; i < in.size(); ++i) {
+#if ADMAT_SIMD_F16C
+        auto packed = _mm_cvtps_ph(set(in[i].x, in[i].y, in[i].z, 0.0f), _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(&out[i]), packed); // NOLINT(*-reinterpret-cast)
+#else
+        out[i] = admat::to_half(in[i]);
+#endif
+    }
+}
+
+inline auto to_float(std::span<const half4> in, std::span<vec3> out) -> void {
+    for(std::size_t i = 0; i < in.size(); ++i) {
+#if ADMAT_SIMD_F16C
+        auto vec = store<vec4>(_mm_cvtph_ps(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(&in[i])))); // NOLINT
+        out[i]   = vec3{vec.w, vec.x, vec.y};
+#else
+        auto vec = admat::to_float(in[i]);
+        out[i]   = vec3{vec.w, vec.x, vec.y};
+#endif
+    }
+}
+
+} // namespace simd
+
+// Span conversions. out must hold at least in.size() elements.
+
+inline auto to_half(std::span<const vec2> in, std::span<half2> out) -> void {
+    assert(out.size() >= in.size());
+    if(!in.empty()) {
+        simd::to_half(&in.data()->x, &out.data()->x, in.size() * 2);
+    }
+}
+
+inline auto to_half(std::span<const vec3> in, std::span<half4> out) -> void {
+    assert(out.size() >= in.size());
+    simd::to_half(in, out);
+}
+
+inline auto to_half(std::span<const vec4> in, std::span<half4> out) -> void {
+    assert(out.size() >= in.size());
+    if(!in.empty()) {
+        simd::to_half(&in.data()->w, &out.data()->w, in.size() * 4);
+    }
+}
+
+inline auto to_float(std::span<const half2> in, std::span<vec2> out) -> void {
+    assert(out.size() >= in.size());
+    if(!in.empty()) {
+        simd::to_float(&in.data()->x, &out.data()->x, in.size() * 2);
+    }
+}
+
+inline auto to_float(std::span<const half4> in, std::span<vec3> out) -> void {
+    assert(out.size() >= in.size());
+    simd::to_float(in, out);
+}
+
+inline auto to_float(std::span<const half4> in, std::span<vec4> out) -> void {
+    assert(out.size() >= in.size());
+    if(!in.empty()) {
+        simd::to_float(&in.data()->w, &out.data()->w, in.size() * 4);
+    }
+}
+
+} // namespace admat
@@ -0,0 +1,200 @@
+#pragma once
+
+#include "admat/executor.hpp"
+#include "admat/mat.hpp"
+#include "admat/soa.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace admat {
+
+// Scene graph transforms. Nodes are kept sorted by depth in contiguous arrays, so every level is one range whose
+// parents all lie in the previous range. world = parent world * local, recomputed only below changed locals.
+class hierarchy {
+public:
+    using node = std::uint32_t;
+
+    static constexpr node no_parent = std::numeric_limits<node>::max();
+
+    hierarchy() = default;
+
+    // parents[i] is the parent of node i, or no_parent for a root. Parents must come before their children.
+    hierarchy(std::span<const node> parents, std::span<const mat4> locals) {
+        assert(parents.size() == locals.size());
+
+        reserve(parents.size());
+        for(std::size_t i = 0; i < parents.size(); ++i) {
+            add(locals[i], parents[i]);
+        }
+    }
+
+    auto reserve(std::size_t count) -> void {
+        parents_.reserve(count);
+        depths_.reserve(count);
+        slots_.reserve(count);
+        parent_slots_.reserve(count);
+        locals_.reserve(count);
+        worlds_.reserve(count);
+        dirty_.reserve(count);
+    }
+
+    // Returns the id of the new node. Ids are handed out in order and stay valid, the storage order is internal.
+    auto add(const mat4& local, node parent = no_parent) -> node {
+        assert(parent == no_parent || parent < parents_.size());
+
+        auto id = static_cast<node>(parents_.size());
+
+        parents_.push_back(parent);
+        depths_.push_back(parent == no_parent ? 0 : depths_[parent] + 1);
+        slots_.push_back(id);
+        parent_slots_.push_back(parent == no_parent ? no_parent : slots_[parent]);
+        locals_.push_back(local);
+        worlds_.push_back(local);
+        dirty_.push_back(1);
+
+        sorted_    = false;
+        any_dirty_ = true;
+        return id;
+    }
+
+    auto set_local(node id, const mat4& local) -> void {
+        assert(id < parents_.size());
+
+        auto slot     = slots_[id];
+        locals_[slot] = local;
+        dirty_[slot]  = 1;
+        any_dirty_    = true;
+    }
+
+    auto local(node id) const -> const mat4& {
+        assert(id < parents_.size());
+        return locals_[slots_[id]];
+    }
+
+    // Up to date as of the last update()
+    auto world(node id) const -> const mat4& {
+        assert(id < parents_.size());
+        return worlds_[slots_[id]];
+    }
+
+    auto parent(node id) const -> node {
+        assert(id < parents_.size());
+        return parents_[id];
+    }
+
+    auto size() const -> std::size_t {
+        return parents_.size();
+    }
+
+    auto update() -> void {
+        update(serial_executor{});
+    }
+
+    // Levels wider than grain are handed to exec, narrower ones run on the calling thread
+    template<typename Executor>
+    auto update(Executor&& exec, std::size_t grain = 1024) -> void {
+        if(!sorted_) {
+            sort();
+        }
+
+        if(!any_dirty_) {
+            return;
+        }
+
+        for(std::size_t level = 0; level + 1 < levels_.size(); ++level) {
+            auto begin = levels_[level];
+            auto count = levels_[level + 1] - begin;
+
+            auto propagate_range = [this, begin](std::size_t first, std::size_t last) {
+                propagate(begin + first, begin + last);
+            };
+
+            parallel_for(exec, count, grain, propagate_range);
+        }
+
+        std::fill(dirty_.begin(), dirty_.end(), std::uint8_t{0});
+        any_dirty_ = false;
+    }
+
+private:
+    // A node is recomputed when its local changed or its parent was recomputed earlier in this update, and then
+    // flags itself for its own children. Writes only touch [first, last), reads of parents only the level above.
+    auto propagate(std::size_t first, std::size_t last) -> void {
+        for(auto slot = first; slot < last; ++slot) {
+            auto parent = parent_slots_[slot];
+
+            if(parent == no_parent) {
+                if(dirty_[slot] != 0) {
+                    worlds_[slot] = locals_[slot];
+                }
+            } else if(dirty_[slot] != 0 || dirty_[parent] != 0) {
+                worlds_[slot] = worlds_[parent] * locals_[slot];
+                dirty_[slot]  = 1;
+            }
+        }
+    }
+
+    // Counting sort of the slots by depth, stable so siblings keep their relative order
+    auto sort() -> void {
+        auto level_count = std::size_t{*std::max_element(depths_.begin(), depths_.end())} + 1;
+
+        levels_.assign(level_count + 1, 0);
+        for(auto depth : depths_) {
+            ++levels_[depth + 1];
+        }
+        for(std::size_t level = 1; level < levels_.size(); ++level) {
+            levels_[level] += levels_[level - 1];
+        }
+
+        auto next         = std::vector<std::size_t>(levels_.begin(), levels_.end() - 1);
+        auto slots        = std::vector<std::uint32_t>(size());
+        auto parent_slots = std::vector<std::uint32_t>(size());
+        auto locals       = aligned_vector<mat4>(size());
+        auto worlds       = aligned_vector<mat4>(size());
+        auto dirty        = std::vector<std::uint8_t>(size());
+
+        for(std::size_t id = 0; id < size(); ++id) {
+            auto slot = static_cast<std::uint32_t>(next[depths_[id]]++);
+            slots[id] = slot;
+
+            // Parents come first, so their new slot is already known
+            parent_slots[slot] = parents_[id] == no_parent ? no_parent : slots[parents_[id]];
+            locals[slot]       = locals_[slots_[id]];
+            worlds[slot]       = worlds_[slots_[id]];
+            dirty[slot]        = dirty_[slots_[id]];
+        }
+
+        slots_        = std::move(slots);
+        parent_slots_ = std::move(parent_slots);
+        locals_       = std::move(locals);
+        worlds_       = std::move(worlds);
+        dirty_        = std::move(dirty);
+        sorted_       = true;
+    }
+
+    // Indexed by node id
+    std::vector<node> parents_;
+    std::vector<std::uint32_t> depths_;
+    std::vector<std::uint32_t> slots_;
+
+    // Indexed by slot
+    std::vector<std::uint32_t> parent_slots_;
+    aligned_vector<mat4> locals_;
+    aligned_vector<mat4> worlds_;
+    std::vector<std::uint8_t> dirty_;
+
+    // Level i occupies slots [levels_[i], levels_[i + 1])
+    std::vector<std::size_t> levels_;
+
+    bool sorted_    = true;
+    bool any_dirty_ = false;
+};
+
+} // namespace admat
@@ -0,0 +1,405 @@
+#pragma once
+
+#include "admat/bounds.hpp"
+#include "admat/simd.hpp"
+#include "admat/soa.hpp"
+#include "admat/vec.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <type_traits>
+
+namespace admat {
+
+// Returned as the distance of anything a ray does not hit
+inline constexpr float miss = std::numeric_limits<float>::infinity();
+
+// Points origin + t * direction for t >= 0. direction does not need to be normalized, t is in units of its length.
+struct ray {
+    vec3 origin;
+    vec3 direction;
+};
+
+static_assert(std::is_standard_layout_v<ray> && std::is_trivial_v<ray>, "ray not pod");
+
+// Barycentric u and v weight the second and third vertex, t is miss when the triangle is not hit
+struct triangle_hit {
+    float t;
+    float u;
+    float v;
+};
+
+// Closest triangle hit, t is miss when nothing is hit before t_max
+struct ray_hit {
+    std::uint32_t triangle;
+    float t;
+    float u;
+    float v;
+};
+
+// Component-wise 1 / direction, for the slab test. Zero components become infinities of the same sign.
+constexpr auto inverse_direction(const ray& r) -> vec3 {
+    return vec3{1.0f / r.direction.x, 1.0f / r.direction.y, 1.0f / r.direction.z};
+}
+
+// Möller-Trumbore, two-sided. Hits at t <= 0 are ignored. A ray parallel to the triangle divides by a zero
+// determinant, the resulting infinities and NaNs fail the range checks instead of needing an epsilon.
+constexpr auto intersect(const ray& r, const vec3& v0, const vec3& v1, const vec3& v2) -> triangle_hit {
+    auto edge1 = v1 - v0;
+    auto edge2 = v2 - v0;
+    auto pvec  = cross(r.direction, edge2);
+    auto rcp   = 1.0f / dot(edge1, pvec);
+
+    auto tvec = r.origin - v0;
+    auto u    = dot(tvec, pvec) * rcp;
+    auto qvec = cross(tvec, edge1);
+    auto v    = dot(r.direction, qvec) * rcp;
+    auto t    = dot(edge2, qvec) * rcp;
+
+    if(u >= 0.0f && v >= 0.0f && u + v <= 1.0f && t > 0.0f) {
+        return triangle_hit{t, u, v};
+    }
+    return triangle_hit{miss, 0.0f, 0.0f};
+}
+
+// Slab test. Returns the distance at which the ray enters box, 0 when it starts inside, or miss when it passes by
+// or only enters after t_max.
+constexpr auto intersect(const vec3& origin, const vec3& inv_direction, const aabb& box, float t_max) -> float {
+    auto t_near = 0.0f;
+    auto t_far  = t_max;
+    auto slab   = [&](float min, float max, float start, float inv) {
+        auto t0 = (min - start) * inv;
+        auto t1 = (max - start) * inv;
+        t_near  = std::max(t_near, std::min(t0, t1));
+        t_far   = std::min(t_far, std::max(t0, t1));
+    };
+
+    slab(box.min.x, box.max.x, origin.x, inv_direction.x);
+    slab(box.min.y, box.max.y, origin.y, inv_direction.y);
+    slab(box.min.z, box.max.z, origin.z, inv_direction.z);
+    return t_near <= t_far ? t_near : miss;
+}
+
+constexpr auto intersect(const ray& r, const aabb& box, float t_max = miss) -> float {
+    return intersect(r.origin, inverse_direction(r), box, t_max);
+}
+
+// Structure of arrays storage for ray
+struct ray_soa {
+    vec3_soa origin;
+    vec3_soa direction;
+
+    ray_soa() = default;
+    explicit ray_soa(std::size_t count) : origin(count), direction(count) {}
+
+    auto size() const -> std::size_t {
+        return origin.size();
+    }
+
+    auto resize(std::size_t count) -> void {
+        origin.resize(count);
+        direction.resize(count);
+    }
+
+    auto push_back(const ray& r) -> void {
+        origin.push_back(r.origin);
+        direction.push_back(r.direction);
+    }
+
+    auto set(std::size_t idx, const ray& r) -> void {
+        origin.set(idx, r.origin);
+        direction.set(idx, r.direction);
+    }
+
+    auto operator[](std::size_t idx) const -> ray {
+        return ray{origin[idx], direction[idx]};
+    }
+};
+
+// Structure of arrays storage for triangles, one vec3_soa per corner
+struct triangle_soa {
+    vec3_soa v0;
+    vec3_soa v1;
+    vec3_soa v2;
+
+    triangle_soa() = default;
+    explicit triangle_soa(std::size_t count) : v0(count), v1(count), v2(count) {}
+
+    // Triangle i is {vertices[indices[3 * i]], vertices[indices[3 * i + 1]], vertices[indices[3 * i + 2]]}
+    static auto from_indexed(std::span<const vec3> vertices, std::span<const std::uint32_t> indices)
+        -> triangle_soa {
+        assert(indices.size() % 3 == 0);
+
+        auto soa = triangle_soa(indices.size() / 3);
+        for(std::size_t i = 0; i < soa.size(); ++i) {
+            soa.set(i, vertices[indices[3 * i]], vertices[indices[3 * i + 1]], vertices[indices[3 * i + 2]]);
+        }
+        return soa;
+    }
+
+    auto size() const -> std::size_t {
+        return v0.size();
+    }
+
+    auto resize(std::size_t count) -> void {
+        v0.resize(count);
+        v1.resize(count);
+        v2.resize(count);
+    }
+
+    auto push_back(const vec3& a, const vec3& b, const vec3& c) -> void {
+        v0.push_back(a);
+        v1.push_back(b);
+        v2.push_back(c);
+    }
+
+    auto set(std::size_t idx, const vec3& a, const vec3& b, const vec3& c) -> void {
+        v0.set(idx, a);
+        v1.set(idx, b);
+        v2.set(idx, c);
+    }
+};
+
+namespace simd {
+
+// x, y and z of a vec3 per lane
+template<typename Reg>
+struct lanes3 {
+    Reg x;
+    Reg y;
+    Reg z;
+};
+
+template<typename Tag>
+inline auto broadcast(Tag tag, const vec3& vec) {
+    return lanes3{broadcast(tag, vec.x), broadcast(tag, vec.y), broadcast(tag, vec.z)};
+}
+
+template<typename Tag>
+inline auto load_lanes(Tag tag, const vec3_soa& vecs, std::size_t i) {
+    return lanes3{load_lanes(tag, &vecs.x[i]), load_lanes(tag, &vecs.y[i]), load_lanes(tag, &vecs.z[i])};
+}
+
+template<typename Reg>
+struct triangle_lanes {
+    Reg t;
+    Reg u;
+    Reg v;
+};
+
+// Möller-Trumbore per lane, the steps of the scalar intersect. The dot products fuse their multiply-adds where the
+// target has FMA, so t, u and v can differ from the scalar ones in the last bits, and a ray grazing an edge can hit in
+// one and miss in the other. Lanes that miss, or hit outside (0, t_max), get t = miss, so the hits are exactly the
+// lanes with t < miss.
+template<typename Tag, typename Reg>
+inline auto intersect(Tag tag,
+                      const lanes3<Reg>& origin,
+                      const lanes3<Reg>& direction,
+                      const lanes3<Reg>& v0,
+                      const lanes3<Reg>& v1,
+                      const lanes3<Reg>& v2,
+                      const Reg& t_max) -> triangle_lanes<Reg> {
+    auto cross3 = [](const lanes3<Reg>& lhs, const lanes3<Reg>& rhs) {
+        return lanes3<Reg>{
+            sub(mul(lhs.y, rhs.z), mul(lhs.z, rhs.y)),
+            sub(mul(lhs.z, rhs.x), mul(lhs.x, rhs.z)),
+            sub(mul(lhs.x, rhs.y), mul(lhs.y, rhs.x)),
+        };
+    };
+    auto dot3 = [](const lanes3<Reg>& lhs, const lanes3<Reg>& rhs) {
+        return fmadd(lhs.z, rhs.z, fmadd(lhs.y, rhs.y, mul(lhs.x, rhs.x)));
+    };
+    auto minus = [](const lanes3<Reg>& lhs, const lanes3<Reg>& rhs) {
+        return lanes3<Reg>{sub(lhs.x, rhs.x), sub(lhs.y, rhs.y), sub(lhs.z, rhs.z)};
+    };
+
+    auto edge1 = minus(v1, v0);
+    auto edge2 = minus(v2, v0);
+    auto pvec  = cross3(direction, edge2);
+    auto rcp   = div(broadcast(tag, 1.0f), dot3(edge1, pvec));
+
+    auto tvec = minus(origin, v0);
+    auto u    = mul(dot3(tvec, pvec), rcp);
+    auto qvec = cross3(tvec, edge1);
+    auto v    = mul(dot3(direction, qvec), rcp);
+    auto t    = mul(dot3(edge2, qvec), rcp);
+
+    // NaN lanes fail the t checks, which only let through 0 < t < t_max
+    auto zero   = broadcast(tag, 0.0f);
+    auto none   = broadcast(tag, miss);
+    auto result = select(less(u, zero), none, t);
+    result      = select(less(v, zero), none, result);
+    result      = select(less(broadcast(tag, 1.0f), add(u, v)), none, result);
+    result      = select(less(zero, result), result, none);
+    result      = select(less(result, t_max), result, none);
+    return triangle_lanes<Reg>{result, u, v};
+}
+
+// Slab test per lane, returns the entry distance or miss. An axis-parallel ray starting on a slab plane makes a NaN
+// distance, which std::min and std::max drop or keep depending on their argument order. The minimum and maximum are
+// built from less and select in the same order, so the results match the scalar test bit for bit on every target,
+// including NEON whose min and max return the NaN.
+template<typename Tag, typename Reg>
+inline auto intersect(Tag tag,
+                      const lanes3<Reg>& origin,
+                      const lanes3<Reg>& inv_direction,
+                      const lanes3<Reg>& min,
+                      const lanes3<Reg>& max,
+                      const Reg& t_max) -> Reg {
+    auto t_near = broadcast(tag, 0.0f);
+    auto t_far  = t_max;
+    auto slab   = [&](const Reg& low, const Reg& high, const Reg& start, const Reg& inv) {
+        auto t0 = mul(sub(low, start), inv);
+        auto t1 = mul(sub(high, start), inv);
+
+        // std::min(t0, t1), std::max(t0, t1), then std::max(t_near, ...) and std::min(t_far, ...)
+        auto entry = select(less(t1, t0), t1, t0);
+        auto exit  = select(less(t0, t1), t1, t0);
+        t_near     = select(less(t_near, entry), entry, t_near);
+        t_far      = select(less(exit, t_far), exit, t_far);
+    };
+
+    slab(min.x, max.x, origin.x, inv_direction.x);
+    slab(min.y, max.y, origin.y, inv_direction.y);
+    slab(min.z, max.z, origin.z, inv_direction.z);
+    return select(less(t_far, t_near), broadcast(tag, miss), t_near);
+}
+
+template<typename Tag, typename Reg>
+inline auto inverse_direction(Tag tag, const lanes3<Reg>& direction) -> lanes3<Reg> {
+    auto one = broadcast(tag, 1.0f);
+    return lanes3<Reg>{div(one, direction.x), div(one, direction.y), div(one, direction.z)};
+}
+
+} // namespace simd
+
+// Packet versions of the tests above, either one ray against many triangles or boxes, or many rays against one.
+// Element i writes t[i], its hit distance or miss, and bit i % 64 of hits[i / 64], set when t[i] < miss. t needs
+// one float per element and hits one word per 64 elements, both are overwritten over the elements.
+
+inline auto intersect(const ray& r,
+                      const triangle_soa& triangles,
+                      std::span<std::uint64_t> hits,
+                      std::span<float> t,
+                      float t_max = miss) -> void {
+    assert(hits.size() * 64 >= triangles.size() && t.size() >= triangles.size());
+
+    simd::for_each_block(triangles.size(), [&](std::size_t i, auto tag) {
+        auto hit = simd::intersect(tag,
+                                   simd::broadcast(tag, r.origin),
+                                   simd::broadcast(tag, r.direction),
+                                   simd::load_lanes(tag, triangles.v0, i),
+                                   simd::load_lanes(tag, triangles.v1, i),
+                                   simd::load_lanes(tag, triangles.v2, i),
+                                   simd::broadcast(tag, t_max));
+        simd::store_lanes(&t[i], hit.t);
+        simd::store_bits(tag, hits, i, simd::bitmask(simd::less(hit.t, simd::broadcast(tag, miss))));
+    });
+}
+
+// Nearest of the hits of r against every triangle, triangle is the index in triangles
+inline auto closest_hit(const ray& r, const triangle_soa& triangles, float t_max = miss) -> ray_hit {
+    auto result = ray_hit{0, t_max, 0.0f, 0.0f};
+
+    simd::for_each_block(triangles.size(), [&](std::size_t i, auto tag) {
+        auto hit = simd::intersect(tag,
+                                   simd::broadcast(tag, r.origin),
+                                   simd::broadcast(tag, r.direction),
+                                   simd::load_lanes(tag, triangles.v0, i),
+                                   simd::load_lanes(tag, triangles.v1, i),
+                                   simd::load_lanes(tag, triangles.v2, i),
+                                   simd::broadcast(tag, result.t));
+
+        // Hits are rare, only blocks with one are spilled and scanned lane by lane
+        auto mask = simd::bitmask(simd::less(hit.t, simd::broadcast(tag, miss)));
+        if(mask == 0) {
+            return;
+        }
+
+        auto lane_t = std::array<float, simd::wide_width>{};
+        auto lane_u = std::array<float, simd::wide_width>{};
+        auto lane_v = std::array<float, simd::wide_width>{};
+        simd::store_lanes(lane_t.data(), hit.t);
+        simd::store_lanes(lane_u.data(), hit.u);
+        simd::store_lanes(lane_v.data(), hit.v);
+        for(std::size_t lane = 0; lane < simd::lane_count(tag); ++lane) {
+            if(lane_t[lane] < result.t) {
+                result = ray_hit{static_cast<std::uint32_t>(i + lane), lane_t[lane], lane_u[lane], lane_v[lane]};
+            }
+        }
+    });
+
+    if(!(result.t < t_max)) {
+        result.t = miss;
+    }
+    return result;
+}
+
+inline auto intersect(const ray_soa& rays,
+                      const vec3& v0,
+                      const vec3& v1,
+                      const vec3& v2,
+                      std::span<std::uint64_t> hits,
+                      std::span<float> t,
+                      float t_max = miss) -> void {
+    assert(hits.size() * 64 >= rays.size() && t.size() >= rays.size());
+
+    simd::for_each_block(rays.size(), [&](std::size_t i, auto tag) {
+        auto hit = simd::intersect(tag,
+                                   simd::load_lanes(tag, rays.origin, i),
+                                   simd::load_lanes(tag, rays.direction, i),
+                                   simd::broadcast(tag, v0),
+                                   simd::broadcast(tag, v1),
+                                   simd::broadcast(tag, v2),
+                                   simd::broadcast(tag, t_max));
+        simd::store_lanes(&t[i], hit.t);
+        simd::store_bits(tag, hits, i, simd::bitmask(simd::less(hit.t, simd::broadcast(tag, miss))));
+    });
+}
+
+// t[i] is where r enters box i, 0 when it starts inside
+inline auto intersect(const ray& r,
+                      const aabb_soa& boxes,
+                      std::span<std::uint64_t> hits,
+                      std::span<float> t,
+                      float t_max = miss) -> void {
+    assert(hits.size() * 64 >= boxes.size() && t.size() >= boxes.size());
+
+    auto inv = inverse_direction(r);
+    simd::for_each_block(boxes.size(), [&](std::size_t i, auto tag) {
+        auto entry = simd::intersect(tag,
+                                     simd::broadcast(tag, r.origin),
+                                     simd::broadcast(tag, inv),
+                                     simd::load_lanes(tag, boxes.min, i),
+                                     simd::load_lanes(tag, boxes.max, i),
+                                     simd::broadcast(tag, t_max));
+        simd::store_lanes(&t[i], entry);
+        simd::store_bits(tag, hits, i, simd::bitmask(simd::less(entry, simd::broadcast(tag, miss))));
+    });
+}
+
+inline auto intersect(const ray_soa& rays,
+                      const aabb& box,
+                      std::span<std::uint64_t> hits,
+                      std::span<float> t,
+                      float t_max = miss) -> void {
+    assert(hits.size() * 64 >= rays.size() && t.size() >= rays.size());
+
+    simd::for_each_block(rays.size(), [&](std::size_t i, auto tag) {
+        auto entry = simd::intersect(tag,
+                                     simd::load_lanes(tag, rays.origin, i),
+                                     simd::inverse_direction(tag, simd::load_lanes(tag, rays.direction, i)),
+                                     simd::broadcast(tag, box.min),
+                                     simd::broadcast(tag, box.max),
+                                     simd::broadcast(tag, t_max));
+        simd::store_lanes(&t[i], entry);
+        simd::store_bits(tag, hits, i, simd::bitmask(simd::less(entry, simd::broadcast(tag, miss))));
+    });
+}
+
+} // namespace admat
@@ -2,105 +2,443 @@
 
 #include "admat/vec.hpp"
 
+#include <array>
 #include <cassert>
+#include <concepts>
 #include <cstddef>
 #include <numbers>
+#include <type_traits>
 
 namespace admat {
 
-struct mat4 {
-    vec4 w;
-    vec4 x;
-    vec4 y;
-    vec4 z;
-
-    constexpr mat4() = default;
-    constexpr mat4(const vec4& r1, const vec4& r2, const vec4& r3, const vec4& r4) : w{}, x{}, y{}, z{} {
-        w = {r1.w, r2.w, r3.w, r4.w};
-        x = {r1.x, r2.x, r3.x, r4.x};
-        y = {r1.y, r2.y, r3.y, r4.y};
-        z = {r1.z, r2.z, r3.z, r4.z};
+// Column storage of mat<T, R, C>, the columns named like the components of a C component vec
+template<typename T, std::size_t R, std::size_t C>
+struct mat_columns;
+
+template<typename T, std::size_t R>
+struct mat_columns<T, R, 2> {
+    vec<T, R> x;
+    vec<T, R> y;
+
+    constexpr auto column(std::size_t idx) const -> const vec<T, R>& {
+        assert(idx < 2);
+        if(std::is_constant_evaluated()) {
+            return idx == 0 ? x : y;
+        }
+        return *(&x + idx); // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
     }
 
-    constexpr auto operator[](std::size_t row, std::size_t col) const -> float {
-        assert(row < 4 && col < 4);
+    constexpr auto column(std::size_t idx) -> vec<T, R>& {
+        assert(idx < 2);
+        if(std::is_constant_evaluated()) {
+            return idx == 0 ? x : y;
+        }
+        return *(&x + idx); // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    }
+};
 
-        std::size_t index = col * 4 + row;
-        return *(&(w.w) + index); // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+template<typename T, std::size_t R>
+struct mat_columns<T, R, 3> {
+    vec<T, R> x;
+    vec<T, R> y;
+    vec<T, R> z;
+
+    constexpr auto column(std::size_t idx) const -> const vec<T, R>& {
+        assert(idx < 3);
+        if(std::is_constant_evaluated()) {
+            return idx == 0 ? x : idx == 1 ? y : z;
+        }
+        return *(&x + idx); // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
     }
 
-    static constexpr auto from_cols(const vec4& c1, const vec4& c2, const vec4& c3, const vec4& c4) -> mat4 {
-        return mat4{
-            {c1.w, c2.w, c3.w, c4.w},
-            {c1.x, c2.x, c3.x, c4.x},
-            {c1.y, c2.y, c3.y, c4.y},
-            {c1.z, c2.z, c3.z, c4.z},
-        };
+    constexpr auto column(std::size_t idx) -> vec<T, R>& {
+        assert(idx < 3);
+        if(std::is_constant_evaluated()) {
+            return idx == 0 ? x : idx == 1 ? y : z;
+        }
+        return *(&x + idx); // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
     }
+};
 
-    static consteval auto identity() -> mat4 {
-        return mat4{
-            {1, 0, 0, 0},
-            {0, 1, 0, 0},
-            {0, 0, 1, 0},
-            {0, 0, 0, 1},
-        };
+template<typename T, std::size_t R>
+struct mat_columns<T, R, 4> {
+    vec<T, R> w;
+    vec<T, R> x;
+    vec<T, R> y;
+    vec<T, R> z;
+
+    constexpr auto column(std::size_t idx) const -> const vec<T, R>& {
+        assert(idx < 4);
+        if(std::is_constant_evaluated()) {
+            return idx == 0 ? w : idx == 1 ? x : idx == 2 ? y : z;
+        }
+        return *(&w + idx); // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    }
+
+    constexpr auto column(std::size_t idx) -> vec<T, R>& {
+        assert(idx < 4);
+        if(std::is_constant_evaluated()) {
+            return idx == 0 ? w : idx == 1 ? x : idx == 2 ? y : z;
+        }
+        return *(&w + idx); // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
     }
 };
 
+// R rows by C columns of T, stored column major. Constructors take rows, so the braces read like the matrix.
+template<typename T, std::size_t R, std::size_t C>
+struct mat : mat_columns<T, R, C> {
+    using column_type = vec<T, R>;
+    using row_type    = vec<T, C>;
+
+    constexpr mat() = default;
+
+    constexpr mat(const row_type& r1, const row_type& r2)
+        requires(R == 2)
+        : mat_columns<T, R, C>{} {
+        set_rows({r1, r2});
+    }
+
+    constexpr mat(const row_type& r1, const row_type& r2, const row_type& r3)
+        requires(R == 3)
+        : mat_columns<T, R, C>{} {
+        set_rows({r1, r2, r3});
+    }
+
+    constexpr mat(const row_type& r1, const row_type& r2, const row_type& r3, const row_type& r4)
+        requires(R == 4)
+        : mat_columns<T, R, C>{} {
+        set_rows({r1, r2, r3, r4});
+    }
+
+    constexpr auto operator[](std::size_t row_idx, std::size_t col_idx) const -> T {
+        assert(row_idx < R && col_idx < C);
+        return this->column(col_idx)[row_idx];
+    }
+
+    constexpr auto row(std::size_t idx) const -> row_type {
+        return make_vec<T, C>([&](std::size_t col_idx) { return this->column(col_idx)[idx]; });
+    }
+
+    template<std::same_as<column_type>... Cols>
+        requires(sizeof...(Cols) == C)
+    static constexpr auto from_cols(const Cols&... cols) -> mat {
+        auto result = mat{};
+        auto idx    = std::size_t{0};
+        ((result.column(idx++) = cols), ...);
+        return result;
+    }
+
+    static constexpr auto from_row_major(const std::array<T, R * C>& data) -> mat {
+        auto result = mat{};
+        for(std::size_t row_idx = 0; row_idx < R; ++row_idx) {
+            for(std::size_t col_idx = 0; col_idx < C; ++col_idx) {
+                result.column(col_idx)[row_idx] = data.at(row_idx * C + col_idx);
+            }
+        }
+        return result;
+    }
+
+    static consteval auto identity() -> mat
+        requires(R == C)
+    {
+        auto result = mat{};
+        for(std::size_t idx = 0; idx < R; ++idx) {
+            result.column(idx)[idx] = T{1};
+        }
+        return result;
+    }
+
+private:
+    constexpr auto set_rows(const std::array<row_type, R>& rows) -> void {
+        for(std::size_t row_idx = 0; row_idx < R; ++row_idx) {
+            for(std::size_t col_idx = 0; col_idx < C; ++col_idx) {
+                this->column(col_idx)[row_idx] = rows[row_idx][col_idx];
+            }
+        }
+    }
+};
+
+using mat2 = mat<float, 2, 2>;
+using mat3 = mat<float, 3, 3>;
+using mat4 = mat<float, 4, 4>;
+
+using dmat2 = mat<double, 2, 2>;
+using dmat3 = mat<double, 3, 3>;
+using dmat4 = mat<double, 4, 4>;
+
 static_assert(std::is_standard_layout_v<mat4> && std::is_trivial_v<mat4>, "mat4 not pod");
+static_assert(sizeof(mat3) == 9 * sizeof(float) && sizeof(mat<double, 2, 3>) == 6 * sizeof(double), "mat is padded");
 
-constexpr auto operator+(const mat4& lhs, const mat4& rhs) -> mat4 {
-    return mat4{
-        lhs.w + rhs.w,
-        lhs.x + rhs.x,
-        lhs.y + rhs.y,
-        lhs.z + rhs.z,
-    };
-}
+// The templates below serve every shape and type column by column. The mat4 kernels further down keep their hand
+// written SIMD versions as non-template overloads, which overload resolution picks over these.
 
-constexpr auto operator-(const mat4& lhs, const mat4& rhs) -> mat4 {
-    return mat4{
-        lhs.w - rhs.w,
-        lhs.x - rhs.x,
-        lhs.y - rhs.y,
-        lhs.z - rhs.z,
-    };
+template<typename T, std::size_t R, std::size_t C>
+constexpr auto operator+(const mat<T, R, C>& lhs, const mat<T, R, C>& rhs) -> mat<T, R, C> {
+    auto result = mat<T, R, C>{};
+    for(std::size_t idx = 0; idx < C; ++idx) {
+        result.column(idx) = lhs.column(idx) + rhs.column(idx);
+    }
+    return result;
 }
 
-constexpr auto operator*(const mat4& lhs, const mat4& rhs) -> mat4 {
-    return mat4::from_cols({lhs.w * rhs.w.w + lhs.x * rhs.w.x + lhs.y * rhs.w.y + lhs.z * rhs.w.z},
-                           {lhs.w * rhs.x.w + lhs.x * rhs.x.x + lhs.y * rhs.x.y + lhs.z * rhs.x.z},
-                           {lhs.w * rhs.y.w + lhs.x * rhs.y.x + lhs.y * rhs.y.y + lhs.z * rhs.y.z},
-                           {lhs.w * rhs.z.w + lhs.x * rhs.z.x + lhs.y * rhs.z.y + lhs.z * rhs.z.z});
+template<typename T, std::size_t R, std::size_t C>
+constexpr auto operator-(const mat<T, R, C>& lhs, const mat<T, R, C>& rhs) -> mat<T, R, C> {
+    auto result = mat<T, R, C>{};
+    for(std::size_t idx = 0; idx < C; ++idx) {
+        result.column(idx) = lhs.column(idx) - rhs.column(idx);
+    }
+    return result;
 }
 
-constexpr auto operator*(const mat4& lhs, float scalar) -> mat4 {
-    return mat4::from_cols(lhs.w * scalar, lhs.x * scalar, lhs.y * scalar, lhs.z * scalar);
+template<typename T, std::size_t R, std::size_t C>
+constexpr auto operator*(const mat<T, R, C>& lhs, std::type_identity_t<T> scalar) -> mat<T, R, C> {
+    auto result = mat<T, R, C>{};
+    for(std::size_t idx = 0; idx < C; ++idx) {
+        result.column(idx) = lhs.column(idx) * scalar;
+    }
+    return result;
 }
 
-constexpr auto operator*(float scalar, mat4 rhs) -> mat4 {
+template<typename T, std::size_t R, std::size_t C>
+constexpr auto operator*(std::type_identity_t<T> scalar, const mat<T, R, C>& rhs) -> mat<T, R, C> {
     return rhs * scalar;
 }
 
+// Column vector transform
+template<typename T, std::size_t R, std::size_t C>
+constexpr auto operator*(const mat<T, R, C>& lhs, const vec<T, C>& rhs) -> vec<T, R> {
+    auto result = lhs.column(0) * rhs[0];
+    for(std::size_t idx = 1; idx < C; ++idx) {
+        result = result + lhs.column(idx) * rhs[idx];
+    }
+    return result;
+}
+
+// Row vector transform, equivalent to transpose(mat) * vec
+template<typename T, std::size_t R, std::size_t C>
+constexpr auto operator*(const vec<T, R>& lhs, const mat<T, R, C>& rhs) -> vec<T, C> {
+    return make_vec<T, C>([&](std::size_t idx) { return dot(lhs, rhs.column(idx)); });
+}
+
+template<typename T, std::size_t R, std::size_t K, std::size_t C>
+constexpr auto operator*(const mat<T, R, K>& lhs, const mat<T, K, C>& rhs) -> mat<T, R, C> {
+    auto result = mat<T, R, C>{};
+    for(std::size_t idx = 0; idx < C; ++idx) {
+        result.column(idx) = lhs * rhs.column(idx);
+    }
+    return result;
+}
+
+template<typename T, std::size_t R, std::size_t C>
+constexpr auto transpose(const mat<T, R, C>& matrix) -> mat<T, C, R> {
+    auto result = mat<T, C, R>{};
+    for(std::size_t idx = 0; idx < R; ++idx) {
+        result.column(idx) = matrix.row(idx);
+    }
+    return result;
+}
+
+// Transposed cofactor matrix, so inverse(matrix) = adjugate / determinant
+template<typename T, std::size_t N>
+constexpr auto adjugate(const mat<T, N, N>& matrix) -> mat<T, N, N> {
+    const auto& m = matrix;
+    if constexpr(N == 2) {
+        return mat<T, 2, 2>{
+            {m[1, 1], -m[0, 1]},
+            {-m[1, 0], m[0, 0]},
+        };
+    } else if constexpr(N == 3) {
+        // Rows of the adjugate are the cross products of pairs of columns
+        return mat<T, 3, 3>{
+            cross(m.y, m.z),
+            cross(m.z, m.x),
+            cross(m.x, m.y),
+        };
+    } else {
+        static_assert(N == 4, "adjugate is implemented up to 4x4");
+
+        auto A2323 = m[2, 2] * m[3, 3] - m[2, 3] * m[3, 2];
+        auto A1323 = m[2, 1] * m[3, 3] - m[2, 3] * m[3, 1];
+        auto A1223 = m[2, 1] * m[3, 2] - m[2, 2] * m[3, 1];
+        auto A0323 = m[2, 0] * m[3, 3] - m[2, 3] * m[3, 0];
+        auto A0223 = m[2, 0] * m[3, 2] - m[2, 2] * m[3, 0];
+        auto A0123 = m[2, 0] * m[3, 1] - m[2, 1] * m[3, 0];
+        auto A2313 = m[1, 2] * m[3, 3] - m[1, 3] * m[3, 2];
+        auto A1313 = m[1, 1] * m[3, 3] - m[1, 3] * m[3, 1];
+        auto A1213 = m[1, 1] * m[3, 2] - m[1, 2] * m[3, 1];
+        auto A2312 = m[1, 2] * m[2, 3] - m[1, 3] * m[2, 2];
+        auto A1312 = m[1, 1] * m[2, 3] - m[1, 3] * m[2, 1];
+        auto A1212 = m[1, 1] * m[2, 2] - m[1, 2] * m[2, 1];
+        auto A0313 = m[1, 0] * m[3, 3] - m[1, 3] * m[3, 0];
+        auto A0213 = m[1, 0] * m[3, 2] - m[1, 2] * m[3, 0];
+        auto A0312 = m[1, 0] * m[2, 3] - m[1, 3] * m[2, 0];
+        auto A0212 = m[1, 0] * m[2, 2] - m[1, 2] * m[2, 0];
+        auto A0113 = m[1, 0] * m[3, 1] - m[1, 1] * m[3, 0];
+        auto A0112 = m[1, 0] * m[2, 1] - m[1, 1] * m[2, 0];
+
+        return mat<T, 4, 4>{
+            {
+                (m[1, 1] * A2323 - m[1, 2] * A1323 + m[1, 3] * A1223),
+                -(m[0, 1] * A2323 - m[0, 2] * A1323 + m[0, 3] * A1223),
+                (m[0, 1] * A2313 - m[0, 2] * A1313 + m[0, 3] * A1213),
+                -(m[0, 1] * A2312 - m[0, 2] * A1312 + m[0, 3] * A1212),
+            },
+            {
+                -(m[1, 0] * A2323 - m[1, 2] * A0323 + m[1, 3] * A0223),
+                (m[0, 0] * A2323 - m[0, 2] * A0323 + m[0, 3] * A0223),
+                -(m[0, 0] * A2313 - m[0, 2] * A0313 + m[0, 3] * A0213),
+                (m[0, 0] * A2312 - m[0, 2] * A0312 + m[0, 3] * A0212),
+            },
+            {
+                (m[1, 0] * A1323 - m[1, 1] * A0323 + m[1, 3] * A0123),
+                -(m[0, 0] * A1323 - m[0, 1] * A0323 + m[0, 3] * A0123),
+                (m[0, 0] * A1313 - m[0, 1] * A0313 + m[0, 3] * A0113),
+                -(m[0, 0] * A1312 - m[0, 1] * A0312 + m[0, 3] * A0112),
+            },
+            {
+                -(m[1, 0] * A1223 - m[1, 1] * A0223 + m[1, 2] * A0123),
+                (m[0, 0] * A1223 - m[0, 1] * A0223 + m[0, 2] * A0123),
+                -(m[0, 0] * A1213 - m[0, 1] * A0213 + m[0, 2] * A0113),
+                (m[0, 0] * A1212 - m[0, 1] * A0212 + m[0, 2] * A0112),
+            },
+        };
+    }
+}
+
+template<typename T, std::size_t N>
+constexpr auto determinant(const mat<T, N, N>& matrix) -> T {
+    const auto& m = matrix;
+    if constexpr(N == 2) {
+        return m[0, 0] * m[1, 1] - m[0, 1] * m[1, 0];
+    } else if constexpr(N == 3) {
+        return dot(m.x, cross(m.y, m.z));
+    } else {
+        static_assert(N == 4, "determinant is implemented up to 4x4");
+
+        auto sub_00 = m[2, 2] * m[3, 3] - m[3, 2] * m[2, 3];
+        auto sub_01 = m[2, 1] * m[3, 3] - m[3, 1] * m[2, 3];
+        auto sub_02 = m[2, 1] * m[3, 2] - m[3, 1] * m[2, 2];
+        auto sub_03 = m[2, 0] * m[3, 3] - m[3, 0] * m[2, 3];
+        auto sub_04 = m[2, 0] * m[3, 2] - m[3, 0] * m[2, 2];
+        auto sub_05 = m[2, 0] * m[3, 1] - m[3, 0] * m[2, 1];
+
+        auto coeff = vec<T, 4>{
+            +(m[1, 1] * sub_00 - m[1, 2] * sub_01 + m[1, 3] * sub_02),
+            -(m[1, 0] * sub_00 - m[1, 2] * sub_03 + m[1, 3] * sub_04),
+            +(m[1, 0] * sub_01 - m[1, 1] * sub_03 + m[1, 3] * sub_05),
+            -(m[1, 0] * sub_02 - m[1, 1] * sub_04 + m[1, 2] * sub_05),
+        };
+
+        return m[0, 0] * coeff.w + m[0, 1] * coeff.x + m[0, 2] * coeff.y + m[0, 3] * coeff.z;
+    }
+}
+
+template<typename T, std::size_t N>
+constexpr auto inverse(const mat<T, N, N>& matrix) -> mat<T, N, N> {
+    auto adj = adjugate(matrix);
+
+    // First row of the adjugate holds the cofactors of the first column
+    auto det = dot(adj.row(0), matrix.column(0));
+    return adj * (T{1} / det);
+}
+
+namespace simd {
+
+// Linear combination of the columns of mat weighted by the lanes of vec, i.e. mat * vec
+inline auto transform(const f32x4& c0, const f32x4& c1, const f32x4& c2, const f32x4& c3, const vec4& vec) -> f32x4 {
+    auto result = mul(c0, broadcast(vec.w));
+    result      = fmadd(c1, broadcast(vec.x), result);
+    result      = fmadd(c2, broadcast(vec.y), result);
+    return fmadd(c3, broadcast(vec.z), result);
+}
+
+} // namespace simd
+
+constexpr auto operator*(const mat4& lhs, const mat4& rhs) -> mat4 {
+    if(!std::is_constant_evaluated()) {
+        auto c0 = simd::load(lhs.w);
+        auto c1 = simd::load(lhs.x);
+        auto c2 = simd::load(lhs.y);
+        auto c3 = simd::load(lhs.z);
+
+        auto result = mat4{};
+        result.w    = simd::store<vec4>(simd::transform(c0, c1, c2, c3, rhs.w));
+        result.x    = simd::store<vec4>(simd::transform(c0, c1, c2, c3, rhs.x));
+        result.y    = simd::store<vec4>(simd::transform(c0, c1, c2, c3, rhs.y));
+        result.z    = simd::store<vec4>(simd::transform(c0, c1, c2, c3, rhs.z));
+        return result;
+    }
+
+    auto result = mat4{};
+    result.w    = lhs.w * rhs.w.w + lhs.x * rhs.w.x + lhs.y * rhs.w.y + lhs.z * rhs.w.z;
+    result.x    = lhs.w * rhs.x.w + lhs.x * rhs.x.x + lhs.y * rhs.x.y + lhs.z * rhs.x.z;
+    result.y    = lhs.w * rhs.y.w + lhs.x * rhs.y.x + lhs.y * rhs.y.y + lhs.z * rhs.y.z;
+    result.z    = lhs.w * rhs.z.w + lhs.x * rhs.z.x + lhs.y * rhs.z.y + lhs.z * rhs.z.z;
+    return result;
+}
+
+// Column vector transform
 constexpr auto operator*(const mat4& mat, const vec4& vec) -> vec4 {
+    if(!std::is_constant_evaluated()) {
+        return simd::store<vec4>(
+            simd::transform(simd::load(mat.w), simd::load(mat.x), simd::load(mat.y), simd::load(mat.z), vec));
+    }
+
+    return mat.w * vec.w + mat.x * vec.x + mat.y * vec.y + mat.z * vec.z;
+}
+
+// Row vector transform, equivalent to transpose(mat) * vec
+constexpr auto operator*(const vec4& vec, const mat4& mat) -> vec4 {
     return vec4{
-        dot(mat.w, vec),
-        dot(mat.x, vec),
-        dot(mat.y, vec),
-        dot(mat.z, vec),
+        dot(vec, mat.w),
+        dot(vec, mat.x),
+        dot(vec, mat.y),
+        dot(vec, mat.z),
     };
 }
 
-constexpr auto operator*(const vec4& vec, const mat4& mat) -> vec4 {
-    return mat * vec;
+namespace simd {
+
+inline auto transform(const f64x4& c0, const f64x4& c1, const f64x4& c2, const f64x4& c3, const dvec4& vec) -> f64x4 {
+    auto result = mul(c0, broadcast_f64(vec.w));
+    result      = fmadd(c1, broadcast_f64(vec.x), result);
+    result      = fmadd(c2, broadcast_f64(vec.y), result);
+    return fmadd(c3, broadcast_f64(vec.z), result);
 }
 
-constexpr auto rotation(const vec3& axis, float radians) -> mat4 {
-    auto ax  = normalize(axis);
-    auto sin = std::sin(radians);
-    auto cos = std::cos(radians);
+} // namespace simd
+
+constexpr auto operator*(const dmat4& lhs, const dmat4& rhs) -> dmat4 {
+    if(!std::is_constant_evaluated()) {
+        auto c0 = simd::load_f64(lhs.w);
+        auto c1 = simd::load_f64(lhs.x);
+        auto c2 = simd::load_f64(lhs.y);
+        auto c3 = simd::load_f64(lhs.z);
+
+        auto result = dmat4{};
+        result.w    = simd::store_f64<dvec4>(simd::transform(c0, c1, c2, c3, rhs.w));
+        result.x    = simd::store_f64<dvec4>(simd::transform(c0, c1, c2, c3, rhs.x));
+        result.y    = simd::store_f64<dvec4>(simd::transform(c0, c1, c2, c3, rhs.y));
+        result.z    = simd::store_f64<dvec4>(simd::transform(c0, c1, c2, c3, rhs.z));
+        return result;
+    }
 
+    return operator*<double, 4, 4, 4>(lhs, rhs);
+}
+
+constexpr auto operator*(const dmat4& mat, const dvec4& vec) -> dvec4 {
+    if(!std::is_constant_evaluated()) {
+        return simd::store_f64<dvec4>(simd::transform(
+            simd::load_f64(mat.w), simd::load_f64(mat.x), simd::load_f64(mat.y), simd::load_f64(mat.z), vec));
+    }
+
+    return operator*<double, 4, 4>(mat, vec);
+}
+
+namespace detail {
+
+// Rotation about a unit axis by the angle whose sine and cosine are given, shared with the fast:: versions
+constexpr auto rotation_from(const vec3& ax, float sin, float cos) -> mat4 {
     return mat4{
         {cos + (ax.x * ax.x) * (1 - cos),
          ax.x * ax.y * (1 - cos) - (ax.z * sin),
@@ -118,74 +456,212 @@ constexpr auto rotation(const vec3& axis, float radians) -> mat4 {
     };
 }
 
-constexpr auto determinant(const mat4& mat) -> float {
-    float sub_00 = mat[2, 2] * mat[3, 3] - mat[3, 2] * mat[2, 3];
-    float sub_01 = mat[2, 1] * mat[3, 3] - mat[3, 1] * mat[2, 3];
-    float sub_02 = mat[2, 1] * mat[3, 2] - mat[3, 1] * mat[2, 2];
-    float sub_03 = mat[2, 0] * mat[3, 3] - mat[3, 0] * mat[2, 3];
-    float sub_04 = mat[2, 0] * mat[3, 2] - mat[3, 0] * mat[2, 2];
-    float sub_05 = mat[2, 0] * mat[3, 1] - mat[3, 0] * mat[2, 1];
-
-    auto coeff = vec4{
-        +(mat[1, 1] * sub_00 - mat[1, 2] * sub_01 + mat[1, 3] * sub_02),
-        -(mat[1, 0] * sub_00 - mat[1, 2] * sub_03 + mat[1, 3] * sub_04),
-        +(mat[1, 0] * sub_01 - mat[1, 1] * sub_03 + mat[1, 3] * sub_05),
-        -(mat[1, 0] * sub_02 - mat[1, 1] * sub_04 + mat[1, 2] * sub_05),
+} // namespace detail
+
+constexpr auto rotation(const vec3& axis, float radians) -> mat4 {
+    return detail::rotation_from(normalize(axis), std::sin(radians), std::cos(radians));
+}
+
+// Rotation about x by radians.x, then y by radians.y, then z by radians.z, so rz * ry * rx
+constexpr auto euler_rotation(const vec3& radians) -> mat4 {
+    auto sx = std::sin(radians.x);
+    auto cx = std::cos(radians.x);
+    auto sy = std::sin(radians.y);
+    auto cy = std::cos(radians.y);
+    auto sz = std::sin(radians.z);
+    auto cz = std::cos(radians.z);
+
+    return mat4{
+        {cy * cz, sx * sy * cz - cx * sz, cx * sy * cz + sx * sz, 0.0f},
+        {cy * sz, sx * sy * sz + cx * cz, cx * sy * sz - sx * cz, 0.0f},
+        {-sy, sx * cy, cx * cy, 0.0f},
+        {0.0f, 0.0f, 0.0f, 1.0f},
     };
+}
 
-    return mat[0, 0] * coeff.w + mat[0, 1] * coeff.x + mat[0, 2] * coeff.y + mat[0, 3] * coeff.z;
+// Camera style angles for y up and -z forward, like look_at: roll about z, then pitch about x, then yaw about y, so
+// ry * rx * rz
+constexpr auto yaw_pitch_roll_rotation(float yaw, float pitch, float roll) -> mat4 {
+    auto sy = std::sin(yaw);
+    auto cy = std::cos(yaw);
+    auto sp = std::sin(pitch);
+    auto cp = std::cos(pitch);
+    auto sr = std::sin(roll);
+    auto cr = std::cos(roll);
+
+    return mat4{
+        {cy * cr + sy * sp * sr, sy * sp * cr - cy * sr, sy * cp, 0.0f},
+        {cp * sr, cp * cr, -sp, 0.0f},
+        {cy * sp * sr - sy * cr, sy * sr + cy * sp * cr, cy * cp, 0.0f},
+        {0.0f, 0.0f, 0.0f, 1.0f},
+    };
+}
+
+namespace simd {
+
+// 2x2 minors of rows a and b over the last three columns, indexed [row][col]:
+// {m[a][2] * m[b][3] - m[a][3] * m[b][2], (same),
+//  m[a][1] * m[b][3] - m[a][3] * m[b][1], m[a][1] * m[b][2] - m[a][2] * m[b][1]}
+template<int a, int b>
+inline auto minors(const f32x4& c1, const f32x4& c2, const f32x4& c3) -> f32x4 {
+    auto near_a = shuffle<a, a, a, a>(c2, c1);
+    auto near_b = shuffle<b, b, b, b>(c2, c1);
+    auto far_a  = shuffle<0, 0, 0, 2>(shuffle<a, a, a, a>(c3, c2));
+    auto far_b  = shuffle<0, 0, 0, 2>(shuffle<b, b, b, b>(c3, c2));
+    return sub(mul(near_a, far_b), mul(far_a, near_b));
+}
+
+// Columns of the adjugate (transposed cofactor matrix), so inverse(mat) = adjugate / determinant.
+// Each of the 18 distinct 2x2 minors is computed once, four at a time.
+inline auto adjugate(const mat4& mat) -> f32x4x4 {
+    auto c0 = load(mat.w);
+    auto c1 = load(mat.x);
+    auto c2 = load(mat.y);
+    auto c3 = load(mat.z);
+
+    auto fac0 = minors<2, 3>(c1, c2, c3);
+    auto fac1 = minors<1, 3>(c1, c2, c3);
+    auto fac2 = minors<1, 2>(c1, c2, c3);
+    auto fac3 = minors<0, 3>(c1, c2, c3);
+    auto fac4 = minors<0, 2>(c1, c2, c3);
+    auto fac5 = minors<0, 1>(c1, c2, c3);
+
+    // {m[k][1], m[k][0], m[k][0], m[k][0]}
+    auto row0 = shuffle<0, 2, 2, 2>(shuffle<0, 0, 0, 0>(c1, c0));
+    auto row1 = shuffle<0, 2, 2, 2>(shuffle<1, 1, 1, 1>(c1, c0));
+    auto row2 = shuffle<0, 2, 2, 2>(shuffle<2, 2, 2, 2>(c1, c0));
+    auto row3 = shuffle<0, 2, 2, 2>(shuffle<3, 3, 3, 3>(c1, c0));
+
+    auto inv0 = add(sub(mul(row1, fac0), mul(row2, fac1)), mul(row3, fac2));
+    auto inv1 = add(sub(mul(row0, fac0), mul(row2, fac3)), mul(row3, fac4));
+    auto inv2 = add(sub(mul(row0, fac1), mul(row1, fac3)), mul(row3, fac5));
+    auto inv3 = add(sub(mul(row0, fac2), mul(row1, fac4)), mul(row2, fac5));
+
+    auto sign_a = set(1.0f, -1.0f, 1.0f, -1.0f);
+    auto sign_b = set(-1.0f, 1.0f, -1.0f, 1.0f);
+
+    return {mul(inv0, sign_a), mul(inv1, sign_b), mul(inv2, sign_a), mul(inv3, sign_b)};
+}
+
+// Laplace expansion along the first column, reusing the cofactors already in the adjugate
+inline auto determinant(const mat4& mat, const f32x4x4& adj) -> float {
+    auto cofactors = shuffle<0, 2, 0, 2>(shuffle<0, 0, 0, 0>(adj.w, adj.x), shuffle<0, 0, 0, 0>(adj.y, adj.z));
+    return dot(load(mat.w), cofactors);
+}
+
+} // namespace simd
+
+// Result of inverse_and_determinant. A determinant of zero means inverse holds non-finite values.
+struct inverse_result {
+    mat4 inverse;
+    float determinant;
+};
+
+constexpr auto determinant(const mat4& mat) -> float {
+    if(!std::is_constant_evaluated()) {
+        return simd::determinant(mat, simd::adjugate(mat));
+    }
+
+    return determinant<float, 4>(mat);
+}
+
+// Computes the inverse and the determinant together so callers can check for singularity for free
+constexpr auto inverse_and_determinant(const mat4& mat) -> inverse_result {
+    if(!std::is_constant_evaluated()) {
+        auto adj = simd::adjugate(mat);
+        auto det = simd::determinant(mat, adj);
+        auto rcp = simd::broadcast(1.0f / det);
+
+        auto result      = inverse_result{.inverse = mat4{}, .determinant = det};
+        result.inverse.w = simd::store<vec4>(simd::mul(adj.w, rcp));
+        result.inverse.x = simd::store<vec4>(simd::mul(adj.x, rcp));
+        result.inverse.y = simd::store<vec4>(simd::mul(adj.y, rcp));
+        result.inverse.z = simd::store<vec4>(simd::mul(adj.z, rcp));
+        return result;
+    }
+
+    auto adj = adjugate(mat);
+
+    // First row of the adjugate holds the cofactors of the first column
+    auto det = mat[0, 0] * adj[0, 0] + mat[1, 0] * adj[0, 1] + mat[2, 0] * adj[0, 2] + mat[3, 0] * adj[0, 3];
+
+    return inverse_result{.inverse = (1 / det) * adj, .determinant = det};
 }
 
 constexpr auto inverse(const mat4& mat) -> mat4 {
+    return inverse_and_determinant(mat).inverse;
+}
 
-    auto A2323 = mat[2, 2] * mat[3, 3] - mat[2, 3] * mat[3, 2];
-    auto A1323 = mat[2, 1] * mat[3, 3] - mat[2, 3] * mat[3, 1];
-    auto A1223 = mat[2, 1] * mat[3, 2] - mat[2, 2] * mat[3, 1];
-    auto A0323 = mat[2, 0] * mat[3, 3] - mat[2, 3] * mat[3, 0];
-    auto A0223 = mat[2, 0] * mat[3, 2] - mat[2, 2] * mat[3, 0];
-    auto A0123 = mat[2, 0] * mat[3, 1] - mat[2, 1] * mat[3, 0];
-    auto A2313 = mat[1, 2] * mat[3, 3] - mat[1, 3] * mat[3, 2];
-    auto A1313 = mat[1, 1] * mat[3, 3] - mat[1, 3] * mat[3, 1];
-    auto A1213 = mat[1, 1] * mat[3, 2] - mat[1, 2] * mat[3, 1];
-    auto A2312 = mat[1, 2] * mat[2, 3] - mat[1, 3] * mat[2, 2];
-    auto A1312 = mat[1, 1] * mat[2, 3] - mat[1, 3] * mat[2, 1];
-    auto A1212 = mat[1, 1] * mat[2, 2] - mat[1, 2] * mat[2, 1];
-    auto A0313 = mat[1, 0] * mat[3, 3] - mat[1, 3] * mat[3, 0];
-    auto A0213 = mat[1, 0] * mat[3, 2] - mat[1, 2] * mat[3, 0];
-    auto A0312 = mat[1, 0] * mat[2, 3] - mat[1, 3] * mat[2, 0];
-    auto A0212 = mat[1, 0] * mat[2, 2] - mat[1, 2] * mat[2, 0];
-    auto A0113 = mat[1, 0] * mat[3, 1] - mat[1, 1] * mat[3, 0];
-    auto A0112 = mat[1, 0] * mat[2, 1] - mat[1, 1] * mat[2, 0];
-
-    auto det = determinant(mat);
-    det      = 1 / det;
-
-    return det * mat4{
-                     {
-                         (mat[1, 1] * A2323 - mat[1, 2] * A1323 + mat[1, 3] * A1223),
-                         -(mat[0, 1] * A2323 - mat[0, 2] * A1323 + mat[0, 3] * A1223),
-                         (mat[0, 1] * A2313 - mat[0, 2] * A1313 + mat[0, 3] * A1213),
-                         -(mat[0, 1] * A2312 - mat[0, 2] * A1312 + mat[0, 3] * A1212),
-                     },
-                     {
-                         -(mat[1, 0] * A2323 - mat[1, 2] * A0323 + mat[1, 3] * A0223),
-                         (mat[0, 0] * A2323 - mat[0, 2] * A0323 + mat[0, 3] * A0223),
-                         -(mat[0, 0] * A2313 - mat[0, 2] * A0313 + mat[0, 3] * A0213),
-                         (mat[0, 0] * A2312 - mat[0, 2] * A0312 + mat[0, 3] * A0212),
-                     },
-                     {
-                         (mat[1, 0] * A1323 - mat[1, 1] * A0323 + mat[1, 3] * A0123),
-                         -(mat[0, 0] * A1323 - mat[0, 1] * A0323 + mat[0, 3] * A0123),
-                         (mat[0, 0] * A1313 - mat[0, 1] * A0313 + mat[0, 3] * A0113),
-                         -(mat[0, 0] * A1312 - mat[0, 1] * A0312 + mat[0, 3] * A0112),
-                     },
-                     {
-                         -(mat[1, 0] * A1223 - mat[1, 1] * A0223 + mat[1, 2] * A0123),
-                         (mat[0, 0] * A1223 - mat[0, 1] * A0223 + mat[0, 2] * A0123),
-                         -(mat[0, 0] * A1213 - mat[0, 1] * A0213 + mat[0, 2] * A0113),
-                         (mat[0, 0] * A1212 - mat[0, 1] * A0212 + mat[0, 2] * A0112),
-                     },
-                 };
+// True when the upper 3x3 block has orthonormal columns and the last row is 0 0 0 1, i.e. mat only rotates
+// (or reflects) and translates
+constexpr auto is_rigid(const mat4& mat, float tolerance = 0.0001f) -> bool {
+    auto c0 = vec3{mat.w.w, mat.w.x, mat.w.y};
+    auto c1 = vec3{mat.x.w, mat.x.x, mat.x.y};
+    auto c2 = vec3{mat.y.w, mat.y.x, mat.y.y};
+
+    auto within = [=](float value, float expected) { return std::abs(value - expected) <= tolerance; };
+
+    auto orthonormal = within(dot(c0, c0), 1.0f) && within(dot(c1, c1), 1.0f) && within(dot(c2, c2), 1.0f) &&
+                       within(dot(c0, c1), 0.0f) && within(dot(c0, c2), 0.0f) && within(dot(c1, c2), 0.0f);
+
+    return orthonormal && within(mat.w.z, 0.0f) && within(mat.x.z, 0.0f) && within(mat.y.z, 0.0f) &&
+           within(mat.z.z, 1.0f);
+}
+
+// Inverse of a rotation + translation matrix: the transposed rotation and the translation rotated back and negated.
+// Skips the determinant entirely, mat must satisfy is_rigid (checked in debug builds).
+constexpr auto rigid_inverse(const mat4& mat) -> mat4 {
+    assert(is_rigid(mat));
+
+    if(!std::is_constant_evaluated()) {
+        // Rows of the rotation, with a zero last lane
+        auto rows = simd::transpose(simd::f32x4x4{
+            .w = simd::load(mat.w),
+            .x = simd::load(mat.x),
+            .y = simd::load(mat.y),
+            .z = simd::broadcast(0.0f),
+        });
+
+        auto rotated = simd::mul(rows.w, simd::broadcast(mat.z.w));
+        rotated      = simd::fmadd(rows.x, simd::broadcast(mat.z.x), rotated);
+        rotated      = simd::fmadd(rows.y, simd::broadcast(mat.z.y), rotated);
+
+        auto result = mat4{};
+        result.w    = simd::store<vec4>(rows.w);
+        result.x    = simd::store<vec4>(rows.x);
+        result.y    = simd::store<vec4>(rows.y);
+        result.z    = simd::store<vec4>(simd::sub(simd::set(0.0f, 0.0f, 0.0f, 1.0f), rotated));
+        return result;
+    }
+
+    auto c0 = vec3{mat.w.w, mat.w.x, mat.w.y};
+    auto c1 = vec3{mat.x.w, mat.x.x, mat.x.y};
+    auto c2 = vec3{mat.y.w, mat.y.x, mat.y.y};
+    auto t  = vec3{mat.z.w, mat.z.x, mat.z.y};
+
+    return mat4{
+        {c0.x, c0.y, c0.z, -dot(c0, t)},
+        {c1.x, c1.y, c1.z, -dot(c1, t)},
+        {c2.x, c2.y, c2.z, -dot(c2, t)},
+        {0, 0, 0, 1},
+    };
+}
+
+// Upper left 3x3 block of an affine transform, its rotation, scale and shear without the translation
+template<typename T>
+constexpr auto linear_part(const mat<T, 4, 4>& matrix) -> mat<T, 3, 3> {
+    auto upper = [](const vec<T, 4>& column) { return vec<T, 3>{column.w, column.x, column.y}; };
+    return mat<T, 3, 3>::from_cols(upper(matrix.w), upper(matrix.x), upper(matrix.y));
+}
+
+// Inverse transpose of the linear part, which keeps normals perpendicular to surfaces under non uniform scale.
+// The cofactor columns are cross products of column pairs. Results are not unit length if matrix scales.
+template<typename T>
+constexpr auto normal_matrix(const mat<T, 4, 4>& matrix) -> mat<T, 3, 3> {
+    auto linear    = linear_part(matrix);
+    auto cofactors = mat<T, 3, 3>::from_cols(
+        cross(linear.y, linear.z), cross(linear.z, linear.x), cross(linear.x, linear.y));
+    return cofactors * (T{1} / dot(linear.x, cofactors.x));
 }
 
 constexpr auto transpose(const mat4& mat) -> mat4 {
@@ -229,8 +705,8 @@ constexpr auto orthographic(float width, float height, float near_plane, float f
     return mat4{
         {2.0f / width, 0, 0, 0},
         {0, 2.0f / height, 0, 0},
-        {0, 0, range, 0},
-        {0, 0, range * near_plane, 1},
+        {0, 0, range, range * near_plane},
+        {0, 0, 0, 1},
     };
 }
 
@@ -247,14 +723,24 @@ constexpr auto look_at(const vec3& position, const vec3& target, const vec3& up)
     };
 }
 
-// Right-handed, zero to one depth, projection matrix
-constexpr auto perspective(float fov, float aspect, float near_plane, float far_plane) -> mat4 {
-    assert(fov > 0.0f && fov < static_cast<float>(std::numbers::pi));
-    assert(near_plane > 0.0f);
-    assert(far_plane > near_plane);
-    assert(far_plane > 0.0f);
+// Camera to world matrix, equal to inverse(look_at(position, target, up)) without inverting anything
+constexpr auto look_at_inverse(const vec3& position, const vec3& target, const vec3& up) -> mat4 {
+    auto look  = normalize(target - position);
+    auto right = normalize(cross(look, up));
+    auto y     = cross(right, look);
+
+    return mat4{
+        {right.x, y.x, -look.x, position.x},
+        {right.y, y.y, -look.y, position.y},
+        {right.z, y.z, -look.z, position.z},
+        {0, 0, 0, 1},
+    };
+}
+
+namespace detail {
 
-    float focal   = 1.0f / std::tan(fov * 0.5f);
+// Projection matrix for the given focal length, 1 / tan(fov / 2)
+constexpr auto perspective_from(float focal, float aspect, float near_plane, float far_plane) -> mat4 {
     float x_scale = focal / aspect;
 
     return mat4{
@@ -265,4 +751,16 @@ constexpr auto perspective(float fov, float aspect, float near_plane, float far_
     };
 }
 
+} // namespace detail
+
+// Right-handed, zero to one depth, projection matrix
+constexpr auto perspective(float fov, float aspect, float near_plane, float far_plane) -> mat4 {
+    assert(fov > 0.0f && fov < static_cast<float>(std::numbers::pi));
+    assert(near_plane > 0.0f);
+    assert(far_plane > near_plane);
+    assert(far_plane > 0.0f);
+
+    return detail::perspective_from(1.0f / std::tan(fov * 0.5f), aspect, near_plane, far_plane);
+}
+
 } // namespace admat
\ No newline at end of file
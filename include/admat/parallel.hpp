@@ -0,0 +1,250 @@
+#pragma once
+
+// Thread pool implementing the executor contract of executor.hpp, for the overloads that take an executor.
+// Define ADMAT_NO_THREADS to build without std::thread, thread_pool then runs every job on the calling thread.
+
+#include "admat/executor.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <type_traits>
+
+#if !defined(ADMAT_NO_THREADS)
+    #include <condition_variable>
+    #include <mutex>
+    #include <thread>
+    #include <vector>
+#endif
+
+namespace admat {
+
+#if !defined(ADMAT_NO_THREADS)
+
+// A job splits [0, count) into chunks of grain and deals them out as one contiguous run per thread. A thread that
+// finishes its run steals the back half of what is left of another's, so uneven chunks even out without a shared
+// queue. The calling thread takes part, so a pool of n workers runs a job on up to n + 1 threads.
+//
+// Jobs run one at a time, calls from other threads wait for the current one. A call made from inside a running job
+// runs on that thread instead of waiting on itself. fn must not throw.
+class thread_pool {
+public:
+    // One worker per hardware thread besides the caller
+    explicit thread_pool(std::size_t workers = std::max(std::thread::hardware_concurrency(), 1u) - 1)
+        : queues_(workers + 1) {
+        threads_.reserve(workers);
+        for(std::size_t idx = 0; idx < workers; ++idx) {
+            threads_.emplace_back([this, idx] { work_loop(idx); });
+        }
+    }
+
+    thread_pool(const thread_pool&)                    = delete;
+    thread_pool(thread_pool&&)                         = delete;
+    auto operator=(const thread_pool&) -> thread_pool& = delete;
+    auto operator=(thread_pool&&) -> thread_pool&      = delete;
+
+    ~thread_pool() {
+        {
+            auto lock = std::scoped_lock{mutex_};
+            stopping_ = true;
+        }
+        wake_.notify_all();
+        for(auto& thread : threads_) {
+            thread.join();
+        }
+    }
+
+    // Threads a job can run on, the workers and the caller
+    auto concurrency() const -> std::size_t {
+        return queues_.size();
+    }
+
+    template<typename Fn>
+    auto operator()(std::size_t count, std::size_t grain, Fn&& fn) -> void {
+        grain       = std::max(grain, std::size_t{1});
+        auto chunks = (count + grain - 1) / grain;
+        if(chunks <= 1 || threads_.empty() || inside_job_) {
+            if(count > 0) {
+                fn(std::size_t{0}, count);
+            }
+            return;
+        }
+
+        auto target = task<std::remove_reference_t<Fn>>{fn};
+        auto submit = std::scoped_lock{submit_mutex_};
+
+        // Worker idx runs queue idx, the caller runs the queue after the last worker taking part
+        auto participants = std::min(threads_.size(), chunks - 1);
+        auto threads      = participants + 1;
+        {
+            auto lock = std::scoped_lock{mutex_};
+            for(std::size_t idx = 0; idx < queues_.size(); ++idx) {
+                queues_[idx].begin = chunks * std::min(idx, threads) / threads;
+                queues_[idx].end   = chunks * std::min(idx + 1, threads) / threads;
+            }
+
+            job_          = &target;
+            grain_        = grain;
+            count_        = count;
+            participants_ = participants;
+            busy_         = participants;
+            ++generation_;
+        }
+        wake_.notify_all();
+
+        run_chunks(participants);
+
+        // Every chunk is done once the workers taking part have found nothing left to run
+        auto lock = std::unique_lock{mutex_};
+        done_.wait(lock, [this] { return busy_ == 0; });
+    }
+
+private:
+    struct task_base {
+        task_base()                                    = default;
+        task_base(const task_base&)                    = delete;
+        task_base(task_base&&)                         = delete;
+        auto operator=(const task_base&) -> task_base& = delete;
+        auto operator=(task_base&&) -> task_base&      = delete;
+        virtual ~task_base()                           = default;
+
+        virtual auto run(std::size_t begin, std::size_t end) const -> void = 0;
+    };
+
+    template<typename Fn>
+    struct task final : task_base {
+        explicit task(Fn& target) : fn(target) {}
+
+        auto run(std::size_t begin, std::size_t end) const -> void override {
+            fn(begin, end);
+        }
+
+        Fn& fn;
+    };
+
+    // Chunks [begin, end) not yet taken, on its own cache line
+    struct alignas(64) chunk_queue {
+        std::mutex lock;
+        std::size_t begin = 0;
+        std::size_t end   = 0;
+    };
+
+    auto work_loop(std::size_t idx) -> void {
+        auto seen = std::size_t{0};
+        while(true) {
+            {
+                auto lock = std::unique_lock{mutex_};
+                wake_.wait(lock, [&] { return stopping_ || generation_ != seen; });
+                if(stopping_) {
+                    return;
+                }
+
+                seen = generation_;
+                if(idx >= participants_) {
+                    continue;
+                }
+            }
+
+            run_chunks(idx);
+
+            auto lock = std::scoped_lock{mutex_};
+            if(--busy_ == 0) {
+                done_.notify_one();
+            }
+        }
+    }
+
+    auto run_chunks(std::size_t self) -> void {
+        inside_job_ = true;
+        auto chunk  = std::size_t{0};
+        while(pop(self, chunk) || steal(self, chunk)) {
+            auto begin = chunk * grain_;
+            job_->run(begin, std::min(begin + grain_, count_));
+        }
+        inside_job_ = false;
+    }
+
+    auto pop(std::size_t self, std::size_t& chunk) -> bool {
+        auto& own = queues_[self];
+        auto lock = std::scoped_lock{own.lock};
+        if(own.begin == own.end) {
+            return false;
+        }
+        chunk = own.begin++;
+        return true;
+    }
+
+    // Takes the back half of the first non-empty queue after self, runs its first chunk and queues the rest. Only
+    // one queue is locked at a time.
+    auto steal(std::size_t self, std::size_t& chunk) -> bool {
+        for(std::size_t offset = 1; offset < queues_.size(); ++offset) {
+            auto& victim = queues_[(self + offset) % queues_.size()];
+            auto first   = std::size_t{0};
+            auto last    = std::size_t{0};
+            {
+                auto lock = std::scoped_lock{victim.lock};
+                if(victim.begin == victim.end) {
+                    continue;
+                }
+                last       = victim.end;
+                first      = last - (last - victim.begin + 1) / 2;
+                victim.end = first;
+            }
+
+            chunk     = first;
+            auto& own = queues_[self];
+            auto lock = std::scoped_lock{own.lock};
+            own.begin = first + 1;
+            own.end   = last;
+            return true;
+        }
+        return false;
+    }
+
+    std::vector<chunk_queue> queues_;
+    std::vector<std::thread> threads_;
+
+    // Guards the job fields, generation_ and busy_. Workers read the job only after seeing a new generation.
+    std::mutex mutex_;
+    std::mutex submit_mutex_;
+    std::condition_variable wake_;
+    std::condition_variable done_;
+    const task_base* job_     = nullptr;
+    std::size_t grain_        = 1;
+    std::size_t count_        = 0;
+    std::size_t participants_ = 0;
+    std::size_t busy_         = 0;
+    std::size_t generation_   = 0;
+    bool stopping_            = false;
+
+    static inline thread_local bool inside_job_ = false;
+};
+
+#else
+
+// Built without threads, every job runs on the calling thread
+class thread_pool {
+public:
+    explicit thread_pool(std::size_t /*workers*/ = 0) {}
+
+    auto concurrency() const -> std::size_t {
+        return 1;
+    }
+
+    template<typename Fn>
+    auto operator()(std::size_t count, std::size_t /*grain*/, Fn&& fn) -> void {
+        if(count > 0) {
+            fn(std::size_t{0}, count);
+        }
+    }
+};
+
+#endif
+
+// Shared pool, started on first use with one worker per hardware thread besides the caller. Prefer passing your own
+// job system's executor where there is one, so the two do not compete for cores.
+inline auto default_pool() -> thread_pool& {
+    static thread_pool pool;
+    return pool;
+}
+
+} // namespace admat
@@ -0,0 +1,237 @@
+#pragma once
+
+#include "admat/mat.hpp"
+#include "admat/simd.hpp"
+#include "admat/vec.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <span>
+#include <type_traits>
+
+namespace admat {
+
+// Rotation quaternion w + xi + yj + zk, laid out like vec4 so it shares the vec4 SIMD paths
+struct quat {
+    float w;
+    float x;
+    float y;
+    float z;
+
+    static consteval auto identity() -> quat {
+        return quat{1.0f, 0.0f, 0.0f, 0.0f};
+    }
+
+    static auto from_axis_angle(const vec3& axis, float radians) -> quat {
+        auto ax  = normalize(axis);
+        auto sin = std::sin(radians * 0.5f);
+        auto cos = std::cos(radians * 0.5f);
+
+        return quat{cos, ax.x * sin, ax.y * sin, ax.z * sin};
+    }
+
+    // Rotation part of mat, which must be orthonormal
+    static auto from_mat4(const mat4& mat) -> quat {
+        auto trace = mat[0, 0] + mat[1, 1] + mat[2, 2];
+
+        if(trace > 0.0f) {
+            auto scale = std::sqrt(trace + 1.0f) * 2.0f;
+            return quat{
+                0.25f * scale,
+                (mat[2, 1] - mat[1, 2]) / scale,
+                (mat[0, 2] - mat[2, 0]) / scale,
+                (mat[1, 0] - mat[0, 1]) / scale,
+            };
+        }
+
+        if(mat[0, 0] > mat[1, 1] && mat[0, 0] > mat[2, 2]) {
+            auto scale = std::sqrt(1.0f + mat[0, 0] - mat[1, 1] - mat[2, 2]) * 2.0f;
+            return quat{
+                (mat[2, 1] - mat[1, 2]) / scale,
+                0.25f * scale,
+                (mat[0, 1] + mat[1, 0]) / scale,
+                (mat[0, 2] + mat[2, 0]) / scale,
+            };
+        }
+
+        if(mat[1, 1] > mat[2, 2]) {
+            auto scale = std::sqrt(1.0f + mat[1, 1] - mat[0, 0] - mat[2, 2]) * 2.0f;
+            return quat{
+                (mat[0, 2] - mat[2, 0]) / scale,
+                (mat[0, 1] + mat[1, 0]) / scale,
+                0.25f * scale,
+                (mat[1, 2] + mat[2, 1]) / scale,
+            };
+        }
+
+        auto scale = std::sqrt(1.0f + mat[2, 2] - mat[0, 0] - mat[1, 1]) * 2.0f;
+        return quat{
+            (mat[1, 0] - mat[0, 1]) / scale,
+            (mat[0, 2] + mat[2, 0]) / scale,
+            (mat[1, 2] + mat[2, 1]) / scale,
+            0.25f * scale,
+        };
+    }
+};
+
+static_assert(std::is_standard_layout_v<quat> && std::is_trivial_v<quat>, "quat not pod");
+
+struct axis_angle {
+    vec3 axis;
+    float radians;
+};
+
+constexpr auto operator+(const quat& lhs, const quat& rhs) -> quat {
+    if(!std::is_constant_evaluated()) {
+        return simd::store<quat>(simd::add(simd::load(lhs), simd::load(rhs)));
+    }
+
+    return quat{lhs.w + rhs.w, lhs.x + rhs.x, lhs.y + rhs.y, lhs.z + rhs.z};
+}
+
+constexpr auto operator-(const quat& lhs, const quat& rhs) -> quat {
+    if(!std::is_constant_evaluated()) {
+        return simd::store<quat>(simd::sub(simd::load(lhs), simd::load(rhs)));
+    }
+
+    return quat{lhs.w - rhs.w, lhs.x - rhs.x, lhs.y - rhs.y, lhs.z - rhs.z};
+}
+
+constexpr auto operator-(const quat& q) -> quat {
+    return quat{-q.w, -q.x, -q.y, -q.z};
+}
+
+constexpr auto operator*(const quat& lhs, float scalar) -> quat {
+    if(!std::is_constant_evaluated()) {
+        return simd::store<quat>(simd::mul(simd::load(lhs), simd::broadcast(scalar)));
+    }
+
+    return quat{lhs.w * scalar, lhs.x * scalar, lhs.y * scalar, lhs.z * scalar};
+}
+
+constexpr auto operator*(float scalar, const quat& q) -> quat {
+    return q * scalar;
+}
+
+constexpr auto operator/(const quat& lhs, float scalar) -> quat {
+    return lhs * (1.0f / scalar);
+}
+
+// Hamilton product, applies rhs first and then lhs
+constexpr auto operator*(const quat& lhs, const quat& rhs) -> quat {
+    if(!std::is_constant_evaluated()) {
+        auto b = simd::load(rhs);
+
+        auto result = simd::mul(simd::broadcast(lhs.w), b);
+        result      = simd::fmadd(simd::broadcast(lhs.x),
+                             simd::mul(simd::shuffle<1, 0, 3, 2>(b), simd::set(-1.0f, 1.0f, -1.0f, 1.0f)),
+                             result);
+        result      = simd::fmadd(simd::broadcast(lhs.y),
+                             simd::mul(simd::shuffle<2, 3, 0, 1>(b), simd::set(-1.0f, 1.0f, 1.0f, -1.0f)),
+                             result);
+        result      = simd::fmadd(simd::broadcast(lhs.z),
+                             simd::mul(simd::shuffle<3, 2, 1, 0>(b), simd::set(-1.0f, -1.0f, 1.0f, 1.0f)),
+                             result);
+        return simd::store<quat>(result);
+    }
+
+    return quat{
+        lhs.w * rhs.w - lhs.x * rhs.x - lhs.y * rhs.y - lhs.z * rhs.z,
+        lhs.w * rhs.x + lhs.x * rhs.w + lhs.y * rhs.z - lhs.z * rhs.y,
+        lhs.w * rhs.y - lhs.x * rhs.z + lhs.y * rhs.w + lhs.z * rhs.x,
+        lhs.w * rhs.z + lhs.x * rhs.y - lhs.y * rhs.x + lhs.z * rhs.w,
+    };
+}
+
+// Rotates vec by a unit quaternion
+constexpr auto operator*(const quat& q, const vec3& vec) -> vec3 {
+    auto axis  = vec3{q.x, q.y, q.z};
+    auto twice = cross(axis, vec) * 2.0f;
+
+    return vec + twice * q.w + cross(axis, twice);
+}
+
+constexpr auto dot(const quat& lhs, const quat& rhs) -> float {
+    if(!std::is_constant_evaluated()) {
+        return simd::dot(simd::load(lhs), simd::load(rhs));
+    }
+
+    return (lhs.w * rhs.w) + (lhs.x * rhs.x) + (lhs.y * rhs.y) + (lhs.z * rhs.z);
+}
+
+constexpr auto conjugate(const quat& q) -> quat {
+    return quat{q.w, -q.x, -q.y, -q.z};
+}
+
+constexpr auto inverse(const quat& q) -> quat {
+    return conjugate(q) / dot(q, q);
+}
+
+// Rotation matrix of a unit quaternion
+constexpr auto rotation(const quat& q) -> mat4 {
+    auto xx = q.x * q.x;
+    auto yy = q.y * q.y;
+    auto zz = q.z * q.z;
+    auto xy = q.x * q.y;
+    auto xz = q.x * q.z;
+    auto yz = q.y * q.z;
+    auto wx = q.w * q.x;
+    auto wy = q.w * q.y;
+    auto wz = q.w * q.z;
+
+    return mat4{
+        {1.0f - 2.0f * (yy + zz), 2.0f * (xy - wz), 2.0f * (xz + wy), 0.0f},
+        {2.0f * (xy + wz), 1.0f - 2.0f * (xx + zz), 2.0f * (yz - wx), 0.0f},
+        {2.0f * (xz - wy), 2.0f * (yz + wx), 1.0f - 2.0f * (xx + yy), 0.0f},
+        {0.0f, 0.0f, 0.0f, 1.0f},
+    };
+}
+
+inline auto to_axis_angle(const quat& q) -> axis_angle {
+    auto w       = std::clamp(q.w, -1.0f, 1.0f);
+    auto sin_sqr = 1.0f - w * w;
+
+    // No rotation, any axis will do
+    if(sin_sqr < 1e-12f) {
+        return axis_angle{.axis = vec3{1.0f, 0.0f, 0.0f}, .radians = 0.0f};
+    }
+
+    auto sin = std::sqrt(sin_sqr);
+    return axis_angle{.axis = vec3{q.x / sin, q.y / sin, q.z / sin}, .radians = 2.0f * std::acos(w)};
+}
+
+// Normalized linear interpolation along the shortest arc
+inline auto nlerp(const quat& from, const quat& to, float delta) -> quat {
+    auto target = dot(from, to) < 0.0f ? -to : to;
+    return normalize(from * (1.0f - delta) + target * delta);
+}
+
+// Spherical linear interpolation along the shortest arc
+inline auto slerp(const quat& from, const quat& to, float delta) -> quat {
+    auto cos    = dot(from, to);
+    auto target = cos < 0.0f ? -to : to;
+    cos         = std::abs(cos);
+
+    // Nearly parallel, sin(theta) vanishes so fall back to nlerp
+    if(cos > 0.9995f) {
+        return normalize(from * (1.0f - delta) + target * delta);
+    }
+
+    auto theta     = std::acos(cos);
+    auto sin_theta = std::sin(theta);
+
+    return (from * std::sin((1.0f - delta) * theta) + target * std::sin(delta * theta)) / sin_theta;
+}
+
+// out[i] = slerp(from[i], to[i], delta). out must hold at least from.size() elements and may alias from or to.
+inline auto slerp(std::span<const quat> from, std::span<const quat> to, float delta, std::span<quat> out) -> void {
+    assert(from.size() == to.size() && out.size() >= from.size());
+
+    for(std::size_t i = 0; i < from.size(); ++i) {
+        out[i] = slerp(from[i], to[i], delta);
+    }
+}
+
+} // namespace admat
@@ -0,0 +1,130 @@
+#pragma once
+
+// Camera relative rendering. World positions are kept in double, which stays precise far beyond the few kilometres
+// float manages, and are moved to a double origin near the camera before being rounded to float for the GPU.
+// Close to the origin, where errors would be visible, the float results are as precise as float allows.
+
+#include "admat/executor.hpp"
+#include "admat/mat.hpp"
+#include "admat/simd.hpp"
+#include "admat/vec.hpp"
+
+#include <cassert>
+#include <cstddef>
+#include <span>
+#include <type_traits>
+
+namespace admat {
+
+// position - origin, rounded to float
+constexpr auto rebase(const dvec3& origin, const dvec3& position) -> vec3 {
+    return vec3{
+        static_cast<float>(position.x - origin.x),
+        static_cast<float>(position.y - origin.y),
+        static_cast<float>(position.z - origin.z),
+    };
+}
+
+// translation(-origin) * transform, rounded to float. For an affine transform only the translation moves.
+constexpr auto rebase(const dvec3& origin, const dmat4& transform) -> mat4 {
+    // Each column loses origin times its last row entry
+    if(!std::is_constant_evaluated()) {
+        auto shift  = simd::set_f64(origin.x, origin.y, origin.z, 0.0);
+        auto narrow = [&](const dvec4& col) {
+            auto moved = simd::sub(simd::load_f64(col), simd::mul(shift, simd::broadcast_f64(col.z)));
+            return simd::store<vec4>(simd::to_f32(moved));
+        };
+
+        auto result = mat4{};
+        result.w    = narrow(transform.w);
+        result.x    = narrow(transform.x);
+        result.y    = narrow(transform.y);
+        result.z    = narrow(transform.z);
+        return result;
+    }
+
+    auto column = [&](const dvec4& col) {
+        return vec4{
+            static_cast<float>(col.w - origin.x * col.z),
+            static_cast<float>(col.x - origin.y * col.z),
+            static_cast<float>(col.y - origin.z * col.z),
+            static_cast<float>(col.z),
+        };
+    };
+
+    return mat4::from_cols(column(transform.w), column(transform.x), column(transform.y), column(transform.z));
+}
+
+namespace simd {
+
+// Four dvec3 are twelve packed doubles, three f64x4 registers in which the origin repeats with a period of three
+// lanes. Each register is converted to four floats and stored straight away, so the span is read and written once.
+inline auto rebase_vec3(const dvec3& origin, std::span<const dvec3> in, std::span<vec3> out) -> void {
+    if(in.empty()) {
+        return;
+    }
+
+    auto o0 = set_f64(origin.x, origin.y, origin.z, origin.x);
+    auto o1 = set_f64(origin.y, origin.z, origin.x, origin.y);
+    auto o2 = set_f64(origin.z, origin.x, origin.y, origin.z);
+
+    const auto* src = &in.data()->x;
+    auto* dst       = &out.data()->x;
+
+    std::size_t i = 0;
+    for(; i + 4 <= in.size(); i += 4) {
+        // NOLINTBEGIN(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+        store(dst + i * 3, to_f32(sub(load_f64(src + i * 3), o0)));
+        store(dst + i * 3 + 4, to_f32(sub(load_f64(src + i * 3 + 4), o1)));
+        store(dst + i * 3 + 8, to_f32(sub(load_f64(src + i * 3 + 8), o2)));
+        // NOLINTEND(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    }
+
+    for(; i < in.size(); ++i) {
+        out[i] = rebase(origin, in[i]);
+    }
+}
+
+} // namespace simd
+
+// rebase(origin, in[i]) for every element. out must hold at least in.size() elements.
+inline auto rebase(const dvec3& origin, std::span<const dvec3> in, std::span<vec3> out) -> void {
+    assert(out.size() >= in.size());
+    simd::rebase_vec3(origin, in, out);
+}
+
+// rebase(origin, in[i]) for every element. out must hold at least in.size() elements.
+inline auto rebase(const dvec3& origin, std::span<const dmat4> in, std::span<mat4> out) -> void {
+    assert(out.size() >= in.size());
+    for(std::size_t i = 0; i < in.size(); ++i) {
+        out[i] = rebase(origin, in[i]);
+    }
+}
+
+// Executor versions of the above, run through exec in chunks of grain elements
+
+template<typename Executor>
+inline auto rebase(Executor&& exec,
+                   const dvec3& origin,
+                   std::span<const dvec3> in,
+                   std::span<vec3> out,
+                   std::size_t grain = default_grain) -> void {
+    assert(out.size() >= in.size());
+    parallel_for(exec, in.size(), grain, [&](std::size_t begin, std::size_t end) {
+        simd::rebase_vec3(origin, in.subspan(begin, end - begin), out.subspan(begin, end - begin));
+    });
+}
+
+template<typename Executor>
+inline auto rebase(Executor&& exec,
+                   const dvec3& origin,
+                   std::span<const dmat4> in,
+                   std::span<mat4> out,
+                   std::size_t grain = default_grain) -> void {
+    assert(out.size() >= in.size());
+    parallel_for(exec, in.size(), grain, [&](std::size_t begin, std::size_t end) {
+        rebase(origin, in.subspan(begin, end - begin), out.subspan(begin, end - begin));
+    });
+}
+
+} // namespace admat
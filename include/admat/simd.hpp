@@ -0,0 +1,810 @@
+#pragma once
+
+// Thin wrapper over the platform vector registers used by the vec/mat kernels.
+// The backend is picked at compile time from the target flags. Define ADMAT_NO_SIMD to force the scalar fallback.
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+#if !defined(ADMAT_NO_SIMD) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+    #define ADMAT_SIMD_SSE 1
+    #include <immintrin.h>
+#else
+    #define ADMAT_SIMD_SSE 0
+#endif
+
+#if !defined(ADMAT_NO_SIMD) && !ADMAT_SIMD_SSE && (defined(__ARM_NEON) || defined(_M_ARM64))
+    #define ADMAT_SIMD_NEON 1
+    #include <arm_neon.h>
+#else
+    #define ADMAT_SIMD_NEON 0
+#endif
+
+#if ADMAT_SIMD_SSE && defined(__AVX__)
+    #define ADMAT_SIMD_AVX 1
+#else
+    #define ADMAT_SIMD_AVX 0
+#endif
+
+#if ADMAT_SIMD_SSE && defined(__AVX512F__)
+    #define ADMAT_SIMD_AVX512 1
+#else
+    #define ADMAT_SIMD_AVX512 0
+#endif
+
+// GCC and Clang keep FMA apart from AVX2, -mavx2 alone does not allow it. MSVC has no __FMA__, and its /arch:AVX2 is
+// the one case where __AVX2__ implies FMA.
+#if ADMAT_SIMD_SSE && (defined(__FMA__) || (defined(_MSC_VER) && defined(__AVX2__)))
+    #define ADMAT_SIMD_FMA 1
+#else
+    #define ADMAT_SIMD_FMA 0
+#endif
+
+#if ADMAT_SIMD_SSE && defined(__F16C__)
+    #define ADMAT_SIMD_F16C 1
+#else
+    #define ADMAT_SIMD_F16C 0
+#endif
+
+namespace admat::simd {
+
+#if ADMAT_SIMD_SSE
+using f32x4 = __m128;
+#elif ADMAT_SIMD_NEON
+using f32x4 = float32x4_t;
+#else
+struct f32x4 {
+    std::array<float, 4> lanes;
+};
+#endif
+
+static_assert(sizeof(f32x4) == 4 * sizeof(float), "f32x4 must be exactly four floats");
+
+// Per lane comparison result, consumed by select
+#if ADMAT_SIMD_SSE
+using mask4 = __m128;
+#elif ADMAT_SIMD_NEON
+using mask4 = uint32x4_t;
+#else
+struct mask4 {
+    std::array<bool, 4> lanes;
+};
+#endif
+
+// Four registers named like the mat4 columns they usually hold
+struct f32x4x4 {
+    f32x4 w;
+    f32x4 x;
+    f32x4 y;
+    f32x4 z;
+};
+
+// Reinterpret any 16 byte, 4 float type (vec4, a mat4 column) as a register and back
+template<typename T>
+inline auto load(const T& value) -> f32x4 {
+    static_assert(sizeof(T) == sizeof(f32x4));
+    return std::bit_cast<f32x4>(value);
+}
+
+template<typename T>
+inline auto store(const f32x4& reg) -> T {
+    static_assert(sizeof(T) == sizeof(f32x4));
+    return std::bit_cast<T>(reg);
+}
+
+inline auto broadcast(float value) -> f32x4 {
+#if ADMAT_SIMD_SSE
+    return _mm_set1_ps(value);
+#elif ADMAT_SIMD_NEON
+    return vdupq_n_f32(value);
+#else
+    return f32x4{{value, value, value, value}};
+#endif
+}
+
+inline auto add(const f32x4& lhs, const f32x4& rhs) -> f32x4 {
+#if ADMAT_SIMD_SSE
+    return _mm_add_ps(lhs, rhs);
+#elif ADMAT_SIMD_NEON
+    return vaddq_f32(lhs, rhs);
+#else
+    return f32x4{{lhs.lanes[0] + rhs.lanes[0],
+                  lhs.lanes[1] + rhs.lanes[1],
+                  lhs.lanes[2] + rhs.lanes[2],
+                  lhs.lanes[3] + rhs.lanes[3]}};
+#endif
+}
+
+inline auto sub(const f32x4& lhs, const f32x4& rhs) -> f32x4 {
+#if ADMAT_SIMD_SSE
+    return _mm_sub_ps(lhs, rhs);
+#elif ADMAT_SIMD_NEON
+    return vsubq_f32(lhs, rhs);
+#else
+    return f32x4{{lhs.lanes[0] - rhs.lanes[0],
+                  lhs.lanes[1] - rhs.lanes[1],
+                  lhs.lanes[2] - rhs.lanes[2],
+                  lhs.lanes[3] - rhs.lanes[3]}};
+#endif
+}
+
+inline auto mul(const f32x4& lhs, const f32x4& rhs) -> f32x4 {
+#if ADMAT_SIMD_SSE
+    return _mm_mul_ps(lhs, rhs);
+#elif ADMAT_SIMD_NEON
+    return vmulq_f32(lhs, rhs);
+#else
+    return f32x4{{lhs.lanes[0] * rhs.lanes[0],
+                  lhs.lanes[1] * rhs.lanes[1],
+                  lhs.lanes[2] * rhs.lanes[2],
+                  lhs.lanes[3] * rhs.lanes[3]}};
+#endif
+}
+
+inline auto div(const f32x4& lhs, const f32x4& rhs) -> f32x4 {
+#if ADMAT_SIMD_SSE
+    return _mm_div_ps(lhs, rhs);
+#elif ADMAT_SIMD_NEON && defined(__aarch64__)
+    return vdivq_f32(lhs, rhs);
+#else
+    auto l = std::bit_cast<std::array<float, 4>>(lhs);
+    auto r = std::bit_cast<std::array<float, 4>>(rhs);
+    return std::bit_cast<f32x4>(std::array<float, 4>{l[0] / r[0], l[1] / r[1], l[2] / r[2], l[3] / r[3]});
+#endif
+}
+
+// a * b + c, fused when the target has FMA
+inline auto fmadd(const f32x4& a, const f32x4& b, const f32x4& c) -> f32x4 {
+#if ADMAT_SIMD_FMA
+    return _mm_fmadd_ps(a, b, c);
+#elif ADMAT_SIMD_NEON
+    return vmlaq_f32(c, a, b);
+#else
+    return add(mul(a, b), c);
+#endif
+}
+
+inline auto min(const f32x4& lhs, const f32x4& rhs) -> f32x4 {
+#if ADMAT_SIMD_SSE
+    return _mm_min_ps(lhs, rhs);
+#elif ADMAT_SIMD_NEON
+    return vminq_f32(lhs, rhs);
+#else
+    return f32x4{{std::min(lhs.lanes[0], rhs.lanes[0]),
+                  std::min(lhs.lanes[1], rhs.lanes[1]),
+                  std::min(lhs.lanes[2], rhs.lanes[2]),
+                  std::min(lhs.lanes[3], rhs.lanes[3])}};
+#endif
+}
+
+inline auto max(const f32x4& lhs, const f32x4& rhs) -> f32x4 {
+#if ADMAT_SIMD_SSE
+    return _mm_max_ps(lhs, rhs);
+#elif ADMAT_SIMD_NEON
+    return vmaxq_f32(lhs, rhs);
+#else
+    return f32x4{{std::max(lhs.lanes[0], rhs.lanes[0]),
+                  std::max(lhs.lanes[1], rhs.lanes[1]),
+                  std::max(lhs.lanes[2], rhs.lanes[2]),
+                  std::max(lhs.lanes[3], rhs.lanes[3])}};
+#endif
+}
+
+inline auto neg(const f32x4& reg) -> f32x4 {
+#if ADMAT_SIMD_SSE
+    return _mm_xor_ps(reg, _mm_set1_ps(-0.0f));
+#elif ADMAT_SIMD_NEON
+    return vnegq_f32(reg);
+#else
+    return f32x4{{-reg.lanes[0], -reg.lanes[1], -reg.lanes[2], -reg.lanes[3]}};
+#endif
+}
+
+inline auto abs(const f32x4& reg) -> f32x4 {
+#if ADMAT_SIMD_SSE
+    return _mm_andnot_ps(_mm_set1_ps(-0.0f), reg);
+#elif ADMAT_SIMD_NEON
+    return vabsq_f32(reg);
+#else
+    return f32x4{{std::abs(reg.lanes[0]), std::abs(reg.lanes[1]), std::abs(reg.lanes[2]), std::abs(reg.lanes[3])}};
+#endif
+}
+
+inline auto sqrt(const f32x4& reg) -> f32x4 {
+#if ADMAT_SIMD_SSE
+    return _mm_sqrt_ps(reg);
+#elif ADMAT_SIMD_NEON && defined(__aarch64__)
+    return vsqrtq_f32(reg);
+#else
+    auto l = std::bit_cast<std::array<float, 4>>(reg);
+    return std::bit_cast<f32x4>(
+        std::array<float, 4>{std::sqrt(l[0]), std::sqrt(l[1]), std::sqrt(l[2]), std::sqrt(l[3])});
+#endif
+}
+
+// To the nearest integer, ties to even, like std::nearbyint in the default rounding mode
+inline auto round(const f32x4& reg) -> f32x4 {
+#if ADMAT_SIMD_SSE && defined(__SSE4_1__)
+    return _mm_round_ps(reg, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+#elif ADMAT_SIMD_SSE
+    // Adding 2^23 to a smaller magnitude pushes its fraction out of the mantissa, larger ones are already whole
+    auto sign      = _mm_and_ps(reg, _mm_set1_ps(-0.0f));
+    auto magnitude = _mm_andnot_ps(_mm_set1_ps(-0.0f), reg);
+    auto big       = _mm_set1_ps(8388608.0f);
+    auto rounded   = _mm_or_ps(_mm_sub_ps(_mm_add_ps(magnitude, big), big), sign);
+    auto whole     = _mm_cmpge_ps(magnitude, big);
+    return _mm_or_ps(_mm_and_ps(whole, reg), _mm_andnot_ps(whole, rounded));
+#elif ADMAT_SIMD_NEON && defined(__aarch64__)
+    return vrndnq_f32(reg);
+#else
+    auto l = std::bit_cast<std::array<float, 4>>(reg);
+    return std::bit_cast<f32x4>(
+        std::array<float, 4>{std::nearbyint(l[0]), std::nearbyint(l[1]), std::nearbyint(l[2]), std::nearbyint(l[3])});
+#endif
+}
+
+inline auto less(const f32x4& lhs, const f32x4& rhs) -> mask4 {
+#if ADMAT_SIMD_SSE
+    return _mm_cmplt_ps(lhs, rhs);
+#elif ADMAT_SIMD_NEON
+    return vcltq_f32(lhs, rhs);
+#else
+    return mask4{{lhs.lanes[0] < rhs.lanes[0],
+                  lhs.lanes[1] < rhs.lanes[1],
+                  lhs.lanes[2] < rhs.lanes[2],
+                  lhs.lanes[3] < rhs.lanes[3]}};
+#endif
+}
+
+// Lanes of if_true where mask is set, otherwise if_false
+inline auto select(const mask4& mask, const f32x4& if_true, const f32x4& if_false) -> f32x4 {
+#if ADMAT_SIMD_SSE
+    return _mm_or_ps(_mm_and_ps(mask, if_true), _mm_andnot_ps(mask, if_false));
+#elif ADMAT_SIMD_NEON
+    return vbslq_f32(mask, if_true, if_false);
+#else
+    return f32x4{{mask.lanes[0] ? if_true.lanes[0] : if_false.lanes[0],
+                  mask.lanes[1] ? if_true.lanes[1] : if_false.lanes[1],
+                  mask.lanes[2] ? if_true.lanes[2] : if_false.lanes[2],
+                  mask.lanes[3] ? if_true.lanes[3] : if_false.lanes[3]}};
+#endif
+}
+
+// Bit i is set when lane i of mask is set
+inline auto bitmask(const mask4& mask) -> std::uint32_t {
+#if ADMAT_SIMD_SSE
+    return static_cast<std::uint32_t>(_mm_movemask_ps(mask));
+#elif ADMAT_SIMD_NEON
+    auto weights = std::array<std::uint32_t, 4>{1, 2, 4, 8};
+    auto bits    = vandq_u32(mask, vld1q_u32(weights.data()));
+    return vgetq_lane_u32(bits, 0) | vgetq_lane_u32(bits, 1) | vgetq_lane_u32(bits, 2) | vgetq_lane_u32(bits, 3);
+#else
+    return (mask.lanes[0] ? 1u : 0u) | (mask.lanes[1] ? 2u : 0u) | (mask.lanes[2] ? 4u : 0u) |
+           (mask.lanes[3] ? 8u : 0u);
+#endif
+}
+
+// Lanes {lhs[i0], lhs[i1], rhs[i2], rhs[i3]}, the same selection as _mm_shuffle_ps
+template<int i0, int i1, int i2, int i3>
+inline auto shuffle(const f32x4& lhs, const f32x4& rhs) -> f32x4 {
+    static_assert(i0 >= 0 && i0 < 4 && i1 >= 0 && i1 < 4 && i2 >= 0 && i2 < 4 && i3 >= 0 && i3 < 4);
+#if ADMAT_SIMD_SSE
+    return _mm_shuffle_ps(lhs, rhs, _MM_SHUFFLE(i3, i2, i1, i0));
+#else
+    auto l = std::bit_cast<std::array<float, 4>>(lhs);
+    auto r = std::bit_cast<std::array<float, 4>>(rhs);
+    return std::bit_cast<f32x4>(std::array<float, 4>{l[i0], l[i1], r[i2], r[i3]});
+#endif
+}
+
+template<int i0, int i1, int i2, int i3>
+inline auto shuffle(const f32x4& reg) -> f32x4 {
+    return shuffle<i0, i1, i2, i3>(reg, reg);
+}
+
+inline auto set(float l0, float l1, float l2, float l3) -> f32x4 {
+#if ADMAT_SIMD_SSE
+    return _mm_setr_ps(l0, l1, l2, l3);
+#else
+    return std::bit_cast<f32x4>(std::array<float, 4>{l0, l1, l2, l3});
+#endif
+}
+
+// Horizontal sum of all four lanes
+inline auto sum(const f32x4& reg) -> float {
+#if ADMAT_SIMD_SSE
+    auto shuf = _mm_shuffle_ps(reg, reg, _MM_SHUFFLE(2, 3, 0, 1));
+    auto sums = _mm_add_ps(reg, shuf);
+    shuf      = _mm_movehl_ps(shuf, sums);
+    sums      = _mm_add_ss(sums, shuf);
+    return _mm_cvtss_f32(sums);
+#elif ADMAT_SIMD_NEON && defined(__aarch64__)
+    return vaddvq_f32(reg);
+#else
+    auto l = std::bit_cast<std::array<float, 4>>(reg);
+    return (l[0] + l[1]) + (l[2] + l[3]);
+#endif
+}
+
+inline auto dot(const f32x4& lhs, const f32x4& rhs) -> float {
+    return sum(mul(lhs, rhs));
+}
+
+// Swaps rows and columns, lane i of the result's register j is lane j of regs' register i
+inline auto transpose(const f32x4x4& regs) -> f32x4x4 {
+    auto lo01 = shuffle<0, 1, 0, 1>(regs.w, regs.x);
+    auto hi01 = shuffle<2, 3, 2, 3>(regs.w, regs.x);
+    auto lo23 = shuffle<0, 1, 0, 1>(regs.y, regs.z);
+    auto hi23 = shuffle<2, 3, 2, 3>(regs.y, regs.z);
+
+    return f32x4x4{
+        .w = shuffle<0, 2, 0, 2>(lo01, lo23),
+        .x = shuffle<1, 3, 1, 3>(lo01, lo23),
+        .y = shuffle<0, 2, 0, 2>(hi01, hi23),
+        .z = shuffle<1, 3, 1, 3>(hi01, hi23),
+    };
+}
+
+// Four doubles, one dvec4 or dmat4 column. AVX holds them in one register. Elsewhere they are a plain array, which
+// the compiler still splits over two SSE2 or NEON registers.
+#if ADMAT_SIMD_AVX
+using f64x4 = __m256d;
+#else
+struct f64x4 {
+    std::array<double, 4> lanes;
+};
+#endif
+
+static_assert(sizeof(f64x4) == 4 * sizeof(double), "f64x4 must be exactly four doubles");
+
+// Reinterpret any 32 byte, 4 double type (dvec4, a dmat4 column) as a register and back
+template<typename T>
+inline auto load_f64(const T& value) -> f64x4 {
+    static_assert(sizeof(T) == sizeof(f64x4));
+    return std::bit_cast<f64x4>(value);
+}
+
+template<typename T>
+inline auto store_f64(const f64x4& reg) -> T {
+    static_assert(sizeof(T) == sizeof(f64x4));
+    return std::bit_cast<T>(reg);
+}
+
+// Four doubles from unaligned memory
+inline auto load_f64(const double* data) -> f64x4 {
+#if ADMAT_SIMD_AVX
+    return _mm256_loadu_pd(data);
+#else
+    return f64x4{{data[0], data[1], data[2], data[3]}}; // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+#endif
+}
+
+inline auto broadcast_f64(double value) -> f64x4 {
+#if ADMAT_SIMD_AVX
+    return _mm256_set1_pd(value);
+#else
+    return f64x4{{value, value, value, value}};
+#endif
+}
+
+inline auto set_f64(double l0, double l1, double l2, double l3) -> f64x4 {
+#if ADMAT_SIMD_AVX
+    return _mm256_setr_pd(l0, l1, l2, l3);
+#else
+    return f64x4{{l0, l1, l2, l3}};
+#endif
+}
+
+#if !ADMAT_SIMD_AVX
+namespace detail {
+
+template<typename Fn>
+inline auto lanes_f64(const f64x4& lhs, const f64x4& rhs, Fn&& fn) -> f64x4 {
+    auto result = f64x4{};
+    for(std::size_t i = 0; i < 4; ++i) {
+        result.lanes[i] = fn(lhs.lanes[i], rhs.lanes[i]);
+    }
+    return result;
+}
+
+} // namespace detail
+#endif
+
+inline auto add(const f64x4& lhs, const f64x4& rhs) -> f64x4 {
+#if ADMAT_SIMD_AVX
+    return _mm256_add_pd(lhs, rhs);
+#else
+    return detail::lanes_f64(lhs, rhs, [](double a, double b) { return a + b; });
+#endif
+}
+
+inline auto sub(const f64x4& lhs, const f64x4& rhs) -> f64x4 {
+#if ADMAT_SIMD_AVX
+    return _mm256_sub_pd(lhs, rhs);
+#else
+    return detail::lanes_f64(lhs, rhs, [](double a, double b) { return a - b; });
+#endif
+}
+
+inline auto mul(const f64x4& lhs, const f64x4& rhs) -> f64x4 {
+#if ADMAT_SIMD_AVX
+    return _mm256_mul_pd(lhs, rhs);
+#else
+    return detail::lanes_f64(lhs, rhs, [](double a, double b) { return a * b; });
+#endif
+}
+
+inline auto div(const f64x4& lhs, const f64x4& rhs) -> f64x4 {
+#if ADMAT_SIMD_AVX
+    return _mm256_div_pd(lhs, rhs);
+#else
+    return detail::lanes_f64(lhs, rhs, [](double a, double b) { return a / b; });
+#endif
+}
+
+// a * b + c, fused when the target has FMA
+inline auto fmadd(const f64x4& a, const f64x4& b, const f64x4& c) -> f64x4 {
+#if ADMAT_SIMD_AVX && ADMAT_SIMD_FMA
+    return _mm256_fmadd_pd(a, b, c);
+#else
+    return add(mul(a, b), c);
+#endif
+}
+
+// Horizontal sum of all four lanes
+inline auto sum(const f64x4& reg) -> double {
+#if ADMAT_SIMD_AVX
+    auto pairs = _mm_add_pd(_mm256_castpd256_pd128(reg), _mm256_extractf128_pd(reg, 1));
+    return _mm_cvtsd_f64(_mm_add_sd(pairs, _mm_unpackhi_pd(pairs, pairs)));
+#else
+    return (reg.lanes[0] + reg.lanes[2]) + (reg.lanes[1] + reg.lanes[3]);
+#endif
+}
+
+inline auto dot(const f64x4& lhs, const f64x4& rhs) -> double {
+    return sum(mul(lhs, rhs));
+}
+
+// Rounds every lane to the nearest float
+inline auto to_f32(const f64x4& reg) -> f32x4 {
+#if ADMAT_SIMD_AVX
+    return _mm256_cvtpd_ps(reg);
+#else
+    return set(static_cast<float>(reg.lanes[0]),
+               static_cast<float>(reg.lanes[1]),
+               static_cast<float>(reg.lanes[2]),
+               static_cast<float>(reg.lanes[3]));
+#endif
+}
+
+// Four floats to unaligned memory
+inline auto store(float* data, const f32x4& reg) -> void {
+#if ADMAT_SIMD_SSE
+    _mm_storeu_ps(data, reg);
+#elif ADMAT_SIMD_NEON
+    vst1q_f32(data, reg);
+#else
+    std::copy(reg.lanes.begin(), reg.lanes.end(), data);
+#endif
+}
+
+// The widest register the target supports, used by the batch kernels over spans.
+// Each 128 bit group of lanes can hold one vec4 or mat4 column.
+#if ADMAT_SIMD_AVX512
+using f32xw                            = __m512;
+using maskw                            = __mmask16;
+inline constexpr std::size_t wide_width = 16;
+#elif ADMAT_SIMD_AVX
+using f32xw                            = __m256;
+using maskw                            = __m256;
+inline constexpr std::size_t wide_width = 8;
+#else
+using f32xw                            = f32x4;
+using maskw                            = mask4;
+inline constexpr std::size_t wide_width = 4;
+#endif
+
+#if ADMAT_SIMD_AVX512
+inline auto add(const __m512& lhs, const __m512& rhs) -> __m512 {
+    return _mm512_add_ps(lhs, rhs);
+}
+
+inline auto sub(const __m512& lhs, const __m512& rhs) -> __m512 {
+    return _mm512_sub_ps(lhs, rhs);
+}
+
+inline auto mul(const __m512& lhs, const __m512& rhs) -> __m512 {
+    return _mm512_mul_ps(lhs, rhs);
+}
+
+inline auto div(const __m512& lhs, const __m512& rhs) -> __m512 {
+    return _mm512_div_ps(lhs, rhs);
+}
+
+inline auto fmadd(const __m512& a, const __m512& b, const __m512& c) -> __m512 {
+    return _mm512_fmadd_ps(a, b, c);
+}
+
+inline auto min(const __m512& lhs, const __m512& rhs) -> __m512 {
+    return _mm512_min_ps(lhs, rhs);
+}
+
+inline auto max(const __m512& lhs, const __m512& rhs) -> __m512 {
+    return _mm512_max_ps(lhs, rhs);
+}
+
+inline auto abs(const __m512& reg) -> __m512 {
+    return _mm512_abs_ps(reg);
+}
+
+inline auto sqrt(const __m512& reg) -> __m512 {
+    return _mm512_sqrt_ps(reg);
+}
+
+inline auto round(const __m512& reg) -> __m512 {
+    return _mm512_roundscale_ps(reg, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+}
+
+inline auto less(const __m512& lhs, const __m512& rhs) -> __mmask16 {
+    return _mm512_cmp_ps_mask(lhs, rhs, _CMP_LT_OQ);
+}
+
+inline auto select(__mmask16 mask, const __m512& if_true, const __m512& if_false) -> __m512 {
+    return _mm512_mask_blend_ps(mask, if_false, if_true);
+}
+
+inline auto bitmask(__mmask16 mask) -> std::uint32_t {
+    return mask;
+}
+#endif
+
+#if ADMAT_SIMD_AVX
+inline auto add(const __m256& lhs, const __m256& rhs) -> __m256 {
+    return _mm256_add_ps(lhs, rhs);
+}
+
+inline auto sub(const __m256& lhs, const __m256& rhs) -> __m256 {
+    return _mm256_sub_ps(lhs, rhs);
+}
+
+inline auto mul(const __m256& lhs, const __m256& rhs) -> __m256 {
+    return _mm256_mul_ps(lhs, rhs);
+}
+
+inline auto div(const __m256& lhs, const __m256& rhs) -> __m256 {
+    return _mm256_div_ps(lhs, rhs);
+}
+
+inline auto fmadd(const __m256& a, const __m256& b, const __m256& c) -> __m256 {
+    #if ADMAT_SIMD_FMA
+    return _mm256_fmadd_ps(a, b, c);
+    #else
+    return _mm256_add_ps(_mm256_mul_ps(a, b), c);
+    #endif
+}
+
+inline auto min(const __m256& lhs, const __m256& rhs) -> __m256 {
+    return _mm256_min_ps(lhs, rhs);
+}
+
+inline auto max(const __m256& lhs, const __m256& rhs) -> __m256 {
+    return _mm256_max_ps(lhs, rhs);
+}
+
+inline auto abs(const __m256& reg) -> __m256 {
+    return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), reg);
+}
+
+inline auto sqrt(const __m256& reg) -> __m256 {
+    return _mm256_sqrt_ps(reg);
+}
+
+inline auto round(const __m256& reg) -> __m256 {
+    return _mm256_round_ps(reg, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+}
+
+inline auto less(const __m256& lhs, const __m256& rhs) -> __m256 {
+    return _mm256_cmp_ps(lhs, rhs, _CMP_LT_OQ);
+}
+
+inline auto select(const __m256& mask, const __m256& if_true, const __m256& if_false) -> __m256 {
+    return _mm256_blendv_ps(if_false, if_true, mask);
+}
+
+inline auto bitmask(const __m256& mask) -> std::uint32_t {
+    return static_cast<std::uint32_t>(_mm256_movemask_ps(mask));
+}
+#endif
+
+inline auto wide_load(const float* data) -> f32xw {
+#if ADMAT_SIMD_AVX512
+    return _mm512_loadu_ps(data);
+#elif ADMAT_SIMD_AVX
+    return _mm256_loadu_ps(data);
+#elif ADMAT_SIMD_SSE
+    return _mm_loadu_ps(data);
+#elif ADMAT_SIMD_NEON
+    return vld1q_f32(data);
+#else
+    return f32x4{{data[0], data[1], data[2], data[3]}}; // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+#endif
+}
+
+inline auto wide_store(float* data, const f32xw& reg) -> void {
+#if ADMAT_SIMD_AVX512
+    _mm512_storeu_ps(data, reg);
+#elif ADMAT_SIMD_AVX
+    _mm256_storeu_ps(data, reg);
+#elif ADMAT_SIMD_SSE
+    _mm_storeu_ps(data, reg);
+#elif ADMAT_SIMD_NEON
+    vst1q_f32(data, reg);
+#else
+    std::copy(reg.lanes.begin(), reg.lanes.end(), data);
+#endif
+}
+
+inline auto wide_broadcast(float value) -> f32xw {
+#if ADMAT_SIMD_AVX512
+    return _mm512_set1_ps(value);
+#elif ADMAT_SIMD_AVX
+    return _mm256_set1_ps(value);
+#else
+    return broadcast(value);
+#endif
+}
+
+// Repeat one 4 lane register into every 128 bit group
+inline auto wide_broadcast(const f32x4& reg) -> f32xw {
+#if ADMAT_SIMD_AVX512
+    return _mm512_broadcast_f32x4(reg);
+#elif ADMAT_SIMD_AVX
+    return _mm256_set_m128(reg, reg);
+#else
+    return reg;
+#endif
+}
+
+// Broadcast lane i of each 128 bit group across that group
+template<int i>
+inline auto wide_splat(const f32xw& reg) -> f32xw {
+    static_assert(i >= 0 && i < 4);
+#if ADMAT_SIMD_AVX512
+    return _mm512_permute_ps(reg, _MM_SHUFFLE(i, i, i, i));
+#elif ADMAT_SIMD_AVX
+    return _mm256_permute_ps(reg, _MM_SHUFFLE(i, i, i, i));
+#else
+    return shuffle<i, i, i, i>(reg);
+#endif
+}
+
+// Scalar overloads so one generic kernel body serves both the wide loop and the scalar tail
+inline auto add(float lhs, float rhs) -> float {
+    return lhs + rhs;
+}
+
+inline auto sub(float lhs, float rhs) -> float {
+    return lhs - rhs;
+}
+
+inline auto mul(float lhs, float rhs) -> float {
+    return lhs * rhs;
+}
+
+inline auto div(float lhs, float rhs) -> float {
+    return lhs / rhs;
+}
+
+inline auto fmadd(float a, float b, float c) -> float {
+    return a * b + c;
+}
+
+inline auto min(float lhs, float rhs) -> float {
+    return std::min(lhs, rhs);
+}
+
+inline auto max(float lhs, float rhs) -> float {
+    return std::max(lhs, rhs);
+}
+
+inline auto abs(float value) -> float {
+    return std::abs(value);
+}
+
+inline auto sqrt(float value) -> float {
+    return std::sqrt(value);
+}
+
+inline auto round(float value) -> float {
+    return std::nearbyint(value);
+}
+
+inline auto less(float lhs, float rhs) -> bool {
+    return lhs < rhs;
+}
+
+inline auto select(bool mask, float if_true, float if_false) -> float {
+    return mask ? if_true : if_false;
+}
+
+inline auto bitmask(bool mask) -> std::uint32_t {
+    return mask ? 1u : 0u;
+}
+
+// Passed to for_each_block kernels to pick wide registers or plain floats
+struct wide_tag {};
+struct scalar_tag {};
+
+inline auto broadcast(wide_tag /*tag*/, float value) -> f32xw {
+    return wide_broadcast(value);
+}
+
+inline auto broadcast(scalar_tag /*tag*/, float value) -> float {
+    return value;
+}
+
+inline auto load_lanes(wide_tag /*tag*/, const float* data) -> f32xw {
+    return wide_load(data);
+}
+
+inline auto load_lanes(scalar_tag /*tag*/, const float* data) -> float {
+    return *data;
+}
+
+inline auto store_lanes(float* data, const f32xw& reg) -> void {
+    wide_store(data, reg);
+}
+
+inline auto store_lanes(float* data, float value) -> void {
+    *data = value;
+}
+
+constexpr auto lane_count(wide_tag /*tag*/) -> std::size_t {
+    return wide_width;
+}
+
+constexpr auto lane_count(scalar_tag /*tag*/) -> std::size_t {
+    return 1;
+}
+
+// Overwrites bits [i, i + lane_count(tag)) of words with the low bits of mask, bit i being bit i % 64 of word i / 64.
+// for_each_block starts blocks at multiples of their width, which divides 64, so a block never straddles two words.
+template<typename Tag>
+inline auto store_bits(Tag tag, std::span<std::uint64_t> words, std::size_t i, std::uint32_t mask) -> void {
+    auto lanes    = (std::uint64_t{1} << lane_count(tag)) - 1;
+    auto shift    = i % 64;
+    words[i / 64] = (words[i / 64] & ~(lanes << shift)) | ((mask & lanes) << shift);
+}
+
+// Calls kernel(index, wide_tag{}) for every full block of wide_width elements in [begin, end), then
+// kernel(index, scalar_tag{}) for each element of the tail. Kernels load, compute and store through the tag
+// dependent overloads above. Ranges starting at a multiple of 64 keep store_bits blocks within one word.
+template<typename Kernel>
+inline auto for_each_block(std::size_t begin, std::size_t end, Kernel&& kernel) -> void {
+    assert(begin <= end);
+
+    // The tail is counted as a remainder below wide_width, which also lets GCC bound it without assuming the
+    // indices might wrap around
+    auto tail = (end - begin) % wide_width;
+    auto i    = begin;
+    for(; i < end - tail; i += wide_width) {
+        kernel(i, wide_tag{});
+    }
+
+    for(std::size_t lane = 0; lane < tail; ++lane) {
+        kernel(i + lane, scalar_tag{});
+    }
+}
+
+template<typename Kernel>
+inline auto for_each_block(std::size_t count, Kernel&& kernel) -> void {
+    for_each_block(0, count, kernel);
+}
+
+} // namespace admat::simd
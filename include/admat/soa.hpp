@@ -0,0 +1,633 @@
+#pragma once
+
+#include "admat/executor.hpp"
+#include "admat/simd.hpp"
+#include "admat/vec.hpp"
+
+#include <cassert>
+#include <cstddef>
+#include <new>
+#include <span>
+#include <vector>
+
+namespace admat {
+
+// Hands out storage aligned to a cache line, which is also the widest SIMD register
+template<typename T, std::size_t alignment = 64>
+struct aligned_allocator {
+    using value_type = T;
+
+    template<typename U>
+    struct rebind {
+        using other = aligned_allocator<U, alignment>;
+    };
+
+    constexpr aligned_allocator() noexcept = default;
+
+    template<typename U>
+    constexpr aligned_allocator(const aligned_allocator<U, alignment>& /*other*/) noexcept {}
+
+    auto allocate(std::size_t count) -> T* {
+        return static_cast<T*>(::operator new(count * sizeof(T), std::align_val_t{alignment}));
+    }
+
+    auto deallocate(T* ptr, std::size_t count) noexcept -> void {
+        ::operator delete(ptr, count * sizeof(T), std::align_val_t{alignment});
+    }
+
+    template<typename U>
+    constexpr auto operator==(const aligned_allocator<U, alignment>& /*other*/) const noexcept -> bool {
+        return true;
+    }
+};
+
+template<typename T>
+using aligned_vector = std::vector<T, aligned_allocator<T>>;
+
+// Structure of arrays storage for vec3, one aligned array per component
+struct vec3_soa {
+    aligned_vector<float> x;
+    aligned_vector<float> y;
+    aligned_vector<float> z;
+
+    vec3_soa() = default;
+    explicit vec3_soa(std::size_t count) : x(count), y(count), z(count) {}
+
+    static auto from_aos(std::span<const vec3> data) -> vec3_soa {
+        auto soa = vec3_soa(data.size());
+        for(std::size_t i = 0; i < data.size(); ++i) {
+            soa.set(i, data[i]);
+        }
+        return soa;
+    }
+
+    auto to_aos(std::span<vec3> out) const -> void {
+        assert(out.size() >= size());
+        for(std::size_t i = 0; i < size(); ++i) {
+            out[i] = (*this)[i];
+        }
+    }
+
+    auto size() const -> std::size_t {
+        return x.size();
+    }
+
+    auto resize(std::size_t count) -> void {
+        x.resize(count);
+        y.resize(count);
+        z.resize(count);
+    }
+
+    auto push_back(const vec3& vec) -> void {
+        x.push_back(vec.x);
+        y.push_back(vec.y);
+        z.push_back(vec.z);
+    }
+
+    auto set(std::size_t idx, const vec3& vec) -> void {
+        x[idx] = vec.x;
+        y[idx] = vec.y;
+        z[idx] = vec.z;
+    }
+
+    auto operator[](std::size_t idx) const -> vec3 {
+        return vec3{x[idx], y[idx], z[idx]};
+    }
+};
+
+// Structure of arrays storage for vec4, one aligned array per component
+struct vec4_soa {
+    aligned_vector<float> w;
+    aligned_vector<float> x;
+    aligned_vector<float> y;
+    aligned_vector<float> z;
+
+    vec4_soa() = default;
+    explicit vec4_soa(std::size_t count) : w(count), x(count), y(count), z(count) {}
+
+    static auto from_aos(std::span<const vec4> data) -> vec4_soa {
+        auto soa = vec4_soa(data.size());
+        for(std::size_t i = 0; i < data.size(); ++i) {
+            soa.set(i, data[i]);
+        }
+        return soa;
+    }
+
+    auto to_aos(std::span<vec4> out) const -> void {
+        assert(out.size() >= size());
+        for(std::size_t i = 0; i < size(); ++i) {
+            out[i] = (*this)[i];
+        }
+    }
+
+    auto size() const -> std::size_t {
+        return w.size();
+    }
+
+    auto resize(std::size_t count) -> void {
+        w.resize(count);
+        x.resize(count);
+        y.resize(count);
+        z.resize(count);
+    }
+
+    auto push_back(const vec4& vec) -> void {
+        w.push_back(vec.w);
+        x.push_back(vec.x);
+        y.push_back(vec.y);
+        z.push_back(vec.z);
+    }
+
+    auto set(std::size_t idx, const vec4& vec) -> void {
+        w[idx] = vec.w;
+        x[idx] = vec.x;
+        y[idx] = vec.y;
+        z[idx] = vec.z;
+    }
+
+    auto operator[](std::size_t idx) const -> vec4 {
+        return vec4{w[idx], x[idx], y[idx], z[idx]};
+    }
+};
+
+namespace simd {
+
+// The kernels of the functions below over elements [begin, end), for the serial versions and the chunks of the
+// executor ones. Outputs are already sized.
+
+inline auto dot(const vec3_soa& lhs,
+                const vec3_soa& rhs,
+                std::span<float> out,
+                std::size_t begin,
+                std::size_t end) -> void {
+    for_each_block(begin, end, [&](std::size_t i, auto tag) {
+        auto result = simd::mul(simd::load_lanes(tag, &lhs.x[i]), simd::load_lanes(tag, &rhs.x[i]));
+        result      = simd::fmadd(simd::load_lanes(tag, &lhs.y[i]), simd::load_lanes(tag, &rhs.y[i]), result);
+        result      = simd::fmadd(simd::load_lanes(tag, &lhs.z[i]), simd::load_lanes(tag, &rhs.z[i]), result);
+        simd::store_lanes(&out[i], result);
+    });
+}
+
+inline auto dot(const vec4_soa& lhs,
+                const vec4_soa& rhs,
+                std::span<float> out,
+                std::size_t begin,
+                std::size_t end) -> void {
+    for_each_block(begin, end, [&](std::size_t i, auto tag) {
+        auto result = simd::mul(simd::load_lanes(tag, &lhs.w[i]), simd::load_lanes(tag, &rhs.w[i]));
+        result      = simd::fmadd(simd::load_lanes(tag, &lhs.x[i]), simd::load_lanes(tag, &rhs.x[i]), result);
+        result      = simd::fmadd(simd::load_lanes(tag, &lhs.y[i]), simd::load_lanes(tag, &rhs.y[i]), result);
+        result      = simd::fmadd(simd::load_lanes(tag, &lhs.z[i]), simd::load_lanes(tag, &rhs.z[i]), result);
+        simd::store_lanes(&out[i], result);
+    });
+}
+
+inline auto cross(const vec3_soa& lhs, const vec3_soa& rhs, vec3_soa& out, std::size_t begin, std::size_t end) -> void {
+    for_each_block(begin, end, [&](std::size_t i, auto tag) {
+        auto lx = simd::load_lanes(tag, &lhs.x[i]);
+        auto ly = simd::load_lanes(tag, &lhs.y[i]);
+        auto lz = simd::load_lanes(tag, &lhs.z[i]);
+        auto rx = simd::load_lanes(tag, &rhs.x[i]);
+        auto ry = simd::load_lanes(tag, &rhs.y[i]);
+        auto rz = simd::load_lanes(tag, &rhs.z[i]);
+
+        simd::store_lanes(&out.x[i], simd::sub(simd::mul(ly, rz), simd::mul(lz, ry)));
+        simd::store_lanes(&out.y[i], simd::sub(simd::mul(lz, rx), simd::mul(lx, rz)));
+        simd::store_lanes(&out.z[i], simd::sub(simd::mul(lx, ry), simd::mul(ly, rx)));
+    });
+}
+
+inline auto normalize(const vec3_soa& vecs, vec3_soa& out, std::size_t begin, std::size_t end) -> void {
+    for_each_block(begin, end, [&](std::size_t i, auto tag) {
+        auto x = simd::load_lanes(tag, &vecs.x[i]);
+        auto y = simd::load_lanes(tag, &vecs.y[i]);
+        auto z = simd::load_lanes(tag, &vecs.z[i]);
+
+        auto length = simd::sqrt(simd::fmadd(x, x, simd::fmadd(y, y, simd::mul(z, z))));
+
+        simd::store_lanes(&out.x[i], simd::div(x, length));
+        simd::store_lanes(&out.y[i], simd::div(y, length));
+        simd::store_lanes(&out.z[i], simd::div(z, length));
+    });
+}
+
+inline auto normalize(const vec4_soa& vecs, vec4_soa& out, std::size_t begin, std::size_t end) -> void {
+    for_each_block(begin, end, [&](std::size_t i, auto tag) {
+        auto w = simd::load_lanes(tag, &vecs.w[i]);
+        auto x = simd::load_lanes(tag, &vecs.x[i]);
+        auto y = simd::load_lanes(tag, &vecs.y[i]);
+        auto z = simd::load_lanes(tag, &vecs.z[i]);
+
+        auto length = simd::sqrt(simd::fmadd(w, w, simd::fmadd(x, x, simd::fmadd(y, y, simd::mul(z, z)))));
+
+        simd::store_lanes(&out.w[i], simd::div(w, length));
+        simd::store_lanes(&out.x[i], simd::div(x, length));
+        simd::store_lanes(&out.y[i], simd::div(y, length));
+        simd::store_lanes(&out.z[i], simd::div(z, length));
+    });
+}
+
+inline auto distance(const vec3_soa& lhs,
+                     const vec3_soa& rhs,
+                     std::span<float> out,
+                     std::size_t begin,
+                     std::size_t end) -> void {
+    for_each_block(begin, end, [&](std::size_t i, auto tag) {
+        auto x = simd::sub(simd::load_lanes(tag, &rhs.x[i]), simd::load_lanes(tag, &lhs.x[i]));
+        auto y = simd::sub(simd::load_lanes(tag, &rhs.y[i]), simd::load_lanes(tag, &lhs.y[i]));
+        auto z = simd::sub(simd::load_lanes(tag, &rhs.z[i]), simd::load_lanes(tag, &lhs.z[i]));
+
+        simd::store_lanes(&out[i], simd::sqrt(simd::fmadd(x, x, simd::fmadd(y, y, simd::mul(z, z)))));
+    });
+}
+
+inline auto distance(const vec4_soa& lhs,
+                     const vec4_soa& rhs,
+                     std::span<float> out,
+                     std::size_t begin,
+                     std::size_t end) -> void {
+    for_each_block(begin, end, [&](std::size_t i, auto tag) {
+        auto w = simd::sub(simd::load_lanes(tag, &rhs.w[i]), simd::load_lanes(tag, &lhs.w[i]));
+        auto x = simd::sub(simd::load_lanes(tag, &rhs.x[i]), simd::load_lanes(tag, &lhs.x[i]));
+        auto y = simd::sub(simd::load_lanes(tag, &rhs.y[i]), simd::load_lanes(tag, &lhs.y[i]));
+        auto z = simd::sub(simd::load_lanes(tag, &rhs.z[i]), simd::load_lanes(tag, &lhs.z[i]));
+
+        auto squared = simd::fmadd(w, w, simd::fmadd(x, x, simd::fmadd(y, y, simd::mul(z, z))));
+        simd::store_lanes(&out[i], simd::sqrt(squared));
+    });
+}
+
+inline auto lerp(const vec3_soa& from,
+                 const vec3_soa& to,
+                 float delta,
+                 vec3_soa& out,
+                 std::size_t begin,
+                 std::size_t end) -> void {
+    for_each_block(begin, end, [&](std::size_t i, auto tag) {
+        auto t     = simd::broadcast(tag, delta);
+        auto t_inv = simd::broadcast(tag, 1.0f - delta);
+        auto blend = [&](const float* a, const float* b) {
+            return simd::fmadd(simd::load_lanes(tag, b), t, simd::mul(simd::load_lanes(tag, a), t_inv));
+        };
+
+        simd::store_lanes(&out.x[i], blend(&from.x[i], &to.x[i]));
+        simd::store_lanes(&out.y[i], blend(&from.y[i], &to.y[i]));
+        simd::store_lanes(&out.z[i], blend(&from.z[i], &to.z[i]));
+    });
+}
+
+inline auto lerp(const vec4_soa& from,
+                 const vec4_soa& to,
+                 float delta,
+                 vec4_soa& out,
+                 std::size_t begin,
+                 std::size_t end) -> void {
+    for_each_block(begin, end, [&](std::size_t i, auto tag) {
+        auto t     = simd::broadcast(tag, delta);
+        auto t_inv = simd::broadcast(tag, 1.0f - delta);
+        auto blend = [&](const float* a, const float* b) {
+            return simd::fmadd(simd::load_lanes(tag, b), t, simd::mul(simd::load_lanes(tag, a), t_inv));
+        };
+
+        simd::store_lanes(&out.w[i], blend(&from.w[i], &to.w[i]));
+        simd::store_lanes(&out.x[i], blend(&from.x[i], &to.x[i]));
+        simd::store_lanes(&out.y[i], blend(&from.y[i], &to.y[i]));
+        simd::store_lanes(&out.z[i], blend(&from.z[i], &to.z[i]));
+    });
+}
+
+inline auto clamp(const vec3_soa& vecs,
+                  float min,
+                  float max,
+                  vec3_soa& out,
+                  std::size_t begin,
+                  std::size_t end) -> void {
+    for_each_block(begin, end, [&](std::size_t i, auto tag) {
+        auto lower = simd::broadcast(tag, min);
+        auto upper = simd::broadcast(tag, max);
+        auto bound = [&](const float* value) {
+            return simd::min(simd::max(simd::load_lanes(tag, value), lower), upper);
+        };
+
+        simd::store_lanes(&out.x[i], bound(&vecs.x[i]));
+        simd::store_lanes(&out.y[i], bound(&vecs.y[i]));
+        simd::store_lanes(&out.z[i], bound(&vecs.z[i]));
+    });
+}
+
+inline auto clamp(const vec4_soa& vecs,
+                  float min,
+                  float max,
+                  vec4_soa& out,
+                  std::size_t begin,
+                  std::size_t end) -> void {
+    for_each_block(begin, end, [&](std::size_t i, auto tag) {
+        auto lower = simd::broadcast(tag, min);
+        auto upper = simd::broadcast(tag, max);
+        auto bound = [&](const float* value) {
+            return simd::min(simd::max(simd::load_lanes(tag, value), lower), upper);
+        };
+
+        simd::store_lanes(&out.w[i], bound(&vecs.w[i]));
+        simd::store_lanes(&out.x[i], bound(&vecs.x[i]));
+        simd::store_lanes(&out.y[i], bound(&vecs.y[i]));
+        simd::store_lanes(&out.z[i], bound(&vecs.z[i]));
+    });
+}
+
+inline auto reflect(const vec3_soa& incident,
+                    const vec3_soa& normal,
+                    vec3_soa& out,
+                    std::size_t begin,
+                    std::size_t end) -> void {
+    for_each_block(begin, end, [&](std::size_t i, auto tag) {
+        auto ix = simd::load_lanes(tag, &incident.x[i]);
+        auto iy = simd::load_lanes(tag, &incident.y[i]);
+        auto iz = simd::load_lanes(tag, &incident.z[i]);
+        auto nx = simd::load_lanes(tag, &normal.x[i]);
+        auto ny = simd::load_lanes(tag, &normal.y[i]);
+        auto nz = simd::load_lanes(tag, &normal.z[i]);
+
+        auto cos_i = simd::fmadd(nx, ix, simd::fmadd(ny, iy, simd::mul(nz, iz)));
+        auto scale = simd::mul(simd::broadcast(tag, -2.0f), cos_i);
+
+        simd::store_lanes(&out.x[i], simd::fmadd(nx, scale, ix));
+        simd::store_lanes(&out.y[i], simd::fmadd(ny, scale, iy));
+        simd::store_lanes(&out.z[i], simd::fmadd(nz, scale, iz));
+    });
+}
+
+inline auto refract(const vec3_soa& incident,
+                    const vec3_soa& normal,
+                    float ratio,
+                    vec3_soa& out,
+                    std::size_t begin,
+                    std::size_t end) -> void {
+    for_each_block(begin, end, [&](std::size_t i, auto tag) {
+        auto ix = simd::load_lanes(tag, &incident.x[i]);
+        auto iy = simd::load_lanes(tag, &incident.y[i]);
+        auto iz = simd::load_lanes(tag, &incident.z[i]);
+        auto nx = simd::load_lanes(tag, &normal.x[i]);
+        auto ny = simd::load_lanes(tag, &normal.y[i]);
+        auto nz = simd::load_lanes(tag, &normal.z[i]);
+
+        auto zero  = simd::broadcast(tag, 0.0f);
+        auto one   = simd::broadcast(tag, 1.0f);
+        auto eta   = simd::broadcast(tag, ratio);
+        auto cos_i = simd::fmadd(nx, ix, simd::fmadd(ny, iy, simd::mul(nz, iz)));
+
+        // 1 - ratio^2 * (1 - cos_i^2)
+        auto constant = simd::sub(one, simd::mul(simd::mul(eta, eta), simd::sub(one, simd::mul(cos_i, cos_i))));
+        auto internal = simd::less(constant, zero);
+        auto scale    = simd::fmadd(eta, cos_i, simd::sqrt(simd::max(constant, zero)));
+
+        simd::store_lanes(&out.x[i], simd::select(internal, zero, simd::sub(simd::mul(ix, eta), simd::mul(scale, nx))));
+        simd::store_lanes(&out.y[i], simd::select(internal, zero, simd::sub(simd::mul(iy, eta), simd::mul(scale, ny))));
+        simd::store_lanes(&out.z[i], simd::select(internal, zero, simd::sub(simd::mul(iz, eta), simd::mul(scale, nz))));
+    });
+}
+
+} // namespace simd
+
+// Batched versions of the vec.hpp free functions. Every element i of the inputs produces element i of out.
+// Vector outputs are resized to the input size and may be one of the inputs.
+
+inline auto dot(const vec3_soa& lhs, const vec3_soa& rhs, std::span<float> out) -> void {
+    assert(lhs.size() == rhs.size() && out.size() >= lhs.size());
+    simd::dot(lhs, rhs, out, 0, lhs.size());
+}
+
+inline auto dot(const vec4_soa& lhs, const vec4_soa& rhs, std::span<float> out) -> void {
+    assert(lhs.size() == rhs.size() && out.size() >= lhs.size());
+    simd::dot(lhs, rhs, out, 0, lhs.size());
+}
+
+inline auto cross(const vec3_soa& lhs, const vec3_soa& rhs, vec3_soa& out) -> void {
+    assert(lhs.size() == rhs.size());
+    out.resize(lhs.size());
+    simd::cross(lhs, rhs, out, 0, lhs.size());
+}
+
+inline auto normalize(const vec3_soa& vecs, vec3_soa& out) -> void {
+    out.resize(vecs.size());
+    simd::normalize(vecs, out, 0, vecs.size());
+}
+
+inline auto normalize(const vec4_soa& vecs, vec4_soa& out) -> void {
+    out.resize(vecs.size());
+    simd::normalize(vecs, out, 0, vecs.size());
+}
+
+inline auto distance(const vec3_soa& lhs, const vec3_soa& rhs, std::span<float> out) -> void {
+    assert(lhs.size() == rhs.size() && out.size() >= lhs.size());
+    simd::distance(lhs, rhs, out, 0, lhs.size());
+}
+
+inline auto distance(const vec4_soa& lhs, const vec4_soa& rhs, std::span<float> out) -> void {
+    assert(lhs.size() == rhs.size() && out.size() >= lhs.size());
+    simd::distance(lhs, rhs, out, 0, lhs.size());
+}
+
+inline auto lerp(const vec3_soa& from, const vec3_soa& to, float delta, vec3_soa& out) -> void {
+    assert(from.size() == to.size());
+    out.resize(from.size());
+    simd::lerp(from, to, delta, out, 0, from.size());
+}
+
+inline auto lerp(const vec4_soa& from, const vec4_soa& to, float delta, vec4_soa& out) -> void {
+    assert(from.size() == to.size());
+    out.resize(from.size());
+    simd::lerp(from, to, delta, out, 0, from.size());
+}
+
+inline auto clamp(const vec3_soa& vecs, float min, float max, vec3_soa& out) -> void {
+    out.resize(vecs.size());
+    simd::clamp(vecs, min, max, out, 0, vecs.size());
+}
+
+inline auto clamp(const vec4_soa& vecs, float min, float max, vec4_soa& out) -> void {
+    out.resize(vecs.size());
+    simd::clamp(vecs, min, max, out, 0, vecs.size());
+}
+
+inline auto reflect(const vec3_soa& incident, const vec3_soa& normal, vec3_soa& out) -> void {
+    assert(incident.size() == normal.size());
+    out.resize(incident.size());
+    simd::reflect(incident, normal, out, 0, incident.size());
+}
+
+// Lanes with total internal reflection are set to zero, like refract()
+inline auto refract(const vec3_soa& incident, const vec3_soa& normal, float ratio, vec3_soa& out) -> void {
+    assert(incident.size() == normal.size());
+    out.resize(incident.size());
+    simd::refract(incident, normal, ratio, out, 0, incident.size());
+}
+
+// Executor versions of the above, run through exec in chunks of grain elements. Vector outputs are resized once, on
+// the calling thread, before any chunk runs.
+
+template<typename Executor>
+inline auto dot(Executor&& exec,
+                const vec3_soa& lhs,
+                const vec3_soa& rhs,
+                std::span<float> out,
+                std::size_t grain = default_grain) -> void {
+    assert(lhs.size() == rhs.size() && out.size() >= lhs.size());
+    parallel_for(exec, lhs.size(), grain, [&](std::size_t begin, std::size_t end) {
+        simd::dot(lhs, rhs, out, begin, end);
+    });
+}
+
+template<typename Executor>
+inline auto dot(Executor&& exec,
+                const vec4_soa& lhs,
+                const vec4_soa& rhs,
+                std::span<float> out,
+                std::size_t grain = default_grain) -> void {
+    assert(lhs.size() == rhs.size() && out.size() >= lhs.size());
+    parallel_for(exec, lhs.size(), grain, [&](std::size_t begin, std::size_t end) {
+        simd::dot(lhs, rhs, out, begin, end);
+    });
+}
+
+template<typename Executor>
+inline auto cross(Executor&& exec,
+                  const vec3_soa& lhs,
+                  const vec3_soa& rhs,
+                  vec3_soa& out,
+                  std::size_t grain = default_grain) -> void {
+    assert(lhs.size() == rhs.size());
+    out.resize(lhs.size());
+    parallel_for(exec, lhs.size(), grain, [&](std::size_t begin, std::size_t end) {
+        simd::cross(lhs, rhs, out, begin, end);
+    });
+}
+
+template<typename Executor>
+inline auto normalize(Executor&& exec,
+                      const vec3_soa& vecs,
+                      vec3_soa& out,
+                      std::size_t grain = default_grain) -> void {
+    out.resize(vecs.size());
+    parallel_for(exec, vecs.size(), grain, [&](std::size_t begin, std::size_t end) {
+        simd::normalize(vecs, out, begin, end);
+    });
+}
+
+template<typename Executor>
+inline auto normalize(Executor&& exec,
+                      const vec4_soa& vecs,
+                      vec4_soa& out,
+                      std::size_t grain = default_grain) -> void {
+    out.resize(vecs.size());
+    parallel_for(exec, vecs.size(), grain, [&](std::size_t begin, std::size_t end) {
+        simd::normalize(vecs, out, begin, end);
+    });
+}
+
+template<typename Executor>
+inline auto distance(Executor&& exec,
+                     const vec3_soa& lhs,
+                     const vec3_soa& rhs,
+                     std::span<float> out,
+                     std::size_t grain = default_grain) -> void {
+    assert(lhs.size() == rhs.size() && out.size() >= lhs.size());
+    parallel_for(exec, lhs.size(), grain, [&](std::size_t begin, std::size_t end) {
+        simd::distance(lhs, rhs, out, begin, end);
+    });
+}
+
+template<typename Executor>
+inline auto distance(Executor&& exec,
+                     const vec4_soa& lhs,
+                     const vec4_soa& rhs,
+                     std::span<float> out,
+                     std::size_t grain = default_grain) -> void {
+    assert(lhs.size() == rhs.size() && out.size() >= lhs.size());
+    parallel_for(exec, lhs.size(), grain, [&](std::size_t begin, std::size_t end) {
+        simd::distance(lhs, rhs, out, begin, end);
+    });
+}
+
+template<typename Executor>
+inline auto lerp(Executor&& exec,
+                 const vec3_soa& from,
+                 const vec3_soa& to,
+                 float delta,
+                 vec3_soa& out,
+                 std::size_t grain = default_grain) -> void {
+    assert(from.size() == to.size());
+    out.resize(from.size());
+    parallel_for(exec, from.size(), grain, [&](std::size_t begin, std::size_t end) {
+        simd::lerp(from, to, delta, out, begin, end);
+    });
+}
+
+template<typename Executor>
+inline auto lerp(Executor&& exec,
+                 const vec4_soa& from,
+                 const vec4_soa& to,
+                 float delta,
+                 vec4_soa& out,
+                 std::size_t grain = default_grain) -> void {
+    assert(from.size() == to.size());
+    out.resize(from.size());
+    parallel_for(exec, from.size(), grain, [&](std::size_t begin, std::size_t end) {
+        simd::lerp(from, to, delta, out, begin, end);
+    });
+}
+
+template<typename Executor>
+inline auto clamp(Executor&& exec,
+                  const vec3_soa& vecs,
+                  float min,
+                  float max,
+                  vec3_soa& out,
+                  std::size_t grain = default_grain) -> void {
+    out.resize(vecs.size());
+    parallel_for(exec, vecs.size(), grain, [&](std::size_t begin, std::size_t end) {
+        simd::clamp(vecs, min, max, out, begin, end);
+    });
+}
+
+template<typename Executor>
+inline auto clamp(Executor&& exec,
+                  const vec4_soa& vecs,
+                  float min,
+                  float max,
+                  vec4_soa& out,
+                  std::size_t grain = default_grain) -> void {
+    out.resize(vecs.size());
+    parallel_for(exec, vecs.size(), grain, [&](std::size_t begin, std::size_t end) {
+        simd::clamp(vecs, min, max, out, begin, end);
+    });
+}
+
+template<typename Executor>
+inline auto reflect(Executor&& exec,
+                    const vec3_soa& incident,
+                    const vec3_soa& normal,
+                    vec3_soa& out,
+                    std::size_t grain = default_grain) -> void {
+    assert(incident.size() == normal.size());
+    out.resize(incident.size());
+    parallel_for(exec, incident.size(), grain, [&](std::size_t begin, std::size_t end) {
+        simd::reflect(incident, normal, out, begin, end);
+    });
+}
+
+template<typename Executor>
+inline auto refract(Executor&& exec,
+                    const vec3_soa& incident,
+                    const vec3_soa& normal,
+                    float ratio,
+                    vec3_soa& out,
+                    std::size_t grain = default_grain) -> void {
+    assert(incident.size() == normal.size());
+    out.resize(incident.size());
+    parallel_for(exec, incident.size(), grain, [&](std::size_t begin, std::size_t end) {
+        simd::refract(incident, normal, ratio, out, begin, end);
+    });
+}
+
+} // namespace admat
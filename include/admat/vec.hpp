@@ -1,42 +1,76 @@
 #pragma once
 
+#include "admat/simd.hpp"
+
 #include <algorithm>
 #include <array>
+#include <cassert>
 #include <cmath>
 #include <cstddef>
+#include <cstdint>
 #include <type_traits>
+#include <utility>
 
 namespace admat {
 
-struct vec2 {
-    float x;
-    float y;
+// N component vector of T. The sizes are specialized so components keep their names, and vec<T, 4> lists w first,
+// matching the lane order the SIMD kernels load it in.
+template<typename T, std::size_t N>
+struct vec;
 
-    constexpr auto operator[](std::size_t idx) const -> float {
+template<typename T>
+struct vec<T, 2> {
+    T x;
+    T y;
+
+    constexpr auto operator[](std::size_t idx) const -> const T& {
+        assert(idx < 2);
+        if(std::is_constant_evaluated()) {
+            return idx == 0 ? x : y;
+        }
+        return *(&(this->x) + idx); // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    }
 
+    constexpr auto operator[](std::size_t idx) -> T& {
+        assert(idx < 2);
+        if(std::is_constant_evaluated()) {
+            return idx == 0 ? x : y;
+        }
         return *(&(this->x) + idx); // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
     }
 
-    static constexpr auto from_array(const std::array<float, 2>& data) -> vec2 {
-        return vec2{
+    static constexpr auto from_array(const std::array<T, 2>& data) -> vec {
+        return vec{
             data.at(0),
             data.at(1),
         };
     }
 };
 
-struct vec3 {
-    float x;
-    float y;
-    float z;
-
-    constexpr auto operator[](std::size_t idx) const -> float {
+template<typename T>
+struct vec<T, 3> {
+    T x;
+    T y;
+    T z;
+
+    constexpr auto operator[](std::size_t idx) const -> const T& {
+        assert(idx < 3);
+        if(std::is_constant_evaluated()) {
+            return idx == 0 ? x : idx == 1 ? y : z;
+        }
+        return *(&(this->x) + idx); // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    }
 
+    constexpr auto operator[](std::size_t idx) -> T& {
+        assert(idx < 3);
+        if(std::is_constant_evaluated()) {
+            return idx == 0 ? x : idx == 1 ? y : z;
+        }
         return *(&(this->x) + idx); // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
     }
 
-    static constexpr auto from_array(const std::array<float, 3>& data) -> vec3 {
-        return vec3{
+    static constexpr auto from_array(const std::array<T, 3>& data) -> vec {
+        return vec{
             data.at(0),
             data.at(1),
             data.at(2),
@@ -44,18 +78,31 @@ struct vec3 {
     }
 };
 
-struct vec4 {
-    float w;
-    float x;
-    float y;
-    float z;
+template<typename T>
+struct vec<T, 4> {
+    T w;
+    T x;
+    T y;
+    T z;
+
+    constexpr auto operator[](std::size_t idx) const -> const T& {
+        assert(idx < 4);
+        if(std::is_constant_evaluated()) {
+            return idx == 0 ? w : idx == 1 ? x : idx == 2 ? y : z;
+        }
+        return *(&(this->w) + idx); // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    }
 
-    constexpr auto operator[](std::size_t idx) const -> float {
-        return *(&(this->x) + idx); // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    constexpr auto operator[](std::size_t idx) -> T& {
+        assert(idx < 4);
+        if(std::is_constant_evaluated()) {
+            return idx == 0 ? w : idx == 1 ? x : idx == 2 ? y : z;
+        }
+        return *(&(this->w) + idx); // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
     }
 
-    static constexpr auto from_array(const std::array<float, 4>& data) -> vec4 {
-        return vec4{
+    static constexpr auto from_array(const std::array<T, 4>& data) -> vec {
+        return vec{
             data.at(0),
             data.at(1),
             data.at(2),
@@ -64,86 +111,114 @@ struct vec4 {
     }
 };
 
-static_assert(std::is_standard_layout_v<vec2> && std::is_trivial_v<vec2>, "vec2 not pod");
-static_assert(std::is_standard_layout_v<vec3> && std::is_trivial_v<vec3>, "vec3 not pod");
-static_assert(std::is_standard_layout_v<vec4> && std::is_trivial_v<vec4>, "vec4 not pod");
+using vec2 = vec<float, 2>;
+using vec3 = vec<float, 3>;
+using vec4 = vec<float, 4>;
 
-constexpr auto operator+(const vec2& lhs, const vec2& rhs) -> vec2 {
-    return vec2{lhs.x + rhs.x, lhs.y + rhs.y};
-}
+using dvec2 = vec<double, 2>;
+using dvec3 = vec<double, 3>;
+using dvec4 = vec<double, 4>;
 
-constexpr auto operator-(const vec2& lhs, const vec2& rhs) -> vec2 {
-    return vec2{lhs.x - rhs.x, lhs.y - rhs.y};
-}
+using ivec2 = vec<std::int32_t, 2>;
+using ivec3 = vec<std::int32_t, 3>;
+using ivec4 = vec<std::int32_t, 4>;
 
-constexpr auto operator-(const vec2& vec) -> vec2 {
-    return vec2{-vec.x, -vec.y};
-}
+static_assert(std::is_standard_layout_v<vec2> && std::is_trivial_v<vec2>, "vec2 not pod");
+static_assert(std::is_standard_layout_v<vec3> && std::is_trivial_v<vec3>, "vec3 not pod");
+static_assert(std::is_standard_layout_v<vec4> && std::is_trivial_v<vec4>, "vec4 not pod");
+static_assert(sizeof(dvec3) == 3 * sizeof(double) && sizeof(ivec4) == 4 * sizeof(std::int32_t), "vec is padded");
 
-constexpr auto operator*(const vec2& lhs, const vec2& rhs) -> vec2 {
-    return vec2{lhs.x * rhs.x, lhs.y * rhs.y};
+// vec<T, N>{fn(0), ..., fn(N - 1)}
+template<typename T, std::size_t N, typename Fn>
+constexpr auto make_vec(Fn&& fn) -> vec<T, N> {
+    return [&]<std::size_t... idx>(std::index_sequence<idx...>) {
+        return vec<T, N>{static_cast<T>(fn(idx))...};
+    }(std::make_index_sequence<N>{});
 }
 
-constexpr auto operator/(const vec2& lhs, const vec2& rhs) -> vec2 {
-    return vec2{lhs.x / rhs.x, lhs.y / rhs.y};
-}
+// The templates below serve every size and type one component at a time. vec4 keeps hand written SIMD overloads,
+// which overload resolution picks over the templates, so aliasing it costs nothing.
 
-constexpr auto operator+(const vec3& lhs, const vec3& rhs) -> vec3 {
-    return vec3{lhs.x + rhs.x, lhs.y + rhs.y, lhs.z + rhs.z};
+template<typename T, std::size_t N>
+constexpr auto operator+(const vec<T, N>& lhs, const vec<T, N>& rhs) -> vec<T, N> {
+    return make_vec<T, N>([&](std::size_t i) { return lhs[i] + rhs[i]; });
 }
 
-constexpr auto operator-(const vec3& lhs, const vec3& rhs) -> vec3 {
-    return vec3{lhs.x - rhs.x, lhs.y - rhs.y, lhs.z - rhs.z};
+template<typename T, std::size_t N>
+constexpr auto operator-(const vec<T, N>& lhs, const vec<T, N>& rhs) -> vec<T, N> {
+    return make_vec<T, N>([&](std::size_t i) { return lhs[i] - rhs[i]; });
 }
 
-constexpr auto operator-(const vec3& vec) -> vec3 {
-    return vec3{-vec.x, -vec.y, -vec.z};
+template<typename T, std::size_t N>
+constexpr auto operator-(const vec<T, N>& value) -> vec<T, N> {
+    return make_vec<T, N>([&](std::size_t i) { return -value[i]; });
 }
 
-constexpr auto operator*(const vec3& lhs, const vec3& rhs) -> vec3 {
-    return vec3{lhs.x * rhs.x, lhs.y * rhs.y, lhs.z * rhs.z};
+template<typename T, std::size_t N>
+constexpr auto operator*(const vec<T, N>& lhs, const vec<T, N>& rhs) -> vec<T, N> {
+    return make_vec<T, N>([&](std::size_t i) { return lhs[i] * rhs[i]; });
 }
 
-constexpr auto operator/(const vec3& lhs, const vec3& rhs) -> vec3 {
-    return vec3{lhs.x / rhs.x, lhs.y / rhs.y, lhs.z / rhs.z};
+template<typename T, std::size_t N>
+constexpr auto operator/(const vec<T, N>& lhs, const vec<T, N>& rhs) -> vec<T, N> {
+    return make_vec<T, N>([&](std::size_t i) { return lhs[i] / rhs[i]; });
 }
 
 constexpr auto operator+(const vec4& lhs, const vec4& rhs) -> vec4 {
+    if(!std::is_constant_evaluated()) {
+        return simd::store<vec4>(simd::add(simd::load(lhs), simd::load(rhs)));
+    }
+
     return vec4{lhs.w + rhs.w, lhs.x + rhs.x, lhs.y + rhs.y, lhs.z + rhs.z};
 }
 
 constexpr auto operator-(const vec4& lhs, const vec4& rhs) -> vec4 {
+    if(!std::is_constant_evaluated()) {
+        return simd::store<vec4>(simd::sub(simd::load(lhs), simd::load(rhs)));
+    }
+
     return vec4{lhs.w - rhs.w, lhs.x - rhs.x, lhs.y - rhs.y, lhs.z - rhs.z};
 }
 
 constexpr auto operator-(const vec4& vec) -> vec4 {
+    if(!std::is_constant_evaluated()) {
+        return simd::store<vec4>(simd::neg(simd::load(vec)));
+    }
+
     return vec4{-vec.w, -vec.x, -vec.y, -vec.z};
 }
 
 constexpr auto operator*(const vec4& lhs, const vec4& rhs) -> vec4 {
+    if(!std::is_constant_evaluated()) {
+        return simd::store<vec4>(simd::mul(simd::load(lhs), simd::load(rhs)));
+    }
+
     return vec4{lhs.w * rhs.w, lhs.x * rhs.x, lhs.y * rhs.y, lhs.z * rhs.z};
 }
 
 constexpr auto operator/(const vec4& lhs, const vec4& rhs) -> vec4 {
+    if(!std::is_constant_evaluated()) {
+        return simd::store<vec4>(simd::div(simd::load(lhs), simd::load(rhs)));
+    }
+
     return vec4{lhs.w / rhs.w, lhs.x / rhs.x, lhs.y / rhs.y, lhs.z / rhs.z};
 }
 
-constexpr auto operator+(const vec2& lhs, float scalar) -> vec2 {
-    return vec2{lhs.x + scalar, lhs.y + scalar};
+template<typename T, std::size_t N>
+constexpr auto operator+(const vec<T, N>& lhs, std::type_identity_t<T> scalar) -> vec<T, N> {
+    return make_vec<T, N>([&](std::size_t i) { return lhs[i] + scalar; });
 }
 
-constexpr auto operator+(float scalar, const vec2& vec) -> vec2 {
-    return vec + scalar;
-}
-
-constexpr auto operator+(const vec3& lhs, float scalar) -> vec3 {
-    return vec3{lhs.x + scalar, lhs.y + scalar, lhs.z + scalar};
-}
-constexpr auto operator+(float scalar, const vec3& vec) -> vec3 {
-    return vec + scalar;
+template<typename T, std::size_t N>
+constexpr auto operator+(std::type_identity_t<T> scalar, const vec<T, N>& rhs) -> vec<T, N> {
+    return make_vec<T, N>([&](std::size_t i) { return scalar + rhs[i]; });
 }
 
 constexpr auto operator+(const vec4& lhs, float scalar) -> vec4 {
+    if(!std::is_constant_evaluated()) {
+        return simd::store<vec4>(simd::add(simd::load(lhs), simd::broadcast(scalar)));
+    }
+
     return vec4{lhs.w + scalar, lhs.x + scalar, lhs.y + scalar, lhs.z + scalar};
 }
 
@@ -151,46 +226,47 @@ constexpr auto operator+(float scalar, const vec4& vec) -> vec4 {
     return vec + scalar;
 }
 
-constexpr auto operator-(const vec2& lhs, float scalar) -> vec2 {
-    return vec2{lhs.x - scalar, lhs.y - scalar};
-}
-constexpr auto operator-(float scalar, const vec2& vec) -> vec2 {
-    return vec - scalar;
+template<typename T, std::size_t N>
+constexpr auto operator-(const vec<T, N>& lhs, std::type_identity_t<T> scalar) -> vec<T, N> {
+    return make_vec<T, N>([&](std::size_t i) { return lhs[i] - scalar; });
 }
 
-constexpr auto operator-(const vec3& lhs, float scalar) -> vec3 {
-    return vec3{lhs.x - scalar, lhs.y - scalar, lhs.z - scalar};
-}
-
-constexpr auto operator-(float scalar, const vec3& vec) -> vec3 {
-    return vec - scalar;
+template<typename T, std::size_t N>
+constexpr auto operator-(std::type_identity_t<T> scalar, const vec<T, N>& rhs) -> vec<T, N> {
+    return make_vec<T, N>([&](std::size_t i) { return scalar - rhs[i]; });
 }
 
 constexpr auto operator-(const vec4& lhs, float scalar) -> vec4 {
+    if(!std::is_constant_evaluated()) {
+        return simd::store<vec4>(simd::sub(simd::load(lhs), simd::broadcast(scalar)));
+    }
+
     return vec4{lhs.w - scalar, lhs.x - scalar, lhs.y - scalar, lhs.z - scalar};
 }
 
 constexpr auto operator-(float scalar, const vec4& vec) -> vec4 {
-    return vec - scalar;
-}
-
-constexpr auto operator*(const vec2& lhs, float scalar) -> vec2 {
-    return vec2{lhs.x * scalar, lhs.y * scalar};
-}
+    if(!std::is_constant_evaluated()) {
+        return simd::store<vec4>(simd::sub(simd::broadcast(scalar), simd::load(vec)));
+    }
 
-constexpr auto operator*(float scalar, const vec2& vec) -> vec2 {
-    return vec * scalar;
+    return vec4{scalar - vec.w, scalar - vec.x, scalar - vec.y, scalar - vec.z};
 }
 
-constexpr auto operator*(const vec3& lhs, float scalar) -> vec3 {
-    return vec3{lhs.x * scalar, lhs.y * scalar, lhs.z * scalar};
+template<typename T, std::size_t N>
+constexpr auto operator*(const vec<T, N>& lhs, std::type_identity_t<T> scalar) -> vec<T, N> {
+    return make_vec<T, N>([&](std::size_t i) { return lhs[i] * scalar; });
 }
 
-constexpr auto operator*(float scalar, const vec3& vec) -> vec3 {
-    return vec * scalar;
+template<typename T, std::size_t N>
+constexpr auto operator*(std::type_identity_t<T> scalar, const vec<T, N>& rhs) -> vec<T, N> {
+    return make_vec<T, N>([&](std::size_t i) { return scalar * rhs[i]; });
 }
 
 constexpr auto operator*(const vec4& lhs, float scalar) -> vec4 {
+    if(!std::is_constant_evaluated()) {
+        return simd::store<vec4>(simd::mul(simd::load(lhs), simd::broadcast(scalar)));
+    }
+
     return vec4{lhs.w * scalar, lhs.x * scalar, lhs.y * scalar, lhs.z * scalar};
 }
 
@@ -198,46 +274,42 @@ constexpr auto operator*(float scalar, const vec4& vec) -> vec4 {
     return vec * scalar;
 }
 
-constexpr auto operator/(const vec2& lhs, float scalar) -> vec2 {
-    return vec2{lhs.x / scalar, lhs.y / scalar};
-}
-
-constexpr auto operator/(float scalar, const vec2& vec) -> vec2 {
-    return vec / scalar;
-}
-
-constexpr auto operator/(const vec3& lhs, float scalar) -> vec3 {
-    return vec3{lhs.x / scalar, lhs.y / scalar, lhs.z / scalar};
+template<typename T, std::size_t N>
+constexpr auto operator/(const vec<T, N>& lhs, std::type_identity_t<T> scalar) -> vec<T, N> {
+    return make_vec<T, N>([&](std::size_t i) { return lhs[i] / scalar; });
 }
 
-constexpr auto operator/(float scalar, const vec3& vec) -> vec3 {
-    return vec / scalar;
+template<typename T, std::size_t N>
+constexpr auto operator/(std::type_identity_t<T> scalar, const vec<T, N>& rhs) -> vec<T, N> {
+    return make_vec<T, N>([&](std::size_t i) { return scalar / rhs[i]; });
 }
 
 constexpr auto operator/(const vec4& lhs, float scalar) -> vec4 {
+    if(!std::is_constant_evaluated()) {
+        return simd::store<vec4>(simd::div(simd::load(lhs), simd::broadcast(scalar)));
+    }
+
     return vec4{lhs.w / scalar, lhs.x / scalar, lhs.y / scalar, lhs.z / scalar};
 }
 
 constexpr auto operator/(float scalar, const vec4& vec) -> vec4 {
-    return vec / scalar;
-}
+    if(!std::is_constant_evaluated()) {
+        return simd::store<vec4>(simd::div(simd::broadcast(scalar), simd::load(vec)));
+    }
 
-constexpr auto abs(const vec2& vec) -> vec2 {
-    return vec2{
-        std::abs(vec.x),
-        std::abs(vec.y),
-    };
+    return vec4{scalar / vec.w, scalar / vec.x, scalar / vec.y, scalar / vec.z};
 }
 
-constexpr auto abs(const vec3& vec) -> vec3 {
-    return vec3{
-        std::abs(vec.x),
-        std::abs(vec.y),
-        std::abs(vec.z),
-    };
+template<typename T, std::size_t N>
+constexpr auto abs(const vec<T, N>& value) -> vec<T, N> {
+    return make_vec<T, N>([&](std::size_t i) { return std::abs(value[i]); });
 }
 
 constexpr auto abs(const vec4& vec) -> vec4 {
+    if(!std::is_constant_evaluated()) {
+        return simd::store<vec4>(simd::abs(simd::load(vec)));
+    }
+
     return vec4{
         std::abs(vec.w),
         std::abs(vec.x),
@@ -246,22 +318,35 @@ constexpr auto abs(const vec4& vec) -> vec4 {
     };
 }
 
-constexpr auto distance(const vec2& lhs, const vec2& rhs) -> float {
-    auto x = (rhs.x - lhs.x) * (rhs.x - lhs.x);
-    auto y = (rhs.y - lhs.y) * (rhs.y - lhs.y);
-
-    return std::sqrt(x + y);
+template<typename T, std::size_t N>
+constexpr auto dot(const vec<T, N>& lhs, const vec<T, N>& rhs) -> T {
+    auto result = lhs[0] * rhs[0];
+    for(std::size_t i = 1; i < N; ++i) {
+        result += lhs[i] * rhs[i];
+    }
+    return result;
 }
 
-constexpr auto distance(const vec3& lhs, const vec3& rhs) -> float {
-    auto x = (rhs.x - lhs.x) * (rhs.x - lhs.x);
-    auto y = (rhs.y - lhs.y) * (rhs.y - lhs.y);
-    auto z = (rhs.z - lhs.z) * (rhs.z - lhs.z);
+constexpr auto dot(const vec4& lhs, const vec4& rhs) -> float {
+    if(!std::is_constant_evaluated()) {
+        return simd::dot(simd::load(lhs), simd::load(rhs));
+    }
 
-    return std::sqrt(x + y + z);
+    return (lhs.w * rhs.w) + (lhs.x * rhs.x) + (lhs.y * rhs.y) + (lhs.z * rhs.z);
+}
+
+template<typename T, std::size_t N>
+constexpr auto distance(const vec<T, N>& lhs, const vec<T, N>& rhs) -> T {
+    auto diff = rhs - lhs;
+    return std::sqrt(dot(diff, diff));
 }
 
 constexpr auto distance(const vec4& lhs, const vec4& rhs) -> float {
+    if(!std::is_constant_evaluated()) {
+        auto diff = simd::sub(simd::load(rhs), simd::load(lhs));
+        return std::sqrt(simd::dot(diff, diff));
+    }
+
     auto w = (rhs.w - lhs.w) * (rhs.w - lhs.w);
     auto x = (rhs.x - lhs.x) * (rhs.x - lhs.x);
     auto y = (rhs.y - lhs.y) * (rhs.y - lhs.y);
@@ -270,42 +355,26 @@ constexpr auto distance(const vec4& lhs, const vec4& rhs) -> float {
     return std::sqrt(w + x + y + z);
 }
 
-constexpr auto dot(const vec2& lhs, const vec2& rhs) -> float {
-    return (lhs.x * rhs.x) + (lhs.y * rhs.y);
-}
-
-constexpr auto dot(const vec3& lhs, const vec3& rhs) -> float {
-    return (lhs.x * rhs.x) + (lhs.y * rhs.y) + (lhs.z * rhs.z);
-}
-
-constexpr auto dot(const vec4& lhs, const vec4& rhs) -> float {
-    return (lhs.w * rhs.w) + (lhs.x * rhs.x) + (lhs.y * rhs.y) + (lhs.z * rhs.z);
-}
-
-constexpr auto cross(const vec3& lhs, const vec3& rhs) -> vec3 {
-    return vec3{
+template<typename T>
+constexpr auto cross(const vec<T, 3>& lhs, const vec<T, 3>& rhs) -> vec<T, 3> {
+    return vec<T, 3>{
         lhs.y * rhs.z - lhs.z * rhs.y,
         lhs.z * rhs.x - lhs.x * rhs.z,
         lhs.x * rhs.y - lhs.y * rhs.x,
     };
 }
 
-constexpr auto clamp(const vec2& vec, float min, float max) -> vec2 {
-    return vec2{
-        std::clamp(vec.x, min, max),
-        std::clamp(vec.y, min, max),
-    };
-}
-
-constexpr auto clamp(const vec3& vec, float min, float max) -> vec3 {
-    return vec3{
-        std::clamp(vec.x, min, max),
-        std::clamp(vec.y, min, max),
-        std::clamp(vec.z, min, max),
-    };
+template<typename T, std::size_t N>
+constexpr auto clamp(const vec<T, N>& value, std::type_identity_t<T> min, std::type_identity_t<T> max) -> vec<T, N> {
+    return make_vec<T, N>([&](std::size_t i) { return std::clamp(value[i], min, max); });
 }
 
 constexpr auto clamp(const vec4& vec, float min, float max) -> vec4 {
+    if(!std::is_constant_evaluated()) {
+        auto lower = simd::max(simd::load(vec), simd::broadcast(min));
+        return simd::store<vec4>(simd::min(lower, simd::broadcast(max)));
+    }
+
     return vec4{
         std::clamp(vec.w, min, max),
         std::clamp(vec.x, min, max),
@@ -314,22 +383,18 @@ constexpr auto clamp(const vec4& vec, float min, float max) -> vec4 {
     };
 }
 
-constexpr auto lerp(const vec2& from, const vec2& to, float delta) -> vec2 {
-    return vec2{
-        std::lerp(from.x, to.x, delta),
-        std::lerp(from.y, to.y, delta),
-    };
-}
-
-constexpr auto lerp(const vec3& from, const vec3& to, float delta) -> vec3 {
-    return vec3{
-        std::lerp(from.x, to.x, delta),
-        std::lerp(from.y, to.y, delta),
-        std::lerp(from.z, to.z, delta),
-    };
+template<typename T, std::size_t N>
+constexpr auto lerp(const vec<T, N>& from, const vec<T, N>& to, std::type_identity_t<T> delta) -> vec<T, N> {
+    return make_vec<T, N>([&](std::size_t i) { return std::lerp(from[i], to[i], delta); });
 }
 
 constexpr auto lerp(const vec4& from, const vec4& to, float delta) -> vec4 {
+    if(!std::is_constant_evaluated()) {
+        // (1 - t) * a + t * b keeps both endpoints exact, like std::lerp
+        auto scaled_from = simd::mul(simd::load(from), simd::broadcast(1.0f - delta));
+        return simd::store<vec4>(simd::fmadd(simd::load(to), simd::broadcast(delta), scaled_from));
+    }
+
     return vec4{
         std::lerp(from.w, to.w, delta),
         std::lerp(from.x, to.x, delta),
@@ -338,13 +403,59 @@ constexpr auto lerp(const vec4& from, const vec4& to, float delta) -> vec4 {
     };
 }
 
+// dvec4 kernels, four doubles per f64x4 register. Constant evaluation goes through the templates above.
+
+constexpr auto operator+(const dvec4& lhs, const dvec4& rhs) -> dvec4 {
+    if(!std::is_constant_evaluated()) {
+        return simd::store_f64<dvec4>(simd::add(simd::load_f64(lhs), simd::load_f64(rhs)));
+    }
+
+    return operator+<double, 4>(lhs, rhs);
+}
+
+constexpr auto operator-(const dvec4& lhs, const dvec4& rhs) -> dvec4 {
+    if(!std::is_constant_evaluated()) {
+        return simd::store_f64<dvec4>(simd::sub(simd::load_f64(lhs), simd::load_f64(rhs)));
+    }
+
+    return operator-<double, 4>(lhs, rhs);
+}
+
+constexpr auto operator*(const dvec4& lhs, const dvec4& rhs) -> dvec4 {
+    if(!std::is_constant_evaluated()) {
+        return simd::store_f64<dvec4>(simd::mul(simd::load_f64(lhs), simd::load_f64(rhs)));
+    }
+
+    return operator*<double, 4>(lhs, rhs);
+}
+
+constexpr auto operator*(const dvec4& lhs, double scalar) -> dvec4 {
+    if(!std::is_constant_evaluated()) {
+        return simd::store_f64<dvec4>(simd::mul(simd::load_f64(lhs), simd::broadcast_f64(scalar)));
+    }
+
+    return operator*<double, 4>(lhs, scalar);
+}
+
+constexpr auto operator*(double scalar, const dvec4& vec) -> dvec4 {
+    return vec * scalar;
+}
+
+constexpr auto dot(const dvec4& lhs, const dvec4& rhs) -> double {
+    if(!std::is_constant_evaluated()) {
+        return simd::dot(simd::load_f64(lhs), simd::load_f64(rhs));
+    }
+
+    return dot<double, 4>(lhs, rhs);
+}
+
 template<typename T>
 constexpr auto reflect(const T& incident, const T& normal) -> T {
     return incident - (normal * 2.0 * dot(normal, incident));
 }
 
 template<typename T>
-auto magnitude(const T& vec) -> float {
+auto magnitude(const T& vec) {
     return std::sqrt(dot(vec, vec));
 }
 
@@ -0,0 +1,222 @@
+module;
+
+// import admat; gives importers the names admat/admat.hpp declares. The headers, and the <algorithm>, <array>, <cmath>
+// and intrinsics headers below them, are parsed once, into this interface, instead of once per translation unit.
+//
+// Macros do not cross an import. ADMAT_SIMD_*, ADMAT_DISPATCH_TIER and the ADMAT_NO_* switches take the values
+// admat::module was compiled with, and code that tests them has to include the headers. admat::simd and the detail
+// namespaces are not exported: the templates reach them, importers do not name them.
+
+#include "admat/admat.hpp"
+
+export module admat;
+
+export namespace admat {
+
+// vec.hpp
+using admat::abs;
+using admat::clamp;
+using admat::cross;
+using admat::distance;
+using admat::dot;
+using admat::dvec2;
+using admat::dvec3;
+using admat::dvec4;
+using admat::ivec2;
+using admat::ivec3;
+using admat::ivec4;
+using admat::lerp;
+using admat::magnitude;
+using admat::make_vec;
+using admat::normalize;
+using admat::operator+;
+using admat::operator-;
+using admat::operator*;
+using admat::operator/;
+using admat::reflect;
+using admat::refract;
+using admat::vec;
+using admat::vec2;
+using admat::vec3;
+using admat::vec4;
+
+// mat.hpp
+using admat::adjugate;
+using admat::determinant;
+using admat::dmat2;
+using admat::dmat3;
+using admat::dmat4;
+using admat::euler_rotation;
+using admat::inverse;
+using admat::inverse_and_determinant;
+using admat::inverse_result;
+using admat::is_rigid;
+using admat::linear_part;
+using admat::look_at;
+using admat::look_at_inverse;
+using admat::mat;
+using admat::mat2;
+using admat::mat3;
+using admat::mat4;
+using admat::normal_matrix;
+using admat::orthographic;
+using admat::perspective;
+using admat::rigid_inverse;
+using admat::rotation;
+using admat::scaling;
+using admat::translation;
+using admat::transpose;
+using admat::yaw_pitch_roll_rotation;
+
+// quat.hpp
+using admat::axis_angle;
+using admat::conjugate;
+using admat::nlerp;
+using admat::quat;
+using admat::slerp;
+using admat::to_axis_angle;
+
+// affine.hpp
+using admat::affine;
+using admat::to_mat4;
+using admat::transform_direction;
+using admat::transform_point;
+
+// soa.hpp
+using admat::aligned_allocator;
+using admat::aligned_vector;
+using admat::vec3_soa;
+using admat::vec4_soa;
+
+// bounds.hpp
+using admat::aabb;
+using admat::aabb_soa;
+using admat::center;
+using admat::contains;
+using admat::extent;
+using admat::merge;
+using admat::overlaps;
+using admat::sphere;
+using admat::sphere_soa;
+
+// frustum.hpp
+using admat::cull;
+using admat::cull_aabbs;
+using admat::cull_spheres;
+using admat::frustum;
+using admat::plane;
+using admat::signed_distance;
+using admat::visible;
+
+// intersect.hpp and bvh.hpp
+using admat::any_hit;
+using admat::bvh;
+using admat::closest_hit;
+using admat::intersect;
+using admat::inverse_direction;
+using admat::miss;
+using admat::ray;
+using admat::ray_hit;
+using admat::ray_soa;
+using admat::triangle_bounds;
+using admat::triangle_hit;
+using admat::triangle_soa;
+
+// half.hpp and encoding.hpp
+using admat::bitangent;
+using admat::half;
+using admat::half2;
+using admat::half4;
+using admat::oct16x2;
+using admat::oct8x2;
+using admat::qtangent;
+using admat::tangent_frame;
+using admat::to_float;
+using admat::to_frame;
+using admat::to_half;
+using admat::to_oct16x2;
+using admat::to_oct8x2;
+using admat::to_qtangent;
+using admat::to_vec3;
+
+// batch.hpp, rebase.hpp and hierarchy.hpp
+using admat::euler_rotations;
+using admat::hierarchy;
+using admat::multiply;
+using admat::rebase;
+using admat::rotations;
+using admat::transform;
+using admat::transform_directions;
+using admat::transform_points;
+using admat::yaw_pitch_roll_rotations;
+
+// executor.hpp, parallel.hpp and expr.hpp
+using admat::assign;
+using admat::default_grain;
+using admat::default_pool;
+using admat::lazy;
+using admat::parallel_for;
+using admat::serial_executor;
+using admat::thread_pool;
+
+} // namespace admat
+
+export namespace admat::expr {
+
+using admat::expr::abs;
+using admat::expr::clamp;
+using admat::expr::element;
+using admat::expr::expression;
+using admat::expr::lerp;
+using admat::expr::node;
+using admat::expr::operand;
+using admat::expr::operator+;
+using admat::expr::operator-;
+using admat::expr::operator*;
+using admat::expr::operator/;
+using admat::expr::view;
+
+} // namespace admat::expr
+
+export namespace admat::fast {
+
+using admat::fast::cos;
+using admat::fast::distance;
+using admat::fast::from_axis_angle;
+using admat::fast::magnitude;
+using admat::fast::normalize;
+using admat::fast::perspective;
+using admat::fast::rcp;
+using admat::fast::rotation;
+using admat::fast::rsqrt;
+using admat::fast::sin;
+using admat::fast::sin_cos;
+using admat::fast::sincos;
+using admat::fast::tan;
+
+} // namespace admat::fast
+
+export namespace admat::dispatch {
+
+using admat::dispatch::active_isa;
+using admat::dispatch::compiled_isa;
+using admat::dispatch::cull;
+using admat::dispatch::detect_isa;
+using admat::dispatch::euler_rotations;
+using admat::dispatch::isa;
+using admat::dispatch::isa_count;
+using admat::dispatch::isa_name;
+using admat::dispatch::kernel_table;
+using admat::dispatch::kernels;
+using admat::dispatch::parse_isa;
+using admat::dispatch::rebase;
+using admat::dispatch::rotations;
+using admat::dispatch::sincos;
+using admat::dispatch::to_float;
+using admat::dispatch::to_half;
+using admat::dispatch::transform;
+using admat::dispatch::transform_directions;
+using admat::dispatch::transform_points;
+using admat::dispatch::yaw_pitch_roll_rotations;
+
+} // namespace admat::dispatch
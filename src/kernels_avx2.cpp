@@ -0,0 +1,13 @@
+// The avx2 tier of admat::kernels, compiled with the flags CMakeLists.txt sets for this file
+#include "admat/dispatch.hpp"
+
+static_assert(admat::dispatch::compiled_isa == admat::dispatch::isa::avx2, "compile this file with the avx2 flags");
+
+namespace admat::dispatch::detail {
+
+template struct kernel_functions<isa::avx2>;
+
+extern const kernel_table avx2_kernels;
+const kernel_table avx2_kernels = kernel_functions<isa::avx2>::table;
+
+} // namespace admat::dispatch::detail
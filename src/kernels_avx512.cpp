@@ -0,0 +1,13 @@
+// The avx512 tier of admat::kernels, compiled with the flags CMakeLists.txt sets for this file
+#include "admat/dispatch.hpp"
+
+static_assert(admat::dispatch::compiled_isa == admat::dispatch::isa::avx512, "compile this file with the avx512 flags");
+
+namespace admat::dispatch::detail {
+
+template struct kernel_functions<isa::avx512>;
+
+extern const kernel_table avx512_kernels;
+const kernel_table avx512_kernels = kernel_functions<isa::avx512>::table;
+
+} // namespace admat::dispatch::detail
@@ -0,0 +1,41 @@
+// The baseline tier of admat::kernels and the table of every tier the library builds
+#include "admat/dispatch.hpp"
+
+static_assert(admat::dispatch::compiled_isa == admat::dispatch::isa::baseline,
+              "compile admat::kernels without target flags above the baseline");
+
+namespace admat::dispatch::detail {
+
+template struct kernel_functions<isa::baseline>;
+
+// Defined by the files of the other tiers, which CMakeLists.txt only adds where the compiler can target them
+#if defined(ADMAT_KERNELS_SSE4_2)
+extern const kernel_table sse4_2_kernels;
+#endif
+#if defined(ADMAT_KERNELS_AVX2)
+extern const kernel_table avx2_kernels;
+#endif
+#if defined(ADMAT_KERNELS_AVX512)
+extern const kernel_table avx512_kernels;
+#endif
+
+const std::array<const kernel_table*, isa_count> library_kernels = {
+    &kernel_functions<isa::baseline>::table,
+#if defined(ADMAT_KERNELS_SSE4_2)
+    &sse4_2_kernels,
+#else
+    nullptr,
+#endif
+#if defined(ADMAT_KERNELS_AVX2)
+    &avx2_kernels,
+#else
+    nullptr,
+#endif
+#if defined(ADMAT_KERNELS_AVX512)
+    &avx512_kernels,
+#else
+    nullptr,
+#endif
+};
+
+} // namespace admat::dispatch::detail
@@ -0,0 +1,13 @@
+// The sse4.2 tier of admat::kernels, compiled with the flags CMakeLists.txt sets for this file
+#include "admat/dispatch.hpp"
+
+static_assert(admat::dispatch::compiled_isa == admat::dispatch::isa::sse4_2, "compile this file with the sse4.2 flags");
+
+namespace admat::dispatch::detail {
+
+template struct kernel_functions<isa::sse4_2>;
+
+extern const kernel_table sse4_2_kernels;
+const kernel_table sse4_2_kernels = kernel_functions<isa::sse4_2>::table;
+
+} // namespace admat::dispatch::detail
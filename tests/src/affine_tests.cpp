@@ -0,0 +1,65 @@
+#include "utils.hpp"
+#include <admat/affine.hpp>
+#include <snitch/snitch.hpp>
+
+using namespace admat;
+
+namespace {
+
+auto other_matrix() -> mat4 {
+    return translation(-4.0f, 0.5f, 2.0f) * rotation(vec3{1.0f, 0.0f, 0.2f}, -1.1f) * scaling(0.5f, 3.0f, 1.0f);
+}
+
+} // namespace
+
+TEST_CASE("affine mat4 conversion", "[affine]") {
+    auto mat = test_matrix();
+    CHECK(close(to_mat4(affine::from_mat4(mat)), mat));
+    CHECK(close(to_mat4(affine::identity()), mat4::identity()));
+}
+
+TEST_CASE("affine composition", "[affine]") {
+    auto lhs = test_matrix();
+    auto rhs = other_matrix();
+
+    // Scalar path through constant evaluation
+    constexpr auto translate = affine{{1, 0, 0, 2}, {0, 1, 0, 3}, {0, 0, 1, 4}};
+    constexpr auto scale     = affine{{2, 0, 0, 0}, {0, 2, 0, 0}, {0, 0, 2, 0}};
+    constexpr auto composed  = translate * scale;
+    static_assert(almost_equal(composed.x.w, 2.0f, 0.000001f) && almost_equal(composed.x.z, 2.0f, 0.000001f));
+    static_assert(almost_equal(composed.z.y, 2.0f, 0.000001f) && almost_equal(composed.z.z, 4.0f, 0.000001f));
+
+    CHECK(close(to_mat4(affine::from_mat4(lhs) * affine::from_mat4(rhs)), lhs * rhs));
+    CHECK(close(to_mat4(affine::from_mat4(lhs) * affine::identity()), lhs));
+}
+
+TEST_CASE("affine point and direction transform", "[affine]") {
+    auto mat = test_matrix();
+    auto aff = affine::from_mat4(mat);
+    auto vec = vec3{1.5f, -2.0f, 0.25f};
+
+    auto point = mat * vec4{vec.x, vec.y, vec.z, 1.0f};
+    auto dir   = mat * vec4{vec.x, vec.y, vec.z, 0.0f};
+
+    CHECK(close(transform_point(aff, vec), vec3{point.w, point.x, point.y}));
+    CHECK(close(transform_direction(aff, vec), vec3{dir.w, dir.x, dir.y}));
+}
+
+TEST_CASE("affine inverse", "[affine]") {
+    auto mat = test_matrix();
+    auto aff = affine::from_mat4(mat);
+
+    CHECK(close(to_mat4(inverse(aff)), inverse(mat)));
+    CHECK(close(to_mat4(inverse(aff) * aff), mat4::identity()));
+
+    constexpr auto translate = affine{{1, 0, 0, 2}, {0, 1, 0, 3}, {0, 0, 1, 4}};
+    constexpr auto inverted  = inverse(translate);
+    static_assert(almost_equal(inverted.x.z, -2.0f, 0.000001f) && almost_equal(inverted.z.z, -4.0f, 0.000001f));
+}
+
+TEST_CASE("affine rigid inverse", "[affine]") {
+    auto aff = affine::from_mat4(translation(3.0f, -1.0f, 2.5f) * rotation({0.3f, 1.0f, -0.5f}, 0.7f));
+
+    CHECK(close(to_mat4(rigid_inverse(aff)), to_mat4(inverse(aff))));
+    CHECK(close(to_mat4(rigid_inverse(aff) * aff), mat4::identity()));
+}
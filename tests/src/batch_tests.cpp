@@ -0,0 +1,135 @@
+#include "utils.hpp"
+#include <admat/batch.hpp>
+#include <snitch/snitch.hpp>
+
+#include <array>
+#include <vector>
+
+using namespace admat;
+
+namespace {
+
+auto test_points(std::size_t count) -> std::vector<vec3> {
+    auto points = std::vector<vec3>{};
+    for(std::size_t i = 0; i < count; ++i) {
+        auto f = static_cast<float>(i);
+        points.push_back(vec3{f * 0.5f - 3.0f, 10.0f - f, f * f * 0.01f});
+    }
+    return points;
+}
+
+} // namespace
+
+TEST_CASE("transform points", "[batch]") {
+    auto mat = test_matrix();
+
+    // Sizes around the SIMD block widths exercise both the wide loop and the scalar tail
+    for(auto count : std::array<std::size_t, 8>{0, 1, 3, 4, 7, 8, 16, 37}) {
+        auto points = test_points(count);
+        auto result = std::vector<vec3>(count);
+
+        transform_points(mat, points, result);
+
+        for(std::size_t i = 0; i < count; ++i) {
+            auto expected = mat * vec4{points[i].x, points[i].y, points[i].z, 1.0f};
+            CHECK(close(result[i], vec3{expected.w, expected.x, expected.y}));
+        }
+    }
+}
+
+TEST_CASE("transform directions", "[batch]") {
+    auto mat  = test_matrix();
+    auto dirs = test_points(21);
+
+    auto result = std::vector<vec3>(dirs.size());
+    transform_directions(mat, dirs, result);
+
+    for(std::size_t i = 0; i < dirs.size(); ++i) {
+        auto expected = mat * vec4{dirs[i].x, dirs[i].y, dirs[i].z, 0.0f};
+        CHECK(close(result[i], vec3{expected.w, expected.x, expected.y}));
+    }
+}
+
+TEST_CASE("transform points in place", "[batch]") {
+    auto mat      = test_matrix();
+    auto points   = test_points(29);
+    auto expected = std::vector<vec3>(points.size());
+
+    transform_points(mat, points, expected);
+    transform_points(mat, points, points);
+
+    for(std::size_t i = 0; i < points.size(); ++i) {
+        CHECK(close(points[i], expected[i]));
+    }
+}
+
+TEST_CASE("transform vec4", "[batch]") {
+    auto mat = test_matrix();
+
+    for(auto count : std::array<std::size_t, 5>{0, 1, 2, 5, 19}) {
+        auto vecs = std::vector<vec4>{};
+        for(const auto& point : test_points(count)) {
+            vecs.push_back(vec4{point.x, point.y, point.z, point.x * 0.25f});
+        }
+
+        auto result = std::vector<vec4>(count);
+        transform(mat, vecs, result);
+
+        for(std::size_t i = 0; i < count; ++i) {
+            CHECK(close(result[i], mat * vecs[i]));
+        }
+
+        transform(mat, vecs, vecs);
+        for(std::size_t i = 0; i < count; ++i) {
+            CHECK(close(vecs[i], result[i]));
+        }
+    }
+}
+
+TEST_CASE("batched rotations", "[batch]") {
+    auto close_mat = [](const mat4& lhs, const mat4& rhs) {
+        auto all = true;
+        for(std::size_t row = 0; row < 4; ++row) {
+            for(std::size_t col = 0; col < 4; ++col) {
+                all = all && almost_equal(lhs[row, col], rhs[row, col], 0.000001f);
+            }
+        }
+        return all;
+    };
+
+    for(auto count : std::array<std::size_t, 6>{0, 1, 3, 8, 17, 100}) {
+        auto axes   = test_points(count);
+        auto angles = std::vector<float>{};
+        auto eulers = std::vector<vec3>{};
+        for(std::size_t i = 0; i < count; ++i) {
+            auto f = static_cast<float>(i);
+            axes[i].x += 0.5f;
+            angles.push_back(f * 0.731f - 30.0f);
+            eulers.push_back(vec3{f * 0.37f - 4.0f, 3.0f - f * 0.13f, f * 1.9f});
+        }
+
+        auto axis_angle = std::vector<mat4>(count);
+        auto euler      = std::vector<mat4>(count);
+        auto camera     = std::vector<mat4>(count);
+        rotations(axes, angles, axis_angle);
+        euler_rotations(eulers, euler);
+        yaw_pitch_roll_rotations(eulers, camera);
+
+        auto all = true;
+        for(std::size_t i = 0; i < count; ++i) {
+            all = all && close_mat(axis_angle[i], rotation(axes[i], angles[i])) &&
+                  close_mat(euler[i], euler_rotation(eulers[i])) &&
+                  close_mat(camera[i], yaw_pitch_roll_rotation(eulers[i].x, eulers[i].y, eulers[i].z));
+        }
+        CHECK(all);
+
+        // The executor versions split the same work into chunks
+        auto chunked = std::vector<mat4>(count);
+        rotations(serial_executor{}, axes, angles, chunked, 5);
+        all = true;
+        for(std::size_t i = 0; i < count; ++i) {
+            all = all && close_mat(chunked[i], axis_angle[i]);
+        }
+        CHECK(all);
+    }
+}
@@ -0,0 +1,180 @@
+#include "utils.hpp"
+#include <admat/bounds.hpp>
+#include <snitch/snitch.hpp>
+
+#include <cstdint>
+#include <vector>
+
+using namespace admat;
+
+namespace {
+
+auto close(const aabb& lhs, const aabb& rhs) -> bool {
+    return close(lhs.min, rhs.min) && close(lhs.max, rhs.max);
+}
+
+auto close(const sphere& lhs, const sphere& rhs) -> bool {
+    return close(lhs.center, rhs.center) && almost_equal(lhs.radius, rhs.radius, 0.0001f);
+}
+
+// Pushes all 8 corners through mat, what the Arvo transform avoids
+auto corner_transform(const mat4& mat, const aabb& box) -> aabb {
+    auto result = aabb::empty();
+    for(std::size_t corner = 0; corner < 8; ++corner) {
+        auto point = vec4{
+            (corner & 1) != 0 ? box.max.x : box.min.x,
+            (corner & 2) != 0 ? box.max.y : box.min.y,
+            (corner & 4) != 0 ? box.max.z : box.min.z,
+            1.0f,
+        };
+        auto moved = mat * point;
+        result     = merge(result, vec3{moved.w, moved.x, moved.y});
+    }
+    return result;
+}
+
+// 37 elements cover a full SIMD block at every width plus a scalar tail
+auto test_box(std::size_t idx) -> aabb {
+    auto f = static_cast<float>(idx);
+    return aabb::from_center_extent({f * 0.5f - 9.0f, 2.0f - f * 0.25f, f * 0.1f}, {1.0f + f * 0.05f, 0.5f, 2.0f});
+}
+
+auto test_sphere(std::size_t idx) -> sphere {
+    auto f = static_cast<float>(idx);
+    return sphere{{f * 0.5f - 9.0f, 2.0f - f * 0.25f, f * 0.1f}, 0.5f + static_cast<float>(idx % 4)};
+}
+
+constexpr std::size_t count = 37;
+
+} // namespace
+
+TEST_CASE("aabb merge and tests", "[bounds]") {
+    constexpr auto box    = aabb{{-1, -1, -1}, {1, 2, 3}};
+    constexpr auto other  = aabb{{0, 1, 2}, {4, 4, 4}};
+    constexpr auto merged = merge(box, other);
+
+    static_assert(almost_equal(merged.min.x, -1.0f, 0.000001f) && almost_equal(merged.max.x, 4.0f, 0.000001f));
+    static_assert(contains(merged, box) && contains(merged, other) && !contains(box, other));
+    static_assert(overlaps(box, other) && overlaps(other, box));
+    static_assert(contains(box, vec3{1, 2, 3}) && !contains(box, vec3{1, 2, 3.5f}));
+
+    CHECK(close(center(box), {0.0f, 0.5f, 1.0f}));
+    CHECK(close(extent(box), {1.0f, 1.5f, 2.0f}));
+    CHECK(close(merge(aabb::empty(), box), box));
+    CHECK(close(merge(box, vec3{-3.0f, 0.0f, 5.0f}), aabb{{-3, -1, -1}, {1, 2, 5}}));
+    CHECK(overlaps(box, aabb{{1, 2, 3}, {5, 5, 5}}));
+    CHECK_FALSE(overlaps(box, aabb{{1.5f, 0, 0}, {5, 5, 5}}));
+    CHECK(overlaps(box, sphere{{2, 0, 0}, 1.5f}));
+    CHECK_FALSE(overlaps(box, sphere{{2, 3, 0}, 1.2f}));
+}
+
+TEST_CASE("sphere merge and tests", "[bounds]") {
+    auto lhs = sphere{{0, 0, 0}, 1.0f};
+    auto rhs = sphere{{4, 0, 0}, 1.0f};
+
+    auto merged = merge(lhs, rhs);
+    CHECK(close(merged, sphere{{2, 0, 0}, 3.0f}));
+    CHECK(contains(merged, lhs));
+    CHECK(contains(merged, rhs));
+
+    auto inner = sphere{{0.5f, 0, 0}, 0.25f};
+    CHECK(close(merge(lhs, inner), lhs));
+    CHECK(close(merge(inner, lhs), lhs));
+
+    CHECK(contains(lhs, vec3{0.0f, 1.0f, 0.0f}));
+    CHECK_FALSE(contains(lhs, vec3{0.8f, 0.8f, 0.0f}));
+    CHECK(overlaps(lhs, sphere{{2, 0, 0}, 1.0f}));
+    CHECK_FALSE(overlaps(lhs, rhs));
+}
+
+TEST_CASE("bounds transform", "[bounds]") {
+    auto mat = test_matrix();
+    auto box = aabb{{-1.0f, 0.5f, -2.0f}, {3.0f, 1.0f, 0.25f}};
+
+    CHECK(close(transform(mat, box), corner_transform(mat, box)));
+    CHECK(close(transform(mat4::identity(), box), box));
+
+    constexpr auto moved = transform(translation(1.0f, 2.0f, 3.0f), aabb{{-1, -1, -1}, {1, 1, 1}});
+    static_assert(almost_equal(moved.min.y, 1.0f, 0.000001f) && almost_equal(moved.max.z, 4.0f, 0.000001f));
+
+    // Largest scale axis of test_matrix is 2
+    auto bounds       = transform(mat, sphere{{1.0f, 0.0f, -1.0f}, 1.5f});
+    auto moved_center = mat * vec4{1.0f, 0.0f, -1.0f, 1.0f};
+    CHECK(close(bounds, sphere{{moved_center.w, moved_center.x, moved_center.y}, 3.0f}));
+}
+
+TEST_CASE("bounds batched", "[bounds]") {
+    auto mat   = test_matrix();
+    auto query = aabb{{-4.0f, -2.0f, 0.0f}, {2.0f, 2.0f, 1.0f}};
+    auto probe = sphere{{-2.0f, 1.0f, 1.0f}, 2.0f};
+    auto point = vec3{-3.0f, 1.5f, 0.5f};
+
+    auto boxes   = aabb_soa{};
+    auto others  = aabb_soa{};
+    auto spheres = sphere_soa{};
+    auto mats    = std::vector<mat4>{};
+    for(std::size_t i = 0; i < count; ++i) {
+        boxes.push_back(test_box(i));
+        others.push_back(test_box(count - 1 - i));
+        spheres.push_back(test_sphere(i));
+        mats.push_back(translation(static_cast<float>(i), 0.0f, 0.0f) * mat);
+    }
+
+    auto merged         = aabb_soa{};
+    auto merged_spheres = sphere_soa{};
+    auto moved          = aabb_soa{};
+    auto moved_each     = aabb_soa{};
+    auto moved_spheres  = sphere_soa{};
+    merge(boxes, others, merged);
+    merge(spheres, sphere_soa{spheres}, merged_spheres);
+    transform(mat, boxes, moved);
+    transform(mats, boxes, moved_each);
+    transform(mat, spheres, moved_spheres);
+
+    // Start from set bits to check every covered bit is written
+    auto box_points    = std::vector<std::uint64_t>(1, ~std::uint64_t{0});
+    auto box_overlaps  = std::vector<std::uint64_t>(1, ~std::uint64_t{0});
+    auto sphere_points = std::vector<std::uint64_t>(1, ~std::uint64_t{0});
+    auto sphere_hits   = std::vector<std::uint64_t>(1, ~std::uint64_t{0});
+    contains(boxes, point, box_points);
+    overlaps(query, boxes, box_overlaps);
+    contains(spheres, point, sphere_points);
+    overlaps(probe, spheres, sphere_hits);
+
+    auto hits = 0;
+    for(std::size_t i = 0; i < count; ++i) {
+        CAPTURE(i);
+        CHECK(close(merged[i], merge(boxes[i], others[i])));
+        CHECK(close(merged_spheres[i], spheres[i]));
+        CHECK(close(moved[i], transform(mat, boxes[i])));
+        CHECK(close(moved_each[i], corner_transform(mats[i], boxes[i])));
+        CHECK(close(moved_spheres[i], transform(mat, spheres[i])));
+        CHECK(is_set(box_points, i) == contains(boxes[i], point));
+        CHECK(is_set(box_overlaps, i) == overlaps(query, boxes[i]));
+        CHECK(is_set(sphere_points, i) == contains(spheres[i], point));
+        CHECK(is_set(sphere_hits, i) == overlaps(probe, spheres[i]));
+        hits += is_set(box_overlaps, i) ? 1 : 0;
+    }
+    CHECK(hits > 0);
+    CHECK(hits < static_cast<int>(count));
+}
+
+TEST_CASE("sphere batched merge", "[bounds]") {
+    // Disjoint pairs, and pairs where either side holds the other
+    auto lhs = sphere_soa{};
+    auto rhs = sphere_soa{};
+    for(std::size_t i = 0; i < count; ++i) {
+        auto f = static_cast<float>(i);
+        lhs.push_back(sphere{{f, 0.0f, 1.0f}, 1.0f + static_cast<float>(i % 3)});
+        rhs.push_back(sphere{{f + 0.5f * static_cast<float>(i % 5), 2.0f, 1.0f}, 0.5f + static_cast<float>(i % 7)});
+    }
+
+    auto merged = sphere_soa{};
+    merge(lhs, rhs, merged);
+    for(std::size_t i = 0; i < count; ++i) {
+        CAPTURE(i);
+        CHECK(close(merged[i], merge(lhs[i], rhs[i])));
+        CHECK(contains(merged[i], sphere{lhs[i].center, lhs[i].radius - 0.001f}));
+        CHECK(contains(merged[i], sphere{rhs[i].center, rhs[i].radius - 0.001f}));
+    }
+}
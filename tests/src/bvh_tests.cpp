@@ -0,0 +1,218 @@
+#include "utils.hpp"
+#include <admat/bvh.hpp>
+#include <snitch/snitch.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <thread>
+#include <vector>
+
+using namespace admat;
+
+namespace {
+
+struct mesh {
+    std::vector<vec3> vertices;
+    std::vector<std::uint32_t> indices;
+};
+
+// Small triangles scattered through a box, plus a few large ones across it
+auto test_mesh(std::size_t count) -> mesh {
+    auto gen    = std::mt19937(7);
+    auto coords = std::uniform_real_distribution{-20.0f, 20.0f};
+    auto offset = std::uniform_real_distribution{-1.0f, 1.0f};
+
+    auto result = mesh{};
+    for(std::size_t i = 0; i < count; ++i) {
+        auto corner = vec3{coords(gen), coords(gen), coords(gen)};
+        auto scale  = i % 97 == 0 ? 15.0f : 1.0f;
+        for(std::size_t v = 0; v < 3; ++v) {
+            result.indices.push_back(static_cast<std::uint32_t>(result.vertices.size()));
+            result.vertices.push_back(corner + vec3{offset(gen), offset(gen), offset(gen)} * scale);
+        }
+    }
+    return result;
+}
+
+auto test_rays(std::size_t count) -> std::vector<ray> {
+    auto gen    = std::mt19937(11);
+    auto coords = std::uniform_real_distribution{-25.0f, 25.0f};
+
+    auto rays = std::vector<ray>{};
+    for(std::size_t i = 0; i < count; ++i) {
+        auto origin = vec3{coords(gen), coords(gen), coords(gen)};
+        auto target = vec3{coords(gen) * 0.5f, coords(gen) * 0.5f, coords(gen) * 0.5f};
+        rays.push_back(ray{origin, target - origin});
+    }
+    return rays;
+}
+
+auto brute_force_hit(const mesh& geometry, const ray& r) -> float {
+    auto closest = miss;
+    for(std::size_t i = 0; i < geometry.indices.size(); i += 3) {
+        auto hit = intersect(r,
+                             geometry.vertices[geometry.indices[i]],
+                             geometry.vertices[geometry.indices[i + 1]],
+                             geometry.vertices[geometry.indices[i + 2]]);
+        closest  = std::min(closest, hit.t);
+    }
+    return closest;
+}
+
+auto sorted(std::vector<std::uint32_t> values) -> std::vector<std::uint32_t> {
+    std::sort(values.begin(), values.end());
+    return values;
+}
+
+// Same shape as the hierarchy test executor, one thread per chunk
+struct thread_executor {
+    template<typename Fn>
+    auto operator()(std::size_t count, std::size_t grain, Fn&& fn) const -> void {
+        auto threads = std::vector<std::jthread>{};
+        for(std::size_t begin = 0; begin < count; begin += grain) {
+            threads.emplace_back([&fn, begin, end = std::min(begin + grain, count)] { fn(begin, end); });
+        }
+    }
+};
+
+auto check_structure(const bvh& tree, std::span<const aabb> bounds) -> void {
+    auto seen = sorted(std::vector<std::uint32_t>(tree.primitives().begin(), tree.primitives().end()));
+    for(std::size_t i = 0; i < seen.size(); ++i) {
+        REQUIRE(seen[i] == i);
+    }
+
+    auto nodes = tree.nodes();
+    for(std::size_t idx = 0; idx < nodes.size(); ++idx) {
+        CAPTURE(idx);
+        const auto& current = nodes[idx];
+        if(current.count > 0) {
+            CHECK(current.count <= bvh::max_leaf_size);
+            for(auto i = current.first; i < current.first + current.count; ++i) {
+                CHECK(contains(current.bounds, bounds[tree.primitives()[i]]));
+            }
+        } else {
+            CHECK(current.first > idx + 1);
+            CHECK(contains(current.bounds, nodes[idx + 1].bounds));
+            CHECK(contains(current.bounds, nodes[current.first].bounds));
+        }
+    }
+}
+
+} // namespace
+
+TEST_CASE("bvh build", "[bvh]") {
+    auto geometry = test_mesh(3000);
+    auto bounds   = triangle_bounds(geometry.vertices, geometry.indices);
+
+    auto serial   = bvh(bounds);
+    auto parallel = bvh(bounds, thread_executor{}, 256);
+    check_structure(serial, bounds);
+    check_structure(parallel, bounds);
+
+    // Chunked binning sees the same bins, so it makes the same tree
+    REQUIRE(serial.nodes().size() == parallel.nodes().size());
+    CHECK(std::equal(serial.primitives().begin(), serial.primitives().end(), parallel.primitives().begin()));
+
+    CHECK(bvh{}.empty());
+    CHECK(bvh(std::span<const aabb>{}).empty());
+    CHECK(bvh(std::span<const aabb>(bounds.data(), 1)).nodes().size() == 1);
+
+    // Coincident centroids cannot be split by SAH and are split in half instead
+    auto same = std::vector<aabb>(50, aabb{{0, 0, 0}, {1, 1, 1}});
+    check_structure(bvh(same), same);
+}
+
+TEST_CASE("bvh ray queries", "[bvh]") {
+    auto geometry = test_mesh(3000);
+    auto tree     = bvh(triangle_bounds(geometry.vertices, geometry.indices));
+
+    auto hits = 0;
+    for(const auto& r : test_rays(300)) {
+        auto expected = brute_force_hit(geometry, r);
+        auto hit      = closest_hit(tree, geometry.vertices, geometry.indices, r);
+
+        CHECK((hit.t < miss) == (expected < miss));
+        CHECK(any_hit(tree, geometry.vertices, geometry.indices, r) == (expected < miss));
+
+        if(expected < miss) {
+            ++hits;
+            CHECK(almost_equal(hit.t, expected, 0.0001f));
+
+            auto base = 3 * std::size_t{hit.triangle};
+            auto same = intersect(r,
+                                  geometry.vertices[geometry.indices[base]],
+                                  geometry.vertices[geometry.indices[base + 1]],
+                                  geometry.vertices[geometry.indices[base + 2]]);
+            CHECK(almost_equal(same.t, hit.t, 0.0001f));
+            CHECK(almost_equal(same.u, hit.u, 0.0001f));
+
+            // Nothing is hit before the closest hit
+            CHECK_FALSE(any_hit(tree, geometry.vertices, geometry.indices, r, expected * 0.999f));
+        }
+    }
+    CHECK(hits > 10);
+}
+
+TEST_CASE("bvh overlap queries and refit", "[bvh]") {
+    auto geometry = test_mesh(2000);
+    auto bounds   = triangle_bounds(geometry.vertices, geometry.indices);
+    auto tree     = bvh(bounds);
+
+    auto check_queries = [&] {
+        for(std::size_t i = 0; i < 20; ++i) {
+            auto f     = static_cast<float>(i);
+            auto box   = aabb::from_center_extent({f * 2.0f - 20.0f, 5.0f - f, f * 0.5f}, {3.0f, 2.0f, 4.0f});
+            auto probe = sphere{{20.0f - f * 2.0f, f - 10.0f, 0.0f}, 2.0f + f * 0.2f};
+
+            auto box_expected    = std::vector<std::uint32_t>{};
+            auto sphere_expected = std::vector<std::uint32_t>{};
+            for(std::uint32_t prim = 0; prim < bounds.size(); ++prim) {
+                if(overlaps(bounds[prim], box)) {
+                    box_expected.push_back(prim);
+                }
+                if(overlaps(bounds[prim], probe)) {
+                    sphere_expected.push_back(prim);
+                }
+            }
+
+            auto box_found    = std::vector<std::uint32_t>{};
+            auto sphere_found = std::vector<std::uint32_t>{};
+            tree.query(box, [&](std::uint32_t prim) { box_found.push_back(prim); });
+            tree.query(probe, [&](std::uint32_t prim) { sphere_found.push_back(prim); });
+
+            // Leaves are reported whole, so the results may hold extra primitives but no duplicates
+            box_found    = sorted(box_found);
+            sphere_found = sorted(sphere_found);
+
+            CAPTURE(i);
+            CHECK(std::includes(box_found.begin(), box_found.end(), box_expected.begin(), box_expected.end()));
+            CHECK(std::includes(
+                sphere_found.begin(), sphere_found.end(), sphere_expected.begin(), sphere_expected.end()));
+            CHECK(std::adjacent_find(box_found.begin(), box_found.end()) == box_found.end());
+            CHECK(box_found.size() <= (box_expected.size() + 4) * bvh::max_leaf_size);
+        }
+    };
+
+    check_queries();
+
+    // Animate the vertices and refit instead of rebuilding
+    for(std::size_t v = 0; v < geometry.vertices.size(); ++v) {
+        auto f               = static_cast<float>(v);
+        geometry.vertices[v] = geometry.vertices[v] + vec3{std::sin(f) * 3.0f, 2.0f, std::cos(f * 0.5f)};
+    }
+    bounds = triangle_bounds(geometry.vertices, geometry.indices);
+    tree.refit(bounds);
+    check_structure(tree, bounds);
+    check_queries();
+
+    for(const auto& r : test_rays(100)) {
+        auto expected = brute_force_hit(geometry, r);
+        auto hit      = closest_hit(tree, geometry.vertices, geometry.indices, r);
+        CHECK((hit.t < miss) == (expected < miss));
+        if(expected < miss) {
+            CHECK(almost_equal(hit.t, expected, 0.0001f));
+        }
+    }
+}
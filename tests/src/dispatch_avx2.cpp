@@ -0,0 +1,5 @@
+// The avx2 build of the dispatched kernels, compiled with the flags tests/CMakeLists.txt sets for this file
+#define ADMAT_DISPATCH_IMPLEMENTATION
+#include <admat/dispatch.hpp>
+
+static_assert(admat::dispatch::compiled_isa >= admat::dispatch::isa::avx2, "compile this file with the avx2 flags");
@@ -0,0 +1,109 @@
+#include "utils.hpp"
+#include <admat/dispatch.hpp>
+#include <snitch/snitch.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+using namespace admat;
+
+static_assert(dispatch::parse_isa("sse4.2") == dispatch::isa::sse4_2);
+static_assert(dispatch::parse_isa(dispatch::isa_name(dispatch::isa::avx512)) == dispatch::isa::avx512);
+static_assert(!dispatch::parse_isa("avx3").has_value() && !dispatch::parse_isa("").has_value());
+
+TEST_CASE("ISA selection", "[dispatch]") {
+    using dispatch::isa;
+    using dispatch::detail::select_isa;
+
+    CHECK(select_isa(isa::avx2, std::nullopt) == isa::avx2);
+    CHECK(select_isa(isa::avx512, isa::sse4_2) == isa::sse4_2);
+    CHECK(select_isa(isa::avx2, isa::baseline) == isa::baseline);
+
+    // A tier the host does not have cannot be forced
+    CHECK(select_isa(isa::sse4_2, isa::avx512) == isa::sse4_2);
+
+    // The test binary runs, so the host has at least the tier it was compiled for
+    CHECK(dispatch::detect_isa() >= dispatch::compiled_isa);
+    CHECK(dispatch::active_isa() <= dispatch::detect_isa());
+    CHECK(dispatch::kernels().target <= std::max(dispatch::active_isa(), dispatch::compiled_isa));
+}
+
+TEST_CASE("Every tier matches the inline kernels", "[dispatch]") {
+    // Enough elements for several blocks of the widest registers, plus a tail
+    constexpr std::size_t count = 173;
+
+    auto mat     = translation(1.0f, -2.0f, 3.0f) * rotation(vec3{0.3f, 1.0f, -0.5f}, 0.7f);
+    auto points  = std::vector<vec3>{};
+    auto angles  = std::vector<float>{};
+    auto origins = std::vector<dvec3>{};
+    auto colors  = std::vector<vec4>{};
+    auto spheres = sphere_soa{};
+    for(std::size_t i = 0; i < count; ++i) {
+        auto f = static_cast<float>(i);
+        points.push_back(vec3{f * 0.5f - 40.0f, 10.0f - f * 0.25f, f * 0.01f + 0.3f});
+        angles.push_back(f * 0.37f - 30.0f);
+        origins.push_back(dvec3{6378137.0 + static_cast<double>(i), -0.5 * static_cast<double>(i), 12.25});
+        colors.push_back(vec4{f * 0.125f, -f, 1.0f / (f + 1.0f), 0.5f});
+        spheres.push_back(sphere{points.back() * 0.3f + vec3{0.13f, 0.07f, -3.0f}, 0.5f + static_cast<float>(i % 4)});
+    }
+    auto view = frustum::from_mat4(perspective(1.2f, 1.0f, 1.0f, 50.0f));
+
+    auto expected_points = std::vector<vec3>(count);
+    auto expected_mats   = std::vector<mat4>(count);
+    auto expected_sines  = std::vector<float>(count);
+    auto expected_cos    = std::vector<float>(count);
+    auto expected_rebase = std::vector<vec3>(count);
+    auto expected_halves = std::vector<half4>(count);
+    auto expected_bits   = std::vector<std::uint64_t>(3);
+    transform_points(mat, points, expected_points);
+    rotations(points, angles, expected_mats);
+    fast::sincos(angles, expected_sines, expected_cos);
+    rebase(dvec3{6378100.0, 3.0, -7.5}, origins, expected_rebase);
+    to_half(colors, expected_halves);
+    cull(view, spheres, expected_bits);
+
+    for(std::size_t tier = 0; tier <= static_cast<std::size_t>(dispatch::detect_isa()); ++tier) {
+        auto ceiling = static_cast<dispatch::isa>(tier);
+        CAPTURE(dispatch::isa_name(ceiling));
+
+        const auto& table = dispatch::kernels(ceiling);
+        CHECK(table.target <= std::max(ceiling, dispatch::compiled_isa));
+
+        auto result_points = std::vector<vec3>(count);
+        auto result_mats   = std::vector<mat4>(count);
+        auto result_sines  = std::vector<float>(count);
+        auto result_cos    = std::vector<float>(count);
+        auto result_rebase = std::vector<vec3>(count);
+        auto result_halves = std::vector<half4>(count);
+        auto result_colors = std::vector<vec4>(count);
+        auto result_bits   = std::vector<std::uint64_t>(3, ~std::uint64_t{0});
+        table.transform_points(mat, points, result_points);
+        table.rotations(points, angles, result_mats);
+        table.sincos(angles, result_sines, result_cos);
+        table.rebase(dvec3{6378100.0, 3.0, -7.5}, origins, result_rebase);
+        table.to_half(colors, result_halves);
+        table.to_float(result_halves, result_colors);
+        table.cull_spheres(view, spheres, result_bits);
+
+        auto same = true;
+        for(std::size_t i = 0; i < count; ++i) {
+            same = same && close(result_points[i], expected_points[i]) &&
+                   close(result_mats[i], expected_mats[i], 0.000002f) &&
+                   almost_equal(result_sines[i], expected_sines[i], 0.0000002f) &&
+                   almost_equal(result_cos[i], expected_cos[i], 0.0000002f) &&
+                   close(result_rebase[i], expected_rebase[i]) &&
+                   result_halves[i].x.bits == expected_halves[i].x.bits &&
+                   result_halves[i].z.bits == expected_halves[i].z.bits &&
+                   almost_equal(result_colors[i].w, to_float(expected_halves[i].w));
+        }
+        CHECK(same);
+        CHECK(result_bits == expected_bits);
+    }
+
+    // The dispatch:: functions run the active tier's table
+    auto routed = std::vector<vec3>(count);
+    dispatch::transform_points(mat, points, routed);
+    CHECK(close(routed[count - 1], expected_points[count - 1]));
+}
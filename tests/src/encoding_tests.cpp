@@ -0,0 +1,154 @@
+#include "utils.hpp"
+#include <admat/encoding.hpp>
+#include <snitch/snitch.hpp>
+
+#include <cmath>
+#include <cstddef>
+#include <numbers>
+#include <vector>
+
+using namespace admat;
+
+namespace {
+
+// Angle between two directions in degrees, atan2 stays precise for tiny angles where acos does not
+auto degrees_between(const vec3& lhs, const vec3& rhs) -> float {
+    auto sin = magnitude(cross(lhs, rhs));
+    return std::atan2(sin, dot(lhs, rhs)) * 180.0f / std::numbers::pi_v<float>;
+}
+
+// Evenly spread over the sphere, plus the axes and the octahedron edges where the encoding folds
+auto test_normals() -> std::vector<vec3> {
+    auto normals = std::vector<vec3>{
+        {1.0f, 0.0f, 0.0f},
+        {-1.0f, 0.0f, 0.0f},
+        {0.0f, 1.0f, 0.0f},
+        {0.0f, -1.0f, 0.0f},
+        {0.0f, 0.0f, 1.0f},
+        {0.0f, 0.0f, -1.0f},
+        normalize(vec3{1.0f, 1.0f, 0.0f}),
+        normalize(vec3{-1.0f, 1.0f, -0.0f}),
+        normalize(vec3{1.0f, -1.0f, -1e-7f}),
+    };
+
+    constexpr std::size_t count = 20011;
+    auto golden                 = std::numbers::pi_v<float> * (3.0f - std::sqrt(5.0f));
+    for(std::size_t i = 0; i < count; ++i) {
+        auto y      = 1.0f - 2.0f * (static_cast<float>(i) + 0.5f) / static_cast<float>(count);
+        auto radius = std::sqrt(1.0f - y * y);
+        auto angle  = golden * static_cast<float>(i);
+        normals.push_back(normalize(vec3{std::cos(angle) * radius, y, std::sin(angle) * radius}));
+    }
+    return normals;
+}
+
+} // namespace
+
+TEST_CASE("Octahedral round trip error", "[encoding]") {
+    const auto normals = test_normals();
+
+    auto wide   = std::vector<oct16x2>(normals.size());
+    auto narrow = std::vector<oct8x2>(normals.size());
+    auto back16 = std::vector<vec3>(normals.size());
+    auto back8  = std::vector<vec3>(normals.size());
+    to_oct16x2(normals, wide);
+    to_oct8x2(normals, narrow);
+    to_vec3(wide, back16);
+    to_vec3(narrow, back8);
+
+    auto worst16 = 0.0f;
+    auto worst8  = 0.0f;
+    auto unit    = true;
+    for(std::size_t i = 0; i < normals.size(); ++i) {
+        worst16 = std::max(worst16, degrees_between(normals[i], back16[i]));
+        worst8  = std::max(worst8, degrees_between(normals[i], back8[i]));
+        unit    = unit && almost_equal(magnitude(back16[i]), 1.0f, 0.00001f) &&
+               almost_equal(magnitude(back8[i]), 1.0f, 0.00001f);
+    }
+
+    // The bounds documented in encoding.hpp
+    CHECK(worst16 < 0.0038f);
+    CHECK(worst8 < 0.96f);
+    CHECK(unit);
+
+    // Axes come back exactly
+    CHECK(almost_equal(back16[5].z, -1.0f));
+    CHECK(almost_equal(back8[0].x, 1.0f));
+}
+
+TEST_CASE("Octahedral spans match single elements", "[encoding]") {
+    const auto normals = test_normals();
+
+    auto encoded = std::vector<oct16x2>(normals.size());
+    auto decoded = std::vector<vec3>(normals.size());
+    to_oct16x2(normals, encoded);
+    to_vec3(encoded, decoded);
+
+    auto same = true;
+    for(std::size_t i = 0; i < normals.size(); ++i) {
+        auto single = to_oct16x2(normals[i]);
+        auto back   = to_vec3(single);
+        same        = same && single.x == encoded[i].x && single.y == encoded[i].y &&
+               almost_equal(back.x, decoded[i].x, 0.000001f) && almost_equal(back.z, decoded[i].z, 0.000001f);
+    }
+    CHECK(same);
+
+    // Snorms saturate at the type's maximum and never use the extra negative value
+    auto corner = to_oct8x2(vec3{0.0f, 0.0f, -1.0f});
+    CHECK(corner.x == 127);
+    CHECK(corner.y == 127);
+}
+
+TEST_CASE("Qtangent round trip", "[encoding]") {
+    const auto normals = test_normals();
+
+    auto frames = std::vector<tangent_frame>{};
+    for(std::size_t i = 0; i < normals.size(); ++i) {
+        auto normal  = normals[i];
+        auto other   = normals[(i * 7919 + 13) % normals.size()];
+        auto tangent = normalize(other - normal * dot(normal, other));
+        if(std::abs(dot(normal, other)) > 0.999f) {
+            continue;
+        }
+        frames.push_back(tangent_frame{normal, tangent, i % 3 == 0 ? -1.0f : 1.0f});
+    }
+
+    // Half turns about assorted axes have w = 0, where the handedness bias moves w and the bound is looser
+    auto half_turns = std::vector<tangent_frame>{
+        {{0.0f, 0.0f, -1.0f}, {-1.0f, 0.0f, 0.0f}, 1.0f},
+        {{0.0f, 0.0f, -1.0f}, {-1.0f, 0.0f, 0.0f}, -1.0f},
+    };
+    for(const auto& axis : {vec3{1.0f, 0.0f, 0.0f}, vec3{0.0f, 1.0f, 0.0f}, normalize(vec3{1.0f, 2.0f, 3.0f}),
+                            normalize(vec3{-0.3f, 0.9f, 0.1f}), normalize(vec3{0.6f, -0.2f, -0.75f})}) {
+        auto half_turn = [&](const vec3& vec) { return axis * (2.0f * dot(axis, vec)) - vec; };
+        half_turns.push_back(tangent_frame{half_turn({0.0f, 0.0f, 1.0f}), half_turn({1.0f, 0.0f, 0.0f}), 1.0f});
+        half_turns.push_back(tangent_frame{half_turn({0.0f, 0.0f, 1.0f}), half_turn({1.0f, 0.0f, 0.0f}), -1.0f});
+    }
+
+    auto worst_error = [](const std::vector<tangent_frame>& originals, bool& handedness) {
+        auto encoded = std::vector<qtangent>(originals.size());
+        auto decoded = std::vector<tangent_frame>(originals.size());
+        to_qtangent(originals, encoded);
+        to_frame(encoded, decoded);
+
+        auto worst = 0.0f;
+        for(std::size_t i = 0; i < originals.size(); ++i) {
+            worst = std::max(worst, degrees_between(originals[i].normal, decoded[i].normal));
+            worst = std::max(worst, degrees_between(originals[i].tangent, decoded[i].tangent));
+            worst = std::max(worst, degrees_between(bitangent(originals[i]), bitangent(decoded[i])));
+
+            handedness = handedness && almost_equal(originals[i].handedness, decoded[i].handedness);
+        }
+        return worst;
+    };
+
+    // The bounds documented in encoding.hpp
+    auto handedness = true;
+    CHECK(worst_error(frames, handedness) < 0.0043f);
+    CHECK(worst_error(half_turns, handedness) < 0.0047f);
+    CHECK(handedness);
+
+    auto skewed = to_frame(to_qtangent(tangent_frame{{0.0f, 2.0f, 0.0f}, {1.0f, 1.0f, 0.0f}, 1.0f}));
+    CHECK(degrees_between(skewed.normal, vec3{0.0f, 1.0f, 0.0f}) < 0.0043f);
+    CHECK(degrees_between(skewed.tangent, vec3{1.0f, 0.0f, 0.0f}) < 0.0043f);
+}
@@ -0,0 +1,118 @@
+#include "utils.hpp"
+#include <admat/expr.hpp>
+#include <admat/parallel.hpp>
+#include <snitch/snitch.hpp>
+
+#include <vector>
+
+using namespace admat;
+
+namespace {
+
+// 19 elements cover a full SIMD block at every width plus a scalar tail
+auto test_vec4s(float offset) -> std::vector<vec4> {
+    auto vecs = std::vector<vec4>{};
+    for(std::size_t i = 0; i < 19; ++i) {
+        auto f = static_cast<float>(i) + offset;
+        vecs.push_back(vec4{f * 0.5f - 3.0f, 2.0f - f * 0.25f, f * 0.1f + 1.0f, -f});
+    }
+    return vecs;
+}
+
+auto test_vec3s(float offset) -> std::vector<vec3> {
+    auto vecs = std::vector<vec3>{};
+    for(const auto& vec : test_vec4s(offset)) {
+        vecs.push_back(vec3{vec.w, vec.x, vec.z});
+    }
+    return vecs;
+}
+
+} // namespace
+
+TEST_CASE("expression arithmetic", "[expr]") {
+    const auto a4 = test_vec4s(0.0f);
+    const auto b4 = test_vec4s(5.0f);
+    const auto a3 = test_vec3s(0.0f);
+    const auto b3 = test_vec3s(5.0f);
+
+    auto out4 = std::vector<vec4>(a4.size());
+    auto out3 = std::vector<vec3>(a3.size());
+    lazy(out4) = lazy(a4) * 2.5f + lazy(b4);
+    lazy(out3) = (lazy(a3) - lazy(b3)) / 4.0f;
+
+    for(std::size_t i = 0; i < a4.size(); ++i) {
+        CHECK(close(out4[i], a4[i] * 2.5f + b4[i]));
+        CHECK(close(out3[i], (a3[i] - b3[i]) / 4.0f));
+    }
+
+    // Scalars on the left, and spans of float
+    auto weights = std::vector<float>{1.0f, 2.0f, 4.0f, 8.0f, 16.0f, 32.0f, 64.0f, 128.0f, 256.0f};
+    auto inverse = std::vector<float>(weights.size());
+    lazy(inverse) = 1.0f - 2.0f / lazy(weights);
+    for(std::size_t i = 0; i < weights.size(); ++i) {
+        CHECK(almost_equal(inverse[i], 1.0f - 2.0f / weights[i], 0.0001f));
+    }
+
+    // Copying one view into another copies the elements
+    auto copy = std::vector<vec4>(a4.size());
+    lazy(copy) = lazy(a4);
+    CHECK(close(copy.back(), a4.back()));
+}
+
+TEST_CASE("expression lerp clamp and abs", "[expr]") {
+    const auto a4 = test_vec4s(0.0f);
+    const auto b4 = test_vec4s(5.0f);
+    const auto a3 = test_vec3s(0.0f);
+
+    auto blended = std::vector<vec4>(a4.size());
+    auto bounded = std::vector<vec4>(a4.size());
+    auto lengths = std::vector<vec3>(a3.size());
+    lazy(blended) = lerp(lazy(a4), lazy(b4), 0.25f);
+    lazy(bounded) = clamp(lazy(a4) * 2.0f, -1.0f, 1.0f);
+    lazy(lengths) = abs(lazy(a3));
+
+    for(std::size_t i = 0; i < a4.size(); ++i) {
+        CHECK(close(blended[i], lerp(a4[i], b4[i], 0.25f)));
+        CHECK(close(bounded[i], clamp(a4[i] * 2.0f, -1.0f, 1.0f)));
+        CHECK(close(lengths[i], abs(a3[i])));
+    }
+}
+
+TEST_CASE("expression in place", "[expr]") {
+    const auto velocity = test_vec4s(3.0f);
+    const auto start    = test_vec4s(0.0f);
+
+    auto position = start;
+    lazy(position) += lazy(velocity) * 0.5f;
+    lazy(position) *= 2.0f;
+    lazy(position) = lazy(position) - lazy(velocity);
+
+    for(std::size_t i = 0; i < start.size(); ++i) {
+        CHECK(close(position[i], (start[i] + velocity[i] * 0.5f) * 2.0f - velocity[i]));
+    }
+}
+
+TEST_CASE("expression through an executor", "[expr]") {
+    auto pool = thread_pool(2);
+
+    auto a = std::vector<vec4>{};
+    auto b = std::vector<vec4>{};
+    for(std::size_t i = 0; i < 1001; ++i) {
+        auto f = static_cast<float>(i);
+        a.push_back(vec4{f, -f, f * 0.5f, 1.0f});
+        b.push_back(vec4{1.0f, 2.0f, 3.0f, f});
+    }
+
+    auto serial = std::vector<vec4>(a.size());
+    auto pooled = std::vector<vec4>(a.size());
+    lazy(serial) = lerp(lazy(a), lazy(b), 0.75f) * 3.0f;
+    assign(pool, lazy(pooled), lerp(lazy(a), lazy(b), 0.75f) * 3.0f, 37);
+    assign(serial_executor{}, lazy(a), lazy(a) + 1.0f, 64);
+
+    auto same = true;
+    for(std::size_t i = 0; i < a.size(); ++i) {
+        auto f = static_cast<float>(i);
+        same   = same && close(serial[i], pooled[i]) && close(a[i], vec4{f + 1.0f, 1.0f - f, f * 0.5f + 1.0f, 2.0f});
+    }
+    CHECK(same);
+}
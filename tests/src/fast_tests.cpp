@@ -0,0 +1,198 @@
+#include "utils.hpp"
+#include <admat/fast.hpp>
+#include <snitch/snitch.hpp>
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <limits>
+#include <numbers>
+#include <vector>
+
+using namespace admat;
+
+static_assert(almost_equal(fast::sincos(0.0f).sin, 0.0f) && almost_equal(fast::sincos(0.0f).cos, 1.0f));
+static_assert(fast::sin(std::numbers::pi_v<float> / 6.0f) > 0.4999999f);
+static_assert(fast::cos(-std::numbers::pi_v<float>) < -0.9999999f);
+
+namespace {
+
+// Distance of got from want in units of the spacing between floats next to want
+auto ulp_error(float got, double want) -> double {
+    auto rounded = std::abs(static_cast<float>(want));
+    auto spacing = std::nextafter(rounded, std::numeric_limits<float>::infinity()) - rounded;
+    return std::abs(static_cast<double>(got) - want) / static_cast<double>(spacing);
+}
+
+// Calls fn with every stride-th float from first to last, both positive, and with its negation
+template<typename Fn>
+auto each_float(float first, float last, std::uint32_t stride, Fn&& fn) -> void {
+    for(auto bits = std::bit_cast<std::uint32_t>(first); bits <= std::bit_cast<std::uint32_t>(last); bits += stride) {
+        fn(std::bit_cast<float>(bits));
+        fn(-std::bit_cast<float>(bits));
+    }
+}
+
+// Directions and lengths spread over many magnitudes
+auto test_vectors() -> std::vector<vec3> {
+    auto vectors = std::vector<vec3>{};
+    for(std::size_t i = 0; i < 50000; ++i) {
+        auto f     = static_cast<float>(i);
+        auto scale = std::exp2(static_cast<float>(i % 80) - 40.0f);
+        vectors.push_back(vec3{std::sin(f * 1.7f), std::cos(f * 0.3f), std::sin(f * 0.11f + 1.0f)} * scale);
+    }
+    return vectors;
+}
+
+} // namespace
+
+TEST_CASE("Fast reciprocals", "[fast]") {
+    auto worst_rsqrt = 0.0;
+    auto worst_rcp   = 0.0;
+    each_float(std::numeric_limits<float>::min(), 8.5e37f, 97, [&](float value) {
+        worst_rcp = std::max(worst_rcp, ulp_error(fast::rcp(value), 1.0 / static_cast<double>(value)));
+        if(value > 0.0f) {
+            auto exact  = 1.0 / std::sqrt(static_cast<double>(value));
+            worst_rsqrt = std::max(worst_rsqrt, ulp_error(fast::rsqrt(value), exact));
+        }
+    });
+
+    // The bounds documented in fast.hpp
+    CHECK(worst_rsqrt <= 4.0);
+    CHECK(worst_rcp <= 3.5);
+    CHECK(fast::rsqrt(std::numeric_limits<float>::max()) > 0.0f);
+}
+
+TEST_CASE("Fast sin and cos", "[fast]") {
+    auto worst = 0.0;
+    each_float(std::numeric_limits<float>::denorm_min(), std::numbers::pi_v<float>, 61, [&](float radians) {
+        auto [sin, cos] = fast::sincos(radians);
+        worst           = std::max(worst, ulp_error(sin, std::sin(static_cast<double>(radians))));
+        worst           = std::max(worst, ulp_error(cos, std::cos(static_cast<double>(radians))));
+    });
+
+    auto worst_absolute = 0.0;
+    each_float(std::numbers::pi_v<float>, 8192.0f, 13, [&](float radians) {
+        auto [sin, cos] = fast::sincos(radians);
+        auto sin_error  = std::abs(static_cast<double>(sin) - std::sin(static_cast<double>(radians)));
+        auto cos_error  = std::abs(static_cast<double>(cos) - std::cos(static_cast<double>(radians)));
+        worst_absolute  = std::max({worst_absolute, sin_error, cos_error});
+    });
+
+    CHECK(worst <= 1.5);
+    CHECK(worst_absolute <= 8e-8);
+    CHECK(almost_equal(fast::sin(0.5f), fast::sincos(0.5f).sin));
+    CHECK(almost_equal(fast::cos(0.5f), fast::sincos(0.5f).cos));
+}
+
+TEST_CASE("Fast sincos over spans", "[fast]") {
+    auto radians = std::vector<float>{};
+    each_float(std::numeric_limits<float>::denorm_min(), std::numbers::pi_v<float>, 4099, [&](float value) {
+        radians.push_back(value);
+    });
+    for(std::size_t i = 0; i < 5000; ++i) {
+        radians.push_back(static_cast<float>(i) * 1.6384f - 4096.0f);
+    }
+
+    auto sines   = std::vector<float>(radians.size());
+    auto cosines = std::vector<float>(radians.size());
+    fast::sincos(radians, sines, cosines);
+
+    // The span kernel fuses its multiply adds where the target has FMA and breaks quadrant ties to even, so it matches
+    // the single angle function within the bounds rather than bit for bit
+    auto worst          = 0.0;
+    auto worst_absolute = 0.0;
+    for(std::size_t i = 0; i < radians.size(); ++i) {
+        auto sin = std::sin(static_cast<double>(radians[i]));
+        auto cos = std::cos(static_cast<double>(radians[i]));
+        if(std::abs(radians[i]) <= std::numbers::pi_v<float>) {
+            worst = std::max({worst, ulp_error(sines[i], sin), ulp_error(cosines[i], cos)});
+        }
+        auto sin_error = std::abs(static_cast<double>(sines[i]) - sin);
+        auto cos_error = std::abs(static_cast<double>(cosines[i]) - cos);
+        worst_absolute = std::max({worst_absolute, sin_error, cos_error});
+    }
+
+    CHECK(worst <= 1.5);
+    CHECK(worst_absolute <= 8e-8);
+}
+
+TEST_CASE("Fast tan", "[fast]") {
+    auto worst = 0.0;
+    each_float(std::numeric_limits<float>::min(), std::numbers::pi_v<float> / 4.0f, 61, [&](float radians) {
+        worst = std::max(worst, ulp_error(fast::tan(radians), std::tan(static_cast<double>(radians))));
+    });
+
+    auto worst_relative = 0.0;
+    each_float(std::numbers::pi_v<float> / 4.0f, 1.5f, 61, [&](float radians) {
+        auto exact     = std::tan(static_cast<double>(radians));
+        worst_relative = std::max(worst_relative, std::abs(static_cast<double>(fast::tan(radians)) - exact) / exact);
+    });
+
+    CHECK(worst <= 5.0);
+    CHECK(worst_relative <= 4e-7);
+}
+
+TEST_CASE("Fast vector functions", "[fast]") {
+    const auto vectors = test_vectors();
+
+    auto worst_magnitude = 0.0;
+    auto worst_normalize = 0.0;
+    for(const auto& vec : vectors) {
+        auto x      = static_cast<double>(vec.x);
+        auto y      = static_cast<double>(vec.y);
+        auto z      = static_cast<double>(vec.z);
+        auto length = std::sqrt(x * x + y * y + z * z);
+
+        auto unit       = fast::normalize(vec);
+        worst_magnitude = std::max(worst_magnitude, ulp_error(fast::magnitude(vec), length));
+        worst_normalize = std::max({
+            worst_normalize,
+            ulp_error(unit.x, x / length),
+            ulp_error(unit.y, y / length),
+            ulp_error(unit.z, z / length),
+        });
+    }
+
+    CHECK(worst_magnitude <= 4.5);
+    CHECK(worst_normalize <= 5.0);
+
+    // Same results for the SIMD vec4 overloads, and no division by zero for the zero vector
+    auto lhs = vec4{1.0f, -2.0f, 3.0f, 0.5f};
+    auto rhs = vec4{-4.0f, 2.0f, 0.0f, 8.0f};
+    CHECK(almost_equal(fast::distance(lhs, rhs), distance(lhs, rhs), 0.000005f));
+    CHECK(almost_equal(fast::normalize(rhs).z, normalize(rhs).z, 0.000001f));
+    CHECK(almost_equal(fast::magnitude(vec3{}), 0.0f));
+    CHECK(almost_equal(fast::magnitude(vec2{3e-20f, 4e-20f}), 5e-20f, 1e-22f));
+}
+
+TEST_CASE("Fast rotations and projections", "[fast]") {
+    auto axis = vec3{1.0f, 2.0f, -0.5f};
+    for(auto radians : {-3.0f, -0.25f, 0.0f, 1.0f, 2.5f, 100.0f}) {
+        auto exact  = rotation(axis, radians);
+        auto approx = fast::rotation(axis, radians);
+        auto all    = true;
+        for(std::size_t row = 0; row < 4; ++row) {
+            for(std::size_t col = 0; col < 4; ++col) {
+                all = all && almost_equal(approx[row, col], exact[row, col], 0.000002f);
+            }
+        }
+        CHECK(all);
+
+        auto exact_quat = quat::from_axis_angle(axis, radians);
+        auto fast_quat  = fast::from_axis_angle(axis, radians);
+        CHECK(almost_equal(dot(exact_quat, fast_quat), 1.0f, 0.000002f));
+        CHECK(almost_equal(magnitude(fast::normalize(fast_quat * 3.0f)), 1.0f, 0.000002f));
+    }
+
+    for(auto fov : {0.1f, 1.0f, 1.5707964f, 3.0f}) {
+        auto exact  = perspective(fov, 16.0f / 9.0f, 0.1f, 100.0f);
+        auto approx = fast::perspective(fov, 16.0f / 9.0f, 0.1f, 100.0f);
+        CHECK(almost_equal(approx[0, 0] / exact[0, 0], 1.0f, 0.000002f));
+        CHECK(almost_equal(approx[1, 1] / exact[1, 1], 1.0f, 0.000002f));
+        CHECK(almost_equal(approx[2, 3], exact[2, 3]));
+    }
+}
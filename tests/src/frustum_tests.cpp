@@ -0,0 +1,104 @@
+#include "utils.hpp"
+#include <admat/frustum.hpp>
+#include <snitch/snitch.hpp>
+
+#include <cstdint>
+#include <vector>
+
+using namespace admat;
+
+namespace {
+
+// Camera at (0, 0, 5) looking down -z with a 90 degree vertical field of view
+auto test_frustum() -> frustum {
+    return frustum::from_mat4(perspective(1.5707964f, 1.0f, 1.0f, 100.0f) *
+                              look_at({0.0f, 0.0f, 5.0f}, {0.0f, 0.0f, 0.0f}, {0.0f, 1.0f, 0.0f}));
+}
+
+// The offsets keep corners off the planes, where FMA contraction could flip the result of an exact zero distance
+auto test_point(std::size_t idx) -> vec3 {
+    auto f = static_cast<float>(idx);
+    return vec3{(f - 18.0f) * 3.0f + 0.37f, (f - 18.0f) * 0.5f + 0.21f, 5.13f - (f - 6.0f) * 4.0f};
+}
+
+} // namespace
+
+TEST_CASE("frustum plane extraction", "[frustum]") {
+    auto view = test_frustum();
+
+    // Near plane at z = 4 facing -z, far plane at z = -95 facing +z
+    CHECK(almost_equal(view.planes[4].normal.z, -1.0f, 0.0001f));
+    CHECK(almost_equal(view.planes[4].distance, 4.0f, 0.0001f));
+    CHECK(almost_equal(view.planes[5].normal.z, 1.0f, 0.0001f));
+    CHECK(almost_equal(view.planes[5].distance, 95.0f, 0.001f));
+
+    // Side planes pass through the eye at 45 degrees
+    for(const auto& pln : view.planes) {
+        CHECK(almost_equal(dot(pln.normal, pln.normal), 1.0f, 0.0001f));
+    }
+    CHECK(almost_equal(signed_distance(view.planes[0], {0.0f, 0.0f, 5.0f}), 0.0f, 0.0001f));
+    CHECK(almost_equal(view.planes[0].normal.x, 0.70710677f, 0.0001f));
+    CHECK(almost_equal(view.planes[3].normal.y, -0.70710677f, 0.0001f));
+}
+
+TEST_CASE("frustum sphere visibility", "[frustum]") {
+    auto view = test_frustum();
+
+    CHECK(visible(view, {0.0f, 0.0f, 0.0f}, 1.0f));
+    CHECK(visible(view, {0.0f, 0.0f, -94.5f}, 1.0f));
+    CHECK_FALSE(visible(view, {0.0f, 0.0f, 7.0f}, 1.0f));
+    CHECK(visible(view, {0.0f, 0.0f, 4.5f}, 1.0f));
+    CHECK_FALSE(visible(view, {0.0f, 0.0f, -97.0f}, 1.0f));
+    CHECK_FALSE(visible(view, {20.0f, 0.0f, 0.0f}, 1.0f));
+    CHECK(visible(view, {5.5f, 0.0f, 0.0f}, 1.0f));
+    CHECK_FALSE(visible(view, {0.0f, -20.0f, 0.0f}, 1.0f));
+}
+
+TEST_CASE("frustum aabb visibility", "[frustum]") {
+    auto view = test_frustum();
+
+    CHECK(visible(view, {-1.0f, -1.0f, -1.0f}, {1.0f, 1.0f, 1.0f}));
+    CHECK(visible(view, {-50.0f, -50.0f, -10.0f}, {50.0f, 50.0f, -9.0f}));
+    CHECK_FALSE(visible(view, {-1.0f, -1.0f, 6.0f}, {1.0f, 1.0f, 8.0f}));
+    CHECK_FALSE(visible(view, {-1.0f, -1.0f, -99.0f}, {1.0f, 1.0f, -96.0f}));
+    CHECK_FALSE(visible(view, {10.0f, -1.0f, -1.0f}, {12.0f, 1.0f, 1.0f}));
+    CHECK(visible(view, {4.0f, -1.0f, -1.0f}, {12.0f, 1.0f, 1.0f}));
+}
+
+TEST_CASE("frustum batched culling", "[frustum]") {
+    auto view = test_frustum();
+
+    // More than two words, with a tail that is not a multiple of any block width
+    constexpr std::size_t count = 137;
+
+    auto centers = vec3_soa{};
+    auto radii   = std::vector<float>{};
+    auto mins    = vec3_soa{};
+    auto maxs    = vec3_soa{};
+    for(std::size_t i = 0; i < count; ++i) {
+        auto center = test_point(i % 37) + vec3{0.0f, static_cast<float>(i / 37) * 2.0f, 0.0f};
+        auto extent = 0.5f + static_cast<float>(i % 5);
+        centers.push_back(center);
+        radii.push_back(extent);
+        mins.push_back(center - extent);
+        maxs.push_back(center + extent);
+    }
+
+    // Stale bits must be cleared
+    auto spheres = std::vector<std::uint64_t>(3, ~std::uint64_t{0});
+    auto boxes   = std::vector<std::uint64_t>(3, ~std::uint64_t{0});
+    cull_spheres(view, centers, radii, spheres);
+    cull_aabbs(view, mins, maxs, boxes);
+
+    auto visible_count = 0;
+    for(std::size_t i = 0; i < count; ++i) {
+        CAPTURE(i);
+        CHECK(is_set(spheres, i) == visible(view, centers[i], radii[i]));
+        CHECK(is_set(boxes, i) == visible(view, mins[i], maxs[i]));
+        visible_count += is_set(spheres, i) ? 1 : 0;
+    }
+
+    CHECK(visible_count > 0);
+    CHECK(visible_count < static_cast<int>(count));
+    CHECK((spheres[2] >> (count % 64)) == 0);
+}
@@ -0,0 +1,140 @@
+#include "utils.hpp"
+#include <admat/half.hpp>
+#include <snitch/snitch.hpp>
+
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+using namespace admat;
+
+static_assert(to_half(1.0f).bits == 0x3c00);
+static_assert(to_half(-2.0f).bits == 0xc000);
+static_assert(to_half(65504.0f).bits == 0x7bff);
+static_assert(to_half(65519.0f).bits == 0x7bff);
+static_assert(to_half(65520.0f).bits == 0x7c00);
+static_assert(to_half(std::numeric_limits<float>::infinity()).bits == 0x7c00);
+static_assert(to_half(-0.0f).bits == 0x8000);
+
+// Smallest subnormal is 2^-24, half of it ties to even and rounds to zero, anything more rounds up
+static_assert(to_half(5.9604645e-8f).bits == 0x0001);
+static_assert(to_half(2.9802322e-8f).bits == 0x0000);
+static_assert(to_half(2.9802326e-8f).bits == 0x0001);
+
+// Ties between two halves go to the even mantissa
+static_assert(to_half(1.0f + 1.0f / 2048.0f).bits == 0x3c00);
+static_assert(to_half(1.0f + 3.0f / 2048.0f).bits == 0x3c02);
+
+static_assert(to_float(half{0x3555}) > 0.33325f && to_float(half{0x3555}) < 0.33326f);
+static_assert(to_float(half{0x0001}) > 5.96e-8f && to_float(half{0x0001}) < 5.97e-8f);
+
+namespace {
+
+auto is_nan(half value) -> bool {
+    return (value.bits & 0x7c00u) == 0x7c00u && (value.bits & 0x3ffu) != 0;
+}
+
+// Floats spread over every exponent, plus the values halfway between neighbouring halves and either side of them
+auto test_floats() -> std::vector<float> {
+    auto floats = std::vector<float>{};
+    for(std::uint32_t bits = 0; bits < 0xffff0000u; bits += 0x10001u) {
+        floats.push_back(std::bit_cast<float>(bits));
+    }
+    for(std::uint32_t bits = 0; bits < 0x7c00u; bits += 7) {
+        auto halfway = (to_float(half{static_cast<std::uint16_t>(bits)}) +
+                        to_float(half{static_cast<std::uint16_t>(bits + 1)})) * 0.5f;
+        floats.push_back(halfway);
+        floats.push_back(std::nextafter(halfway, 0.0f));
+        floats.push_back(-std::nextafter(halfway, 1.0e6f));
+    }
+    return floats;
+}
+
+} // namespace
+
+TEST_CASE("Half round trips every value", "[half]") {
+    auto exact = true;
+    for(std::uint32_t bits = 0; bits <= 0xffffu; ++bits) {
+        auto value = half{static_cast<std::uint16_t>(bits)};
+        auto back  = to_half(to_float(value));
+        exact      = exact && (is_nan(value) ? is_nan(back) : back.bits == value.bits);
+    }
+    CHECK(exact);
+
+    CHECK(std::isnan(to_float(half{0x7e00})));
+    CHECK(std::isinf(to_float(half{0xfc00})));
+    CHECK(is_nan(to_half(std::numeric_limits<float>::quiet_NaN())));
+}
+
+TEST_CASE("Half span conversions match the scalar ones", "[half]") {
+    auto floats = test_floats();
+    floats.resize(floats.size() / 4 * 4);
+
+    // The same floats as vec4 and vec2, which convert as one flat array
+    auto vec4s = std::vector<vec4>{};
+    auto vec2s = std::vector<vec2>{};
+    auto vec3s = std::vector<vec3>{};
+    for(std::size_t i = 0; i < floats.size(); i += 4) {
+        vec4s.push_back(vec4{floats[i], floats[i + 1], floats[i + 2], floats[i + 3]});
+        vec2s.push_back(vec2{floats[i], floats[i + 1]});
+        vec2s.push_back(vec2{floats[i + 2], floats[i + 3]});
+        vec3s.push_back(vec3{floats[i], floats[i + 1], floats[i + 2]});
+    }
+
+    auto half4s  = std::vector<half4>(vec4s.size());
+    auto half2s  = std::vector<half2>(vec2s.size());
+    auto half3s  = std::vector<half4>(vec3s.size());
+    to_half(vec4s, half4s);
+    to_half(vec2s, half2s);
+    to_half(vec3s, half3s);
+
+    auto same_half = [](half lhs, half rhs) { return is_nan(lhs) ? is_nan(rhs) : lhs.bits == rhs.bits; };
+    auto all       = true;
+    for(std::size_t i = 0; i < vec4s.size(); ++i) {
+        all = all && same_half(half4s[i].w, to_half(floats[i * 4])) &&
+              same_half(half4s[i].z, to_half(floats[i * 4 + 3])) && same_half(half2s[i * 2 + 1].x, half4s[i].y) &&
+              same_half(half3s[i].y, half4s[i].y) && half3s[i].z.bits == 0;
+    }
+    CHECK(all);
+
+    auto back4 = std::vector<vec4>(half4s.size());
+    auto back2 = std::vector<vec2>(half2s.size());
+    auto back3 = std::vector<vec3>(half3s.size());
+    to_float(half4s, back4);
+    to_float(half2s, back2);
+    to_float(half3s, back3);
+
+    auto same_float = [](float lhs, float rhs) { return std::isnan(lhs) ? std::isnan(rhs) : almost_equal(lhs, rhs); };
+    all             = true;
+    for(std::size_t i = 0; i < back4.size(); ++i) {
+        all = all && same_float(back4[i].w, to_float(half4s[i].w)) && same_float(back4[i].z, to_float(half4s[i].z)) &&
+              same_float(back2[i * 2 + 1].y, back4[i].z) && same_float(back3[i].z, back4[i].y);
+    }
+    CHECK(all);
+}
+
+TEST_CASE("Half span tails", "[half]") {
+    // Every count up to past the widest block, so each loop and the tail run
+    for(std::size_t count = 0; count < 21; ++count) {
+        auto vecs = std::vector<vec2>{};
+        for(std::size_t i = 0; i < count; ++i) {
+            auto f = static_cast<float>(i);
+            vecs.push_back(vec2{f * 0.1f - 1.0f, 1000.0f - f * 17.0f});
+        }
+
+        auto halves = std::vector<half2>(count);
+        auto back   = std::vector<vec2>(count);
+        to_half(vecs, halves);
+        to_float(halves, back);
+
+        auto all = true;
+        for(std::size_t i = 0; i < count; ++i) {
+            all = all && almost_equal(back[i].x, to_float(to_half(vecs[i].x))) &&
+                  almost_equal(back[i].y, to_float(to_half(vecs[i].y)));
+        }
+        CHECK(all);
+    }
+}
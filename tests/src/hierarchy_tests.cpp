@@ -0,0 +1,118 @@
+#include "utils.hpp"
+#include <admat/hierarchy.hpp>
+#include <snitch/snitch.hpp>
+
+#include <thread>
+#include <vector>
+
+using namespace admat;
+
+namespace {
+
+auto test_local(std::size_t idx) -> mat4 {
+    auto f = static_cast<float>(idx);
+    return translation(f * 0.1f, 1.0f, -f * 0.05f) * rotation(vec3{0.3f, 1.0f, f}, f * 0.2f);
+}
+
+// Parents are interleaved across depths so the storage order differs from the id order
+auto test_parents() -> std::vector<hierarchy::node> {
+    return {hierarchy::no_parent, 0, 0, 1, hierarchy::no_parent, 3, 4, 2, 1, 5, 6, 9, 0, 11, 4};
+}
+
+// Walks the parent chain of every node, the way a pointer-based scene graph would
+auto expected_worlds(const hierarchy& tree) -> std::vector<mat4> {
+    auto worlds = std::vector<mat4>(tree.size());
+    for(hierarchy::node id = 0; id < tree.size(); ++id) {
+        worlds[id] = tree.local(id);
+        for(auto parent = tree.parent(id); parent != hierarchy::no_parent; parent = tree.parent(parent)) {
+            worlds[id] = tree.local(parent) * worlds[id];
+        }
+    }
+    return worlds;
+}
+
+// Splits the range into grain sized chunks and runs each on its own thread
+struct thread_executor {
+    template<typename Fn>
+    auto operator()(std::size_t count, std::size_t grain, Fn&& fn) const -> void {
+        auto threads = std::vector<std::jthread>{};
+        for(std::size_t begin = 0; begin < count; begin += grain) {
+            threads.emplace_back([&fn, begin, end = std::min(begin + grain, count)] { fn(begin, end); });
+        }
+    }
+};
+
+} // namespace
+
+TEST_CASE("hierarchy propagation", "[hierarchy]") {
+    auto parents = test_parents();
+    auto locals  = std::vector<mat4>{};
+    for(std::size_t i = 0; i < parents.size(); ++i) {
+        locals.push_back(test_local(i));
+    }
+
+    auto tree = hierarchy(parents, locals);
+    tree.update();
+
+    auto expected = expected_worlds(tree);
+    for(hierarchy::node id = 0; id < tree.size(); ++id) {
+        CAPTURE(id);
+        CHECK(tree.parent(id) == parents[id]);
+        CHECK(close(tree.local(id), locals[id]));
+        CHECK(close(tree.world(id), expected[id]));
+    }
+}
+
+TEST_CASE("hierarchy dirty subtree", "[hierarchy]") {
+    auto tree    = hierarchy{};
+    auto parents = test_parents();
+    for(std::size_t i = 0; i < parents.size(); ++i) {
+        tree.add(test_local(i), parents[i]);
+    }
+    tree.update();
+
+    auto before = expected_worlds(tree);
+
+    // Node 3 has the subtree 3 -> 5 -> 9 -> 11 -> 13
+    tree.set_local(3, scaling(2.0f, 2.0f, 2.0f));
+    tree.update();
+
+    auto after = expected_worlds(tree);
+    for(hierarchy::node id = 0; id < tree.size(); ++id) {
+        CAPTURE(id);
+        CHECK(close(tree.world(id), after[id]));
+    }
+
+    CHECK(close(tree.world(0), before[0]));
+    CHECK(close(tree.world(8), before[8]));
+    CHECK_FALSE(close(tree.world(13), before[13]));
+
+    // Nodes added after an update land in the right level
+    auto leaf = tree.add(translation(0.0f, 0.0f, 5.0f), 13);
+    auto root = tree.add(translation(1.0f, 0.0f, 0.0f));
+    tree.update();
+    CHECK(close(tree.world(leaf), tree.world(13) * translation(0.0f, 0.0f, 5.0f)));
+    CHECK(close(tree.world(root), translation(1.0f, 0.0f, 0.0f)));
+}
+
+TEST_CASE("hierarchy parallel update", "[hierarchy]") {
+    // Wide levels: 3 roots, 200 children, 600 grandchildren
+    auto tree = hierarchy{};
+    for(std::size_t i = 0; i < 3; ++i) {
+        tree.add(test_local(i));
+    }
+    for(std::size_t i = 0; i < 200; ++i) {
+        tree.add(test_local(i + 3), static_cast<hierarchy::node>(i % 3));
+    }
+    for(std::size_t i = 0; i < 600; ++i) {
+        tree.add(test_local(i + 203), static_cast<hierarchy::node>(3 + i % 200));
+    }
+
+    tree.update(thread_executor{}, 64);
+
+    auto expected = expected_worlds(tree);
+    for(hierarchy::node id = 0; id < tree.size(); ++id) {
+        CAPTURE(id);
+        CHECK(close(tree.world(id), expected[id]));
+    }
+}
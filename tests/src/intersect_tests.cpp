@@ -0,0 +1,215 @@
+#include "utils.hpp"
+#include <admat/intersect.hpp>
+#include <snitch/snitch.hpp>
+
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+using namespace admat;
+
+namespace {
+
+// Same distance, or both misses
+auto same_t(float lhs, float rhs) -> bool {
+    return (lhs < miss) == (rhs < miss) && (!(lhs < miss) || almost_equal(lhs, rhs, 0.0001f));
+}
+
+// 37 elements cover a full SIMD block at every width plus a scalar tail. Every few elements is placed to miss.
+constexpr std::size_t count = 37;
+
+auto test_triangle(std::size_t idx) -> std::array<vec3, 3> {
+    auto f      = static_cast<float>(idx);
+    auto corner = vec3{std::sin(f) * 3.0f, std::cos(f * 0.7f) * 3.0f, f * 0.25f - 4.0f};
+    return {corner, corner + vec3{2.0f + f * 0.1f, 0.5f, 0.3f}, corner + vec3{0.4f, 2.5f, -0.2f}};
+}
+
+auto test_ray(std::size_t idx) -> ray {
+    auto f = static_cast<float>(idx);
+    return ray{{std::sin(f * 1.3f) * 2.0f, std::cos(f) * 2.0f, -8.0f}, {0.1f * std::sin(f), 0.05f, 1.0f}};
+}
+
+} // namespace
+
+TEST_CASE("ray triangle intersection", "[intersect]") {
+    auto v0 = vec3{-1.0f, -1.0f, 0.0f};
+    auto v1 = vec3{1.0f, -1.0f, 0.0f};
+    auto v2 = vec3{-1.0f, 1.0f, 0.0f};
+
+    auto hit = intersect(ray{{-0.5f, -0.5f, 2.0f}, {0.0f, 0.0f, -1.0f}}, v0, v1, v2);
+    CHECK(almost_equal(hit.t, 2.0f, 0.0001f));
+    CHECK(almost_equal(hit.u, 0.25f, 0.0001f));
+    CHECK(almost_equal(hit.v, 0.25f, 0.0001f));
+
+    // Both faces, unnormalized direction
+    auto back = intersect(ray{{-0.5f, -0.5f, -3.0f}, {0.0f, 0.0f, 2.0f}}, v0, v1, v2);
+    CHECK(almost_equal(back.t, 1.5f, 0.0001f));
+
+    CHECK_FALSE(intersect(ray{{0.5f, 0.5f, 2.0f}, {0.0f, 0.0f, -1.0f}}, v0, v1, v2).t < miss);
+    CHECK_FALSE(intersect(ray{{-0.5f, -0.5f, 2.0f}, {0.0f, 0.0f, 1.0f}}, v0, v1, v2).t < miss);
+    CHECK_FALSE(intersect(ray{{-0.5f, -0.5f, 2.0f}, {1.0f, 0.0f, 0.0f}}, v0, v1, v2).t < miss);
+}
+
+TEST_CASE("ray aabb intersection", "[intersect]") {
+    auto box = aabb{{-1.0f, -1.0f, -1.0f}, {1.0f, 1.0f, 1.0f}};
+
+    CHECK(almost_equal(intersect(ray{{-5.0f, 0.0f, 0.0f}, {1.0f, 0.0f, 0.0f}}, box), 4.0f, 0.0001f));
+    CHECK(almost_equal(intersect(ray{{-5.0f, -5.0f, 0.0f}, {1.0f, 1.0f, 0.0f}}, box), 4.0f, 0.0001f));
+    CHECK(almost_equal(intersect(ray{{0.0f, 0.0f, 0.0f}, {0.0f, 1.0f, 0.0f}}, box), 0.0f, 0.0001f));
+
+    CHECK_FALSE(intersect(ray{{-5.0f, 0.0f, 0.0f}, {-1.0f, 0.0f, 0.0f}}, box) < miss);
+    CHECK_FALSE(intersect(ray{{-5.0f, 2.0f, 0.0f}, {1.0f, 0.0f, 0.0f}}, box) < miss);
+    CHECK_FALSE(intersect(ray{{-5.0f, 0.0f, 0.0f}, {1.0f, 0.0f, 0.0f}}, box, 3.0f) < miss);
+}
+
+TEST_CASE("packet ray intersection", "[intersect]") {
+    auto triangles = triangle_soa{};
+    auto boxes     = aabb_soa{};
+    auto rays      = ray_soa{};
+    for(std::size_t i = 0; i < count; ++i) {
+        auto [v0, v1, v2] = test_triangle(i);
+        triangles.push_back(v0, v1, v2);
+        boxes.push_back(merge(merge(aabb{v0, v0}, v1), v2));
+        rays.push_back(test_ray(i));
+    }
+
+    auto probe          = ray{{0.0f, 0.0f, -10.0f}, {0.05f, 0.1f, 1.0f}};
+    auto [t0, t1, t2]   = test_triangle(5);
+    auto box            = boxes[5];
+    auto triangle_hits  = std::vector<std::uint64_t>(1, ~std::uint64_t{0});
+    auto box_hits       = std::vector<std::uint64_t>(1, ~std::uint64_t{0});
+    auto ray_tri_hits   = std::vector<std::uint64_t>(1, ~std::uint64_t{0});
+    auto ray_box_hits   = std::vector<std::uint64_t>(1, ~std::uint64_t{0});
+    auto triangle_t     = std::vector<float>(count);
+    auto box_t          = std::vector<float>(count);
+    auto ray_triangle_t = std::vector<float>(count);
+    auto ray_box_t      = std::vector<float>(count);
+
+    intersect(probe, triangles, triangle_hits, triangle_t);
+    intersect(probe, boxes, box_hits, box_t, 12.0f);
+    intersect(rays, t0, t1, t2, ray_tri_hits, ray_triangle_t);
+    intersect(rays, box, ray_box_hits, ray_box_t);
+
+    auto expected = ray_hit{0, miss, 0.0f, 0.0f};
+    auto hits     = 0;
+    for(std::size_t i = 0; i < count; ++i) {
+        CAPTURE(i);
+        auto [v0, v1, v2] = test_triangle(i);
+        auto hit          = intersect(probe, v0, v1, v2);
+        if(hit.t < expected.t) {
+            expected = ray_hit{static_cast<std::uint32_t>(i), hit.t, hit.u, hit.v};
+        }
+
+        CHECK(same_t(triangle_t[i], hit.t));
+        CHECK(is_set(triangle_hits, i) == (hit.t < miss));
+        CHECK(same_t(box_t[i], intersect(probe, boxes[i], 12.0f)));
+        CHECK(is_set(box_hits, i) == (box_t[i] < miss));
+
+        auto r = rays[i];
+        CHECK(same_t(ray_triangle_t[i], intersect(r, t0, t1, t2).t));
+        CHECK(is_set(ray_tri_hits, i) == (ray_triangle_t[i] < miss));
+        CHECK(same_t(ray_box_t[i], intersect(r, box)));
+        CHECK(is_set(ray_box_hits, i) == (ray_box_t[i] < miss));
+
+        hits += (hit.t < miss ? 1 : 0) + (ray_triangle_t[i] < miss ? 1 : 0);
+    }
+    CHECK(hits > 2);
+    CHECK(hits < static_cast<int>(count) * 2);
+
+    auto closest = closest_hit(probe, triangles);
+    REQUIRE(expected.t < miss);
+    CHECK(closest.triangle == expected.triangle);
+    CHECK(almost_equal(closest.t, expected.t, 0.0001f));
+    CHECK(almost_equal(closest.u, expected.u, 0.0001f));
+    CHECK(almost_equal(closest.v, expected.v, 0.0001f));
+    CHECK_FALSE(closest_hit(probe, triangles, expected.t * 0.999f).t < miss);
+    CHECK_FALSE(closest_hit(ray{{0.0f, 0.0f, -10.0f}, {0.0f, 0.0f, -1.0f}}, triangles).t < miss);
+}
+
+TEST_CASE("packet and scalar intersection agree", "[intersect]") {
+    // Ray origins sit on a half unit grid and triangle edges stay at least 0.05 off every point a ray crosses their
+    // plane, so no ray grazes an edge and both sides agree on what is hit. Box faces are on the unit grid, so many
+    // axis-parallel rays start exactly on a slab plane. Distances only need to agree to same_t's 0.0001, the triangle
+    // kernels may fuse multiply-adds.
+
+    auto triangles = triangle_soa{};
+    auto boxes     = aabb_soa{};
+    for(std::size_t i = 0; i < count; ++i) {
+        auto corner = vec3{static_cast<float>(i % 5) - 2.0f,
+                           static_cast<float>(i / 5 % 4) - 2.0f,
+                           static_cast<float>(i % 3) * 2.0f - 3.0f};
+        auto v0     = corner + vec3{0.25f, 0.25f, 0.0f};
+        triangles.push_back(v0, v0 + vec3{1.6f, 0.0f, 0.0f}, v0 + vec3{0.0f, 1.6f, 0.0f});
+        boxes.push_back(aabb{corner, corner + vec3{1.0f, 1.0f, 1.0f}});
+    }
+
+    auto directions = std::array{
+        vec3{0.0f, 0.0f, 1.0f},
+        vec3{0.25f, 0.0f, 1.0f},
+        vec3{0.0f, -0.25f, 1.0f},
+        vec3{-0.0f, 0.0f, -1.0f},
+        vec3{1.0f, 0.0f, 0.0f},
+        vec3{0.0f, -1.0f, -0.0f},
+    };
+    auto rays = ray_soa{};
+    for(auto z : {-5.0f, -3.0f}) {
+        for(auto y = -3.0f; y <= 3.0f; y += 0.5f) {
+            for(auto x = -3.0f; x <= 3.0f; x += 0.5f) {
+                for(const auto& direction : directions) {
+                    rays.push_back(ray{{x, y, z}, direction});
+                }
+            }
+        }
+    }
+
+    auto hits       = std::vector<std::uint64_t>((rays.size() + 63) / 64);
+    auto t          = std::vector<float>(rays.size());
+    auto scalar_hit = 0;
+
+    // One ray against every triangle and box
+    for(std::size_t r = 0; r < rays.size(); ++r) {
+        CAPTURE(r);
+        auto probe = rays[r];
+
+        intersect(probe, triangles, hits, t);
+        for(std::size_t i = 0; i < count; ++i) {
+            auto expected = intersect(probe, triangles.v0[i], triangles.v1[i], triangles.v2[i]).t;
+            scalar_hit += expected < miss ? 1 : 0;
+            CHECK(is_set(hits, i) == (expected < miss));
+            CHECK(same_t(t[i], expected));
+        }
+
+        intersect(probe, boxes, hits, t, 12.0f);
+        for(std::size_t i = 0; i < count; ++i) {
+            auto expected = intersect(probe, boxes[i], 12.0f);
+            scalar_hit += expected < miss ? 1 : 0;
+            CHECK(is_set(hits, i) == (expected < miss));
+            CHECK(same_t(t[i], expected));
+        }
+    }
+
+    // Every ray against one triangle and one box
+    for(std::size_t i = 0; i < count; ++i) {
+        CAPTURE(i);
+        auto v0 = triangles.v0[i];
+        auto v1 = triangles.v1[i];
+        auto v2 = triangles.v2[i];
+
+        intersect(rays, v0, v1, v2, hits, t);
+        for(std::size_t r = 0; r < rays.size(); ++r) {
+            auto expected = intersect(rays[r], v0, v1, v2).t;
+            CHECK(is_set(hits, r) == (expected < miss));
+            CHECK(same_t(t[r], expected));
+        }
+
+        intersect(rays, boxes[i], hits, t);
+        for(std::size_t r = 0; r < rays.size(); ++r) {
+            auto expected = intersect(rays[r], boxes[i]);
+            CHECK(is_set(hits, r) == (expected < miss));
+            CHECK(same_t(t[r], expected));
+        }
+    }
+
+    CHECK(scalar_hit > 100);
+}
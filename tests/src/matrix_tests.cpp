@@ -4,6 +4,7 @@
 
 #include <format>
 #include <iostream>
+#include <numbers>
 
 using namespace admat;
 
@@ -171,6 +172,44 @@ TEST_CASE("mat4 * vec4") {
     CHECK(actual == expected);
 }
 
+TEST_CASE("mat4 * vec4 column and row order") {
+    auto mat = mat4{
+        {1, 2, 3, 4},
+        {5, 6, 7, 8},
+        {9, 10, 11, 12},
+        {13, 14, 15, 16},
+    };
+    auto vec = vec4{1.0f, 2.0f, 3.0f, 4.0f};
+
+    CHECK(mat * vec == vec4{30.0f, 70.0f, 110.0f, 150.0f});
+    CHECK(vec * mat == vec4{90.0f, 100.0f, 110.0f, 120.0f});
+
+    auto point = translation(1.0f, 2.0f, 3.0f) * vec4{0.0f, 0.0f, 0.0f, 1.0f};
+    CHECK(point == vec4{1.0f, 2.0f, 3.0f, 1.0f});
+}
+
+TEST_CASE("mat4 multiplication constant evaluation") {
+    constexpr auto m1 = mat4{
+        {1, 2, 3, 4},
+        {5, 6, 7, 8},
+        {9, 10, 11, 12},
+        {13, 14, 15, 16},
+    };
+    constexpr auto m2 = mat4{
+        {5, 6, 7, 8},
+        {9, 10, 11, 12},
+        {13, 14, 15, 16},
+        {1, 2, 3, 4},
+    };
+
+    constexpr auto product = m1 * m2;
+    static_assert(almost_equal(product.x.z, 460.0f, 0.00001f)); // row 3, column 1
+
+    auto rt_m1 = m1;
+    CHECK(rt_m1 * m2 == product);
+    CHECK(rt_m1 * vec4{1.0f, 2.0f, 3.0f, 4.0f} == m1 * vec4{1.0f, 2.0f, 3.0f, 4.0f});
+}
+
 TEST_CASE("Matrix scalar multiplication") {
     auto mat = mat4{
         {1, 2, 3, 4},
@@ -227,6 +266,47 @@ TEST_CASE("mat4 inverse") {
     CHECK(actual == expected);
 }
 
+TEST_CASE("mat4 inverse and determinant") {
+    auto mat = mat4{
+        {1, 2, 2, 1},
+        {2, 3, 4, 1},
+        {2, 2, 1, 3},
+        {2, 4, 3, 2},
+    };
+
+    auto expected = mat4{
+        {-13, 4, 1, 3},
+        {-2, -1, -1, 3},
+        {6, 0, 0, -3},
+        {8, -2, 1, -3},
+    };
+    expected = (1.0f / 3.0f) * expected;
+
+    auto [inv, det] = inverse_and_determinant(mat);
+    CHECK(inv == expected);
+    CHECK(almost_equal(det, -3.0f, 0.00001f));
+    CHECK(almost_equal(det, determinant(mat), 0.00001f));
+
+    auto ident = mat * inv;
+    for(size_t i = 0; i < 4; ++i) {
+        for(size_t j = 0; j < 4; ++j) {
+            CHECK(almost_equal(ident[i, j], i == j ? 1.0f : 0.0f, 0.00001f));
+        }
+    }
+}
+
+TEST_CASE("mat4 singular inverse") {
+    auto mat = mat4{
+        {1, 2, 3, 4},
+        {5, 6, 7, 8},
+        {9, 10, 11, 12},
+        {13, 14, 15, 16},
+    };
+
+    auto result = inverse_and_determinant(mat);
+    CHECK(almost_equal(result.determinant, 0.0f, 0.00001f));
+}
+
 TEST_CASE("mat4 transpose") {
     auto mat = mat4{
         {1, 2, 3, 4},
@@ -290,6 +370,33 @@ TEST_CASE("rotation") {
     }
 }
 
+TEST_CASE("Euler and yaw pitch roll rotations") {
+    auto x_axis = vec3{1.0f, 0.0f, 0.0f};
+    auto y_axis = vec3{0.0f, 1.0f, 0.0f};
+    auto z_axis = vec3{0.0f, 0.0f, 1.0f};
+
+    auto euler    = euler_rotation(vec3{0.3f, -1.1f, 2.4f});
+    auto composed = rotation(z_axis, 2.4f) * rotation(y_axis, -1.1f) * rotation(x_axis, 0.3f);
+    for(size_t i = 0; i < 4; ++i) {
+        for(size_t j = 0; j < 4; ++j) {
+            CHECK(almost_equal(euler[i, j], composed[i, j], 0.000001f));
+        }
+    }
+
+    auto camera = yaw_pitch_roll_rotation(0.8f, -0.4f, 1.9f);
+    composed    = rotation(y_axis, 0.8f) * rotation(x_axis, -0.4f) * rotation(z_axis, 1.9f);
+    for(size_t i = 0; i < 4; ++i) {
+        for(size_t j = 0; j < 4; ++j) {
+            CHECK(almost_equal(camera[i, j], composed[i, j], 0.000001f));
+        }
+    }
+
+    // Yaw turns the -z forward direction towards -x
+    auto quarter = yaw_pitch_roll_rotation(std::numbers::pi_v<float> / 2.0f, 0.0f, 0.0f);
+    auto forward = quarter * vec4{0.0f, 0.0f, -1.0f, 0.0f};
+    CHECK(almost_equal(forward.w, -1.0f, 0.000001f));
+}
+
 TEST_CASE("Perspective FOV") {
     auto expected = mat4{
         {2.09928f, 0.00000f, 0.00000f, 0.000f},
@@ -312,8 +419,8 @@ TEST_CASE("Orthographic") {
     auto expected = mat4{
         {0.02f, 0.00f, 0.00000000f, 0.0f},
         {0.00f, 0.01f, 0.00000000f, 0.0f},
-        {0.00f, 0.00f, -0.00100150f, 0.0f},
-        {0.00f, 0.00f, -0.00150225f, 1.0f},
+        {0.00f, 0.00f, -0.00100150f, -0.00150225f},
+        {0.00f, 0.00f, 0.00000000f, 1.0f},
     };
 
     auto actual = orthographic(100.0f, 200.0f, 1.5f, 1000.0f);
@@ -324,6 +431,20 @@ TEST_CASE("Orthographic") {
     }
 }
 
+TEST_CASE("Orthographic projection") {
+    auto projection = orthographic(100.0f, 200.0f, 1.5f, 1000.0f);
+
+    auto near_point = projection * vec4{50.0f, -100.0f, -1.5f, 1.0f};
+    CHECK(almost_equal(near_point[0] / near_point[3], 1.0f, 0.0001f));
+    CHECK(almost_equal(near_point[1] / near_point[3], -1.0f, 0.0001f));
+    CHECK(almost_equal(near_point[2] / near_point[3], 0.0f, 0.0001f));
+
+    auto far_point = projection * vec4{-25.0f, 50.0f, -1000.0f, 1.0f};
+    CHECK(almost_equal(far_point[0] / far_point[3], -0.5f, 0.0001f));
+    CHECK(almost_equal(far_point[1] / far_point[3], 0.5f, 0.0001f));
+    CHECK(almost_equal(far_point[2] / far_point[3], 1.0f, 0.0001f));
+}
+
 TEST_CASE("Look at") {
     auto expected = mat4{
         {-1, 0, 0, 0},
@@ -339,4 +460,38 @@ TEST_CASE("Look at") {
             CHECK(almost_equal(actual[i, j], expected[i, j], 0.00001f));
         }
     }
-}
\ No newline at end of file
+}
+
+TEST_CASE("Rigid inverse") {
+    auto mat = translation(3.0f, -1.0f, 2.5f) * rotation({0.3f, 1.0f, -0.5f}, 0.7f) * rotation({1, 0, 0}, -1.9f);
+    REQUIRE(is_rigid(mat));
+    CHECK_FALSE(is_rigid(mat * scaling(2.0f, 1.0f, 1.0f)));
+
+    auto expected = inverse(mat);
+    auto actual   = rigid_inverse(mat);
+    for(size_t i = 0; i < 4; ++i) {
+        for(size_t j = 0; j < 4; ++j) {
+            CAPTURE(i, j);
+            CHECK(almost_equal(actual[i, j], expected[i, j], 0.0001f));
+        }
+    }
+
+    // Scalar path through constant evaluation
+    constexpr auto translated = rigid_inverse(translation(1.0f, 2.0f, 3.0f));
+    static_assert(almost_equal(translated.z.w, -1.0f, 0.000001f) && almost_equal(translated.z.y, -3.0f, 0.000001f));
+}
+
+TEST_CASE("Look at inverse") {
+    auto position = vec3{4, -2, 7};
+    auto target   = vec3{-1, 3, 0.5f};
+    auto up       = vec3{0, 1, 0};
+
+    auto expected = inverse(look_at(position, target, up));
+    auto actual   = look_at_inverse(position, target, up);
+    for(size_t i = 0; i < 4; ++i) {
+        for(size_t j = 0; j < 4; ++j) {
+            CAPTURE(i, j);
+            CHECK(almost_equal(actual[i, j], expected[i, j], 0.0001f));
+        }
+    }
+}
@@ -0,0 +1,53 @@
+#include "almost_equal.hpp"
+#include <snitch/snitch.hpp>
+
+#include <cstddef>
+#include <vector>
+
+// Only the module, so a name admat.cppm leaves out fails to compile here. utils.hpp includes the headers, so only
+// almost_equal.hpp comes from the tests.
+import admat;
+
+using namespace admat;
+
+TEST_CASE("Module exports the vector and matrix types", "[module]") {
+    auto axis  = normalize(cross(vec3{1.0f, 0.0f, 0.0f}, vec3{0.0f, 1.0f, 0.0f}));
+    auto mat   = translation(1.0f, 2.0f, 3.0f) * rotation(axis, 0.5f);
+    auto value = vec4{1.0f, 2.0f, -1.0f, 0.5f};
+    auto back  = inverse(mat) * (mat * value);
+
+    CHECK(almost_equal(back.w, value.w, 0.00001f));
+    CHECK(almost_equal(back.x, value.x, 0.00001f));
+    CHECK(almost_equal(back.z, value.z, 0.00001f));
+    CHECK(almost_equal(dot(axis, vec3{0.0f, 0.0f, 2.0f}), 2.0f));
+
+    auto turn = quat::from_axis_angle(axis, 0.5f) * vec3{1.0f, 0.0f, 0.0f};
+    CHECK(almost_equal(turn.x, fast::cos(0.5f), 0.000001f));
+    CHECK(almost_equal(turn.y, fast::sin(0.5f), 0.000001f));
+    CHECK(almost_equal(to_float(to_half(0.5f)), 0.5f));
+}
+
+TEST_CASE("Module exports the span functions", "[module]") {
+    constexpr std::size_t count = 37;
+
+    auto mat    = translation(-1.0f, 0.5f, 4.0f);
+    auto points = std::vector<vec3>{};
+    for(std::size_t i = 0; i < count; ++i) {
+        points.push_back(vec3{static_cast<float>(i), 1.0f, -2.0f});
+    }
+
+    auto expected = std::vector<vec3>(count);
+    auto routed   = std::vector<vec3>(count);
+    auto scaled   = std::vector<vec3>(count);
+    transform_points(mat, points, expected);
+    dispatch::transform_points(mat, points, routed);
+    lazy(scaled) = lazy(points) * 2.0f + lazy(expected);
+
+    auto same = true;
+    for(std::size_t i = 0; i < count; ++i) {
+        same = same && almost_equal(routed[i].x, expected[i].x) && almost_equal(routed[i].z, expected[i].z) &&
+               almost_equal(scaled[i].x, points[i].x * 3.0f - 1.0f);
+    }
+    CHECK(same);
+    CHECK(dispatch::kernels().target <= dispatch::detect_isa());
+}
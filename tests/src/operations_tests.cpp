@@ -1,62 +1,123 @@
-// #include <adizzle/float.hpp>
-// #include <admat/matrix.hpp>
-// #include <admat/operations.hpp>
-// #include <admat/vector.hpp>
-// #include <snitch/snitch.hpp>
-
-// #include <cmath>
-
-// using namespace admat;
-
-// TEST_CASE("Multiply vector by matrix") {
-//     auto vec = vec3{5.0f, 6.0f, 7.0f};
-
-//     // clang-format off
-//     auto mat = mat3::from_row_major({
-//         1, 2, 3,
-//         4, 5, 6,
-//         7, 8, 9,
-//     });
-//     // clang-format on
-
-//     auto expected = vec3{30.0f, 90.0f, 168.0f};
-
-//     auto result = vec * mat;
-
-//     CHECK(result == expected);
-// }
-
-// TEST_CASE("Multiply vector by non-square matrix") {
-//     auto vec = vec3{5.0f, 6.0f, 7.0f};
-
-//     // clang-format off
-//     auto mat = column_major_matrix<float, 2, 3>::from_row_major({
-//         1, 2, 3,
-//         4, 5, 6,
-//     });
-//     // clang-format on
-
-//     auto expected = vec2{30.0f, 90.0f};
-
-//     auto result = vec * mat;
-
-//     CHECK(result == expected);
-// }
-
-// TEST_CASE("Multiply matrix by vector") {
-//     auto vec = vec3{5.0f, 6.0f, 7.0f};
-
-//     // clang-format off
-//     auto mat = mat3::from_row_major({
-//         1, 2, 3,
-//         4, 5, 6,
-//         7, 8, 9,
-//     });
-//     // clang-format on
-
-//     auto expected = vec3{30.0f, 90.0f, 168.0f};
-
-//     auto result = mat * vec;
-
-//     CHECK(result == expected);
-// }
\ No newline at end of file
+#include "utils.hpp"
+#include <admat/batch.hpp>
+#include <admat/mat.hpp>
+#include <admat/vec.hpp>
+#include <snitch/snitch.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+using namespace admat;
+
+static_assert(determinant(mat<std::int32_t, 2, 2>{{1, 2}, {3, 4}}) == -2);
+static_assert(dot(ivec3{1, 2, 3}, ivec3{4, 5, 6}) == 32);
+static_assert(sizeof(mat<float, 2, 3>) == sizeof(float) * 6);
+
+TEST_CASE("Multiply vector by matrix", "[operations]") {
+    auto vec = vec3{5.0f, 6.0f, 7.0f};
+
+    // clang-format off
+    auto mat = mat3::from_row_major({
+        1.0f, 2.0f, 3.0f,
+        4.0f, 5.0f, 6.0f,
+        7.0f, 8.0f, 9.0f,
+    });
+    // clang-format on
+
+    CHECK(close(vec * mat, vec3{78.0f, 96.0f, 114.0f}, 0.0001f));
+    CHECK(close(mat * vec, vec3{38.0f, 92.0f, 146.0f}, 0.0001f));
+    CHECK(close(transpose(mat) * vec, vec * mat, 0.0001f));
+    CHECK(almost_equal(mat[1, 2], 6.0f, 0.0001f));
+}
+
+TEST_CASE("Multiply non-square matrices", "[operations]") {
+    // 2 rows and 3 columns, a 2D affine transform
+    // clang-format off
+    auto affine_2d = mat<float, 2, 3>::from_row_major({
+        1.0f, 2.0f, 3.0f,
+        4.0f, 5.0f, 6.0f,
+    });
+    // clang-format on
+
+    CHECK(close(affine_2d * vec3{5.0f, 6.0f, 7.0f}, vec2{38.0f, 92.0f}, 0.0001f));
+    CHECK(close(vec2{5.0f, 6.0f} * affine_2d, vec3{29.0f, 40.0f, 51.0f}, 0.0001f));
+
+    auto transposed = transpose(affine_2d);
+    CHECK(almost_equal(transposed[2, 1], 6.0f, 0.0001f));
+    CHECK(close(affine_2d * transposed, mat2{{14.0f, 32.0f}, {32.0f, 77.0f}}, 0.0001f));
+
+    auto square = transposed * affine_2d;
+    CHECK(close(square.row(0), vec3{17.0f, 22.0f, 27.0f}, 0.0001f));
+    CHECK(close(square.row(2), vec3{27.0f, 36.0f, 45.0f}, 0.0001f));
+}
+
+TEST_CASE("Determinant and inverse of every size", "[operations]") {
+    auto small = mat2{{1.0f, 2.0f}, {3.0f, 4.0f}};
+    CHECK(almost_equal(determinant(small), -2.0f, 0.0001f));
+    CHECK(close(inverse(small), mat2{{-2.0f, 1.0f}, {1.5f, -0.5f}}, 0.0001f));
+
+    auto medium = mat3{{2.0f, 0.0f, 1.0f}, {1.0f, 3.0f, 2.0f}, {1.0f, 1.0f, 2.0f}};
+    CHECK(almost_equal(determinant(medium), 6.0f, 0.0001f));
+    CHECK(close(medium * inverse(medium), mat3::identity(), 0.0001f));
+
+    // Double matches the float SIMD path, and inverts more precisely
+    auto single = test_matrix();
+    auto widen  = [](const vec4& column) {
+        return dvec4{static_cast<double>(column.w),
+                     static_cast<double>(column.x),
+                     static_cast<double>(column.y),
+                     static_cast<double>(column.z)};
+    };
+    auto wide = dmat4::from_cols(widen(single.w), widen(single.x), widen(single.y), widen(single.z));
+    CHECK(almost_equal(static_cast<float>(determinant(wide)), determinant(single), 0.0001f));
+    CHECK(close(wide * inverse(wide), dmat4::identity(), 1e-12));
+    CHECK(close(inverse(single) * single, mat4::identity(), 0.0001f));
+}
+
+TEST_CASE("Integer and double vectors", "[operations]") {
+    auto ints = ivec3{1, 2, 3} + ivec3{4, 5, 6} * 2;
+    CHECK(ints.x == 9);
+    CHECK(ints.y == 12);
+    CHECK(ints.z == 15);
+    CHECK((10 - ints).z == -5);
+    CHECK(abs(ivec2{-3, 4}).x == 3);
+
+    auto doubles = cross(dvec3{1.0, 0.0, 0.0}, dvec3{0.0, 1.0, 0.0});
+    CHECK(close(doubles, dvec3{0.0, 0.0, 1.0}, 1e-15));
+    CHECK(almost_equal(distance(dvec2{0.0, 0.0}, dvec2{3.0, 4.0}), 5.0, 1e-15));
+
+    // Scalar on the left of - and /
+    auto vec = vec4{1.0f, 2.0f, 4.0f, 8.0f};
+    CHECK(close(1.0f - vec, vec4{0.0f, -1.0f, -3.0f, -7.0f}, 0.0001f));
+    CHECK(close(8.0f / vec, vec4{8.0f, 4.0f, 2.0f, 1.0f}, 0.0001f));
+    CHECK(almost_equal(vec[0], vec.w, 0.0001f));
+    CHECK(almost_equal(vec[3], vec.z, 0.0001f));
+}
+
+TEST_CASE("Normal matrix", "[operations]") {
+    auto mat     = test_matrix();
+    auto normals = normal_matrix(mat);
+    CHECK(close(normals, transpose(inverse(linear_part(mat))), 0.0001f));
+
+    // A normal stays perpendicular to the tangents of its surface
+    auto normal   = normalize(vec3{1.0f, 2.0f, -1.0f});
+    auto tangent  = normalize(vec3{1.0f, 0.0f, 1.0f});
+    auto tangent2 = cross(normal, tangent);
+    CHECK(almost_equal(dot(normals * normal, linear_part(mat) * tangent), 0.0f, 0.0001f));
+    CHECK(almost_equal(dot(normals * normal, linear_part(mat) * tangent2), 0.0f, 0.0001f));
+
+    auto in = std::vector<vec3>{};
+    for(std::size_t i = 0; i < 37; ++i) {
+        auto f = static_cast<float>(i);
+        in.push_back(vec3{f * 0.5f - 3.0f, 2.0f - f * 0.25f, f * 0.1f + 1.0f});
+    }
+    auto out = std::vector<vec3>(in.size());
+    transform(normals, in, out);
+
+    auto same = true;
+    for(std::size_t i = 0; i < in.size(); ++i) {
+        same = same && close(out[i], normals * in[i], 0.0001f);
+    }
+    CHECK(same);
+}
@@ -0,0 +1,311 @@
+#include "utils.hpp"
+#include <admat/batch.hpp>
+#include <admat/bounds.hpp>
+#include <admat/frustum.hpp>
+#include <admat/parallel.hpp>
+#include <admat/soa.hpp>
+#include <snitch/snitch.hpp>
+
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+using namespace admat;
+
+namespace {
+
+// Runs pool over count elements and checks every element was handed out exactly once
+auto covers_once(thread_pool& pool, std::size_t count, std::size_t grain) -> bool {
+    auto seen = std::vector<std::atomic<int>>(count);
+    pool(count, grain, [&](std::size_t begin, std::size_t end) {
+        for(auto i = begin; i < end; ++i) {
+            seen[i].fetch_add(1, std::memory_order_relaxed);
+        }
+    });
+
+    for(const auto& hits : seen) {
+        if(hits.load() != 1) {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+TEST_CASE("thread pool runs every chunk once", "[parallel]") {
+    auto pool = thread_pool(3);
+    CHECK(covers_once(pool, 0, 16));
+    CHECK(covers_once(pool, 1, 16));
+    CHECK(covers_once(pool, 16, 16));
+    CHECK(covers_once(pool, 17, 16));
+    CHECK(covers_once(pool, 1000, 1));
+    CHECK(covers_once(pool, 100003, 64));
+
+#if !defined(ADMAT_NO_THREADS)
+    CHECK(pool.concurrency() == 4);
+
+    // Ranges are whole chunks except the last
+    auto ranges = std::atomic<int>{0};
+    auto short_ = std::atomic<int>{0};
+    pool(1000, 64, [&](std::size_t begin, std::size_t end) {
+        ranges.fetch_add(1);
+        if(end - begin != 64 || begin % 64 != 0) {
+            short_.fetch_add(1);
+        }
+    });
+    CHECK(ranges.load() == 16);
+    CHECK(short_.load() == 1);
+#endif
+
+    auto serial = thread_pool(0);
+    CHECK(serial.concurrency() == 1);
+    CHECK(covers_once(serial, 5000, 16));
+}
+
+TEST_CASE("thread pool nested and concurrent jobs", "[parallel]") {
+    auto pool = thread_pool(2);
+
+    // A job started from inside a job runs on that thread
+    auto total = std::atomic<std::size_t>{0};
+    pool(8, 1, [&](std::size_t begin, std::size_t end) {
+        for(auto outer = begin; outer < end; ++outer) {
+            pool(100, 10, [&](std::size_t first, std::size_t last) { total.fetch_add(last - first); });
+        }
+    });
+    CHECK(total.load() == 800);
+
+    // Jobs submitted from other threads queue up behind each other
+    auto results = std::vector<int>(4);
+    {
+        auto callers = std::vector<std::jthread>{};
+        for(std::size_t caller = 0; caller < results.size(); ++caller) {
+            callers.emplace_back([&, caller] {
+                auto all = true;
+                for(std::size_t round = 0; round < 20; ++round) {
+                    all = all && covers_once(pool, 2000 + caller, 32);
+                }
+                results[caller] = all ? 1 : 0;
+            });
+        }
+    }
+    for(auto result : results) {
+        CHECK(result == 1);
+    }
+}
+
+TEST_CASE("parallel batch kernels", "[parallel]") {
+    auto pool = thread_pool(3);
+    auto mat  = test_matrix();
+
+    constexpr std::size_t count = 10007;
+
+    auto points  = std::vector<vec3>{};
+    auto vectors = std::vector<vec4>{};
+    for(std::size_t i = 0; i < count; ++i) {
+        auto f = static_cast<float>(i) * 0.01f;
+        points.push_back(vec3{f - 30.0f, 10.0f - f, f * 0.5f});
+        vectors.push_back(vec4{f, -f, 1.0f, 1.0f});
+    }
+
+    auto serial_points   = std::vector<vec3>(count);
+    auto parallel_points = std::vector<vec3>(count);
+    auto serial_dirs     = std::vector<vec3>(count);
+    auto parallel_dirs   = std::vector<vec3>(count);
+    auto serial_vecs     = std::vector<vec4>(count);
+    auto parallel_vecs   = std::vector<vec4>(count);
+    transform_points(mat, points, serial_points);
+    transform_points(pool, mat, points, parallel_points, 256);
+    transform_directions(mat, points, serial_dirs);
+    transform_directions(pool, mat, points, parallel_dirs, 256);
+    transform(mat, vectors, serial_vecs);
+    transform(pool, mat, vectors, parallel_vecs, 256);
+
+    auto same = true;
+    for(std::size_t i = 0; i < count; ++i) {
+        same = same && close(serial_points[i], parallel_points[i]) && close(serial_dirs[i], parallel_dirs[i]) &&
+               close(serial_vecs[i], parallel_vecs[i]);
+    }
+    CHECK(same);
+
+    // In place through the serial executor
+    transform_points(serial_executor{}, mat, points, points, 256);
+    CHECK(close(points[count - 1], serial_points[count - 1]));
+}
+
+TEST_CASE("parallel soa kernels", "[parallel]") {
+    auto pool = thread_pool(3);
+
+    // A grain that is not a multiple of any SIMD width moves elements between wide blocks and scalar tails, where
+    // multiply adds may or may not fuse, so results are compared with a tolerance
+    constexpr std::size_t count = 10007;
+    constexpr std::size_t grain = 250;
+
+    auto lhs3 = vec3_soa{};
+    auto rhs3 = vec3_soa{};
+    auto lhs4 = vec4_soa{};
+    auto rhs4 = vec4_soa{};
+    for(std::size_t i = 0; i < count; ++i) {
+        auto f = static_cast<float>(i) * 0.01f;
+        lhs3.push_back(vec3{std::sin(f) * 4.0f, 1.5f - f * 0.1f, std::cos(f) + 0.25f});
+        rhs3.push_back(normalize(vec3{std::cos(f * 0.7f), 0.5f, std::sin(f) - 0.2f}));
+        lhs4.push_back(vec4{f * 0.2f, std::sin(f), -2.0f, 0.75f});
+        rhs4.push_back(vec4{0.5f, std::cos(f), f * 0.05f, -1.0f});
+    }
+
+    auto same3 = [](const vec3_soa& lhs, const vec3_soa& rhs) {
+        auto same = lhs.size() == rhs.size();
+        for(std::size_t i = 0; same && i < lhs.size(); ++i) {
+            same = close(lhs[i], rhs[i]);
+        }
+        return same;
+    };
+    auto same4 = [](const vec4_soa& lhs, const vec4_soa& rhs) {
+        auto same = lhs.size() == rhs.size();
+        for(std::size_t i = 0; same && i < lhs.size(); ++i) {
+            same = close(lhs[i], rhs[i]);
+        }
+        return same;
+    };
+    auto same_floats = [](const std::vector<float>& lhs, const std::vector<float>& rhs) {
+        auto same = true;
+        for(std::size_t i = 0; same && i < lhs.size(); ++i) {
+            same = almost_equal(lhs[i], rhs[i], 0.0001f);
+        }
+        return same;
+    };
+
+    auto serial_floats = std::vector<float>(count);
+    auto pooled_floats = std::vector<float>(count);
+    dot(lhs3, rhs3, serial_floats);
+    dot(pool, lhs3, rhs3, pooled_floats, grain);
+    CHECK(same_floats(serial_floats, pooled_floats));
+    dot(lhs4, rhs4, serial_floats);
+    dot(pool, lhs4, rhs4, pooled_floats, grain);
+    CHECK(same_floats(serial_floats, pooled_floats));
+    distance(lhs3, rhs3, serial_floats);
+    distance(pool, lhs3, rhs3, pooled_floats, grain);
+    CHECK(same_floats(serial_floats, pooled_floats));
+    distance(lhs4, rhs4, serial_floats);
+    distance(pool, lhs4, rhs4, pooled_floats, grain);
+    CHECK(same_floats(serial_floats, pooled_floats));
+
+    // Pooled outputs start empty, so they also check the resize before the chunks run
+    auto serial3 = vec3_soa{};
+    auto pooled3 = vec3_soa{};
+    cross(lhs3, rhs3, serial3);
+    cross(pool, lhs3, rhs3, pooled3, grain);
+    CHECK(same3(serial3, pooled3));
+    normalize(lhs3, serial3);
+    normalize(pool, lhs3, pooled3 = vec3_soa{}, grain);
+    CHECK(same3(serial3, pooled3));
+    lerp(lhs3, rhs3, 0.3f, serial3);
+    lerp(pool, lhs3, rhs3, 0.3f, pooled3 = vec3_soa{}, grain);
+    CHECK(same3(serial3, pooled3));
+    clamp(lhs3, -1.0f, 2.0f, serial3);
+    clamp(pool, lhs3, -1.0f, 2.0f, pooled3 = vec3_soa{}, grain);
+    CHECK(same3(serial3, pooled3));
+    reflect(lhs3, rhs3, serial3);
+    reflect(pool, lhs3, rhs3, pooled3 = vec3_soa{}, grain);
+    CHECK(same3(serial3, pooled3));
+    refract(rhs3, rhs3, 0.8f, serial3);
+    refract(pool, rhs3, rhs3, 0.8f, pooled3 = vec3_soa{}, grain);
+    CHECK(same3(serial3, pooled3));
+
+    auto serial4 = vec4_soa{};
+    auto pooled4 = vec4_soa{};
+    normalize(lhs4, serial4);
+    normalize(pool, lhs4, pooled4, grain);
+    CHECK(same4(serial4, pooled4));
+    lerp(lhs4, rhs4, 0.6f, serial4);
+    lerp(pool, lhs4, rhs4, 0.6f, pooled4 = vec4_soa{}, grain);
+    CHECK(same4(serial4, pooled4));
+    clamp(lhs4, -0.5f, 0.5f, serial4);
+    clamp(pool, lhs4, -0.5f, 0.5f, pooled4 = vec4_soa{}, grain);
+    CHECK(same4(serial4, pooled4));
+
+    // In place through the serial executor
+    auto in_place = lhs3;
+    normalize(serial_executor{}, in_place, in_place, grain);
+    normalize(lhs3, serial3);
+    CHECK(same3(in_place, serial3));
+}
+
+TEST_CASE("parallel matrix arrays", "[parallel]") {
+    auto pool = thread_pool(3);
+    auto view = perspective(1.2f, 1.5f, 0.1f, 100.0f) * test_matrix();
+
+    constexpr std::size_t count = 3001;
+
+    auto parents = std::vector<mat4>{};
+    auto locals  = std::vector<mat4>{};
+    auto boxes   = aabb_soa{};
+    for(std::size_t i = 0; i < count; ++i) {
+        auto f = static_cast<float>(i) * 0.01f;
+        parents.push_back(translation(f, -f, 2.0f) * rotation(vec3{0.0f, 1.0f, 0.0f}, f));
+        locals.push_back(rotation(vec3{1.0f, 0.5f, 0.0f}, -f) * scaling(1.0f + f, 1.0f, 0.5f));
+        boxes.push_back(aabb::from_center_extent({f, 1.0f, -f}, {0.5f, 1.0f + f, 0.25f}));
+    }
+
+    auto world        = std::vector<mat4>(count);
+    auto pooled_world = std::vector<mat4>(count);
+    auto clip         = std::vector<mat4>(count);
+    auto pooled_clip  = std::vector<mat4>(count);
+    multiply(parents, locals, world);
+    multiply(pool, parents, locals, pooled_world, 100);
+    multiply(view, world, clip);
+    multiply(pool, view, pooled_world, pooled_clip, 100);
+
+    auto same = true;
+    for(std::size_t i = 0; i < count; ++i) {
+        auto expected = parents[i] * locals[i];
+        same          = same && close(world[i], expected) && close(pooled_world[i], expected) &&
+               close(clip[i], view * expected) && close(pooled_clip[i], clip[i]);
+    }
+    CHECK(same);
+
+    auto serial_boxes = aabb_soa{};
+    auto pooled_boxes = aabb_soa{};
+    transform(world, boxes, serial_boxes);
+    transform(pool, world, boxes, pooled_boxes, 100);
+
+    auto same_boxes = pooled_boxes.size() == count;
+    for(std::size_t i = 0; same_boxes && i < count; ++i) {
+        same_boxes = close(serial_boxes[i].min, pooled_boxes[i].min) && close(serial_boxes[i].max, pooled_boxes[i].max);
+    }
+    CHECK(same_boxes);
+}
+
+TEST_CASE("parallel culling", "[parallel]") {
+    auto pool = thread_pool(3);
+    auto view = frustum::from_mat4(perspective(1.5707964f, 1.0f, 1.0f, 100.0f) *
+                                   look_at({0.0f, 0.0f, 5.0f}, {0.0f, 0.0f, 0.0f}, {0.0f, 1.0f, 0.0f}));
+
+    // Not a multiple of 64, and a grain that is not either
+    constexpr std::size_t count = 5001;
+
+    auto spheres = sphere_soa{};
+    auto boxes   = aabb_soa{};
+    for(std::size_t i = 0; i < count; ++i) {
+        auto f      = static_cast<float>(i);
+        auto center = vec3{(f - 2500.0f) * 0.05f + 0.37f, std::sin(f) * 20.0f + 0.21f, 5.13f - f * 0.03f};
+        auto extent = 0.5f + static_cast<float>(i % 5);
+        spheres.push_back(sphere{center, extent});
+        boxes.push_back(aabb::from_center_extent(center, {extent, extent, extent}));
+    }
+
+    auto words           = (count + 63) / 64;
+    auto serial_spheres  = std::vector<std::uint64_t>(words, ~std::uint64_t{0});
+    auto pooled_spheres  = std::vector<std::uint64_t>(words, ~std::uint64_t{0});
+    auto serial_boxes    = std::vector<std::uint64_t>(words, ~std::uint64_t{0});
+    auto pooled_boxes    = std::vector<std::uint64_t>(words, ~std::uint64_t{0});
+    cull(view, spheres, serial_spheres);
+    cull(pool, view, spheres, pooled_spheres, 100);
+    cull(view, boxes, serial_boxes);
+    cull(pool, view, boxes, pooled_boxes, 100);
+
+    CHECK(serial_spheres == pooled_spheres);
+    CHECK(serial_boxes == pooled_boxes);
+    CHECK(serial_spheres != std::vector<std::uint64_t>(words, 0));
+}
@@ -0,0 +1,116 @@
+#include "utils.hpp"
+#include <admat/quat.hpp>
+#include <snitch/snitch.hpp>
+
+#include <numbers>
+#include <vector>
+
+using namespace admat;
+
+namespace {
+
+auto close(const quat& lhs, const quat& rhs) -> bool {
+    return almost_equal(lhs.w, rhs.w, 0.0001f) && almost_equal(lhs.x, rhs.x, 0.0001f) &&
+           almost_equal(lhs.y, rhs.y, 0.0001f) && almost_equal(lhs.z, rhs.z, 0.0001f);
+}
+
+// q and -q are the same rotation
+auto same_rotation(const quat& lhs, const quat& rhs) -> bool {
+    return close(lhs, rhs) || close(lhs, -rhs);
+}
+
+auto test_quats(float offset) -> std::vector<quat> {
+    auto quats = std::vector<quat>{};
+    for(std::size_t i = 0; i < 13; ++i) {
+        auto f = static_cast<float>(i) + offset;
+        quats.push_back(quat::from_axis_angle(vec3{f * 0.3f - 1.0f, 1.0f, f * 0.1f}, f * 0.45f - 2.5f));
+    }
+    return quats;
+}
+
+} // namespace
+
+TEST_CASE("quat multiplication", "[quat]") {
+    constexpr auto lhs = quat{1.0f, 2.0f, 3.0f, 4.0f};
+    constexpr auto rhs = quat{-2.0f, 0.5f, 1.0f, -3.0f};
+
+    // Scalar path through constant evaluation, SIMD path at runtime
+    constexpr auto expected = lhs * rhs;
+    static_assert(almost_equal(expected.w, 6.0f, 0.000001f) && almost_equal(expected.x, -16.5f, 0.000001f));
+    static_assert(almost_equal(expected.y, 3.0f, 0.000001f) && almost_equal(expected.z, -10.5f, 0.000001f));
+
+    auto runtime_lhs = lhs;
+    auto result      = runtime_lhs * rhs;
+    CHECK(close(result, expected));
+
+    CHECK(close(quat::identity() * lhs, lhs));
+    CHECK(close(lhs * inverse(lhs), quat::identity()));
+}
+
+TEST_CASE("quat rotation matches rotation matrix", "[quat]") {
+    auto axis  = vec3{0.3f, 1.0f, -0.5f};
+    auto angle = 0.7f;
+
+    auto rot    = quat::from_axis_angle(axis, angle);
+    auto mat    = rotation(axis, angle);
+    auto vec    = vec3{1.5f, -2.0f, 0.25f};
+    auto by_mat = mat * vec4{vec.x, vec.y, vec.z, 0.0f};
+
+    CHECK(close(rotation(rot), mat));
+    CHECK(close(rot * vec, vec3{by_mat.w, by_mat.x, by_mat.y}));
+
+    // Composition applies the right hand rotation first, like matrices
+    auto other = quat::from_axis_angle({1.0f, 0.0f, 0.0f}, 1.2f);
+    CHECK(close(rotation(other * rot), rotation({1.0f, 0.0f, 0.0f}, 1.2f) * mat));
+}
+
+TEST_CASE("quat matrix and axis angle conversion", "[quat]") {
+    // Angles near pi exercise every branch of from_mat4
+    for(const auto& rot : test_quats(0.0f)) {
+        CHECK(same_rotation(quat::from_mat4(rotation(rot)), rot));
+
+        auto [axis, radians] = to_axis_angle(rot);
+        CHECK(same_rotation(quat::from_axis_angle(axis, radians), rot));
+    }
+
+    for(auto axis : {vec3{1.0f, 0.0f, 0.0f}, vec3{0.0f, 1.0f, 0.0f}, vec3{0.0f, 0.0f, 1.0f}}) {
+        auto rot = quat::from_axis_angle(axis, std::numbers::pi_v<float>);
+        CHECK(same_rotation(quat::from_mat4(rotation(rot)), rot));
+    }
+
+    auto identity = to_axis_angle(quat::identity());
+    CHECK(almost_equal(identity.radians, 0.0f, 0.0001f));
+}
+
+TEST_CASE("quat slerp and nlerp", "[quat]") {
+    auto from = quat::from_axis_angle({0.0f, 0.0f, 1.0f}, 0.0f);
+    auto to   = quat::from_axis_angle({0.0f, 0.0f, 1.0f}, 2.0f);
+
+    CHECK(close(slerp(from, to, 0.0f), from));
+    CHECK(close(slerp(from, to, 1.0f), to));
+    CHECK(close(slerp(from, to, 0.25f), quat::from_axis_angle({0.0f, 0.0f, 1.0f}, 0.5f)));
+    CHECK(almost_equal(magnitude(nlerp(from, to, 0.25f)), 1.0f, 0.0001f));
+
+    // Takes the shortest arc when the inputs lie in opposite hemispheres
+    CHECK(same_rotation(slerp(from, -to, 0.25f), quat::from_axis_angle({0.0f, 0.0f, 1.0f}, 0.5f)));
+
+    // Nearly parallel inputs fall back to nlerp
+    auto near = quat::from_axis_angle({0.0f, 0.0f, 1.0f}, 0.001f);
+    CHECK(close(slerp(from, near, 0.5f), quat::from_axis_angle({0.0f, 0.0f, 1.0f}, 0.0005f)));
+}
+
+TEST_CASE("quat batched slerp", "[quat]") {
+    auto from = test_quats(0.0f);
+    auto to   = test_quats(3.0f);
+    auto out  = std::vector<quat>(from.size());
+
+    slerp(from, to, 0.4f, out);
+    for(std::size_t i = 0; i < from.size(); ++i) {
+        CHECK(close(out[i], slerp(from[i], to[i], 0.4f)));
+    }
+
+    slerp(from, to, 0.4f, from);
+    for(std::size_t i = 0; i < from.size(); ++i) {
+        CHECK(close(from[i], out[i]));
+    }
+}
@@ -0,0 +1,147 @@
+#include "utils.hpp"
+#include <admat/parallel.hpp>
+#include <admat/rebase.hpp>
+#include <snitch/snitch.hpp>
+
+#include <cstddef>
+#include <vector>
+
+using namespace admat;
+
+namespace {
+
+auto same(const vec3& lhs, const vec3& rhs) -> bool {
+    return almost_equal(lhs.x, rhs.x) && almost_equal(lhs.y, rhs.y) && almost_equal(lhs.z, rhs.z);
+}
+
+// Positions a few thousand kilometres from the world origin, spread over a few hundred metres
+auto far_positions(std::size_t count) -> std::vector<dvec3> {
+    auto positions = std::vector<dvec3>{};
+    for(std::size_t i = 0; i < count; ++i) {
+        auto f = static_cast<double>(i);
+        positions.push_back(dvec3{6378137.0 + f * 0.731, -2500000.25 - f * 0.117, 1234567.5 + f * 0.003});
+    }
+    return positions;
+}
+
+} // namespace
+
+static_assert(rebase(dvec3{1.0, 2.0, 3.0}, dvec3{2.5, 2.0, 0.0}).z < -2.5f);
+static_assert(dot(dvec4{1.0, 2.0, 3.0, 4.0}, dvec4{1.0, 1.0, 1.0, 1.0}) > 9.5);
+
+TEST_CASE("Double precision kernels", "[rebase]") {
+    auto lhs = dvec4{1.0e9, 2.0, -3.0, 0.5};
+    auto rhs = dvec4{1.0, 1.0e-9, 4.0, 8.0};
+
+    CHECK(close(lhs + rhs, dvec4{1.0e9 + 1.0, 2.0 + 1.0e-9, 1.0, 8.5}, 1e-9));
+    CHECK(close(lhs - rhs, dvec4{1.0e9 - 1.0, 2.0 - 1.0e-9, -7.0, -7.5}, 1e-9));
+    CHECK(close(lhs * rhs, dvec4{1.0e9, 2.0e-9, -12.0, 4.0}, 1e-9));
+    CHECK(close(2.0 * rhs, dvec4{2.0, 2.0e-9, 8.0, 16.0}, 1e-9));
+    CHECK(almost_equal(dot(lhs, rhs), 1.0e9 + 2.0e-9 - 12.0 + 4.0, 1e-6));
+
+    // Same values as the generic templates
+    auto mat = dmat4{
+        {1.0, 2.0, 3.0, 4.0e6},
+        {5.0, 6.0, 7.0, -8.0e6},
+        {9.0, 10.0, 11.0, 12.0},
+        {0.0, 0.0, 0.0, 1.0},
+    };
+    auto vec = dvec4{0.25, -0.5, 2.0, 1.0};
+    CHECK(close(mat * vec, operator*<double, 4, 4>(mat, vec), 1e-9));
+
+    auto product = mat * transpose(mat);
+    auto generic = operator*<double, 4, 4, 4>(mat, transpose(mat));
+    CHECK(close(product.w, generic.w, 1e-9));
+    CHECK(close(product.x, generic.x, 1e-9));
+    CHECK(close(product.y, generic.y, 1e-9));
+    CHECK(close(product.z, generic.z, 1e-9));
+}
+
+TEST_CASE("Rebase positions", "[rebase]") {
+    auto origin = dvec3{6378100.125, -2500010.5, 1234560.75};
+
+    // Converting first loses the centimetres, rebasing in double keeps them
+    auto position = dvec3{6378137.01, -2500000.02, 1234567.03};
+    auto rebased  = rebase(origin, position);
+    CHECK(almost_equal(rebased.x, 36.885f, 0.00001f));
+    CHECK(almost_equal(rebased.y, 10.48f, 0.00001f));
+    CHECK(almost_equal(rebased.z, 6.28f, 0.00001f));
+    CHECK(!almost_equal(static_cast<float>(position.x) - static_cast<float>(origin.x), 36.885f, 0.01f));
+
+    // Every count up to a few blocks, so both the wide loop and the tail run
+    for(std::size_t count = 0; count < 14; ++count) {
+        auto in  = far_positions(count);
+        auto out = std::vector<vec3>(count);
+        rebase(origin, in, out);
+
+        auto all = true;
+        for(std::size_t i = 0; i < count; ++i) {
+            all = all && same(out[i], rebase(origin, in[i]));
+        }
+        CHECK(all);
+    }
+}
+
+TEST_CASE("Rebase transforms", "[rebase]") {
+    auto origin = dvec3{6378100.125, -2500010.5, 1234560.75};
+
+    auto transform = dmat4{
+        {0.0, -1.0, 0.0, 6378137.01},
+        {1.0, 0.0, 0.0, -2500000.02},
+        {0.0, 0.0, 2.0, 1234567.03},
+        {0.0, 0.0, 0.0, 1.0},
+    };
+    auto rebased = rebase(origin, transform);
+
+    // translation(-origin) * transform in double, then rounded
+    auto shift = dmat4{
+        {1.0, 0.0, 0.0, -origin.x},
+        {0.0, 1.0, 0.0, -origin.y},
+        {0.0, 0.0, 1.0, -origin.z},
+        {0.0, 0.0, 0.0, 1.0},
+    };
+    auto expected = shift * transform;
+    for(std::size_t row = 0; row < 4; ++row) {
+        for(std::size_t col = 0; col < 4; ++col) {
+            CHECK(almost_equal(rebased[row, col], static_cast<float>(expected[row, col]), 0.00001f));
+        }
+    }
+
+    // A point transformed in float after rebasing lands where the double transform puts it
+    auto local = rebased * vec4{1.0f, 2.0f, 3.0f, 1.0f};
+    auto world = transform * dvec4{1.0, 2.0, 3.0, 1.0};
+    auto moved = rebase(origin, dvec3{world.w, world.x, world.y});
+    CHECK(almost_equal(local.w, moved.x, 0.0001f));
+    CHECK(almost_equal(local.x, moved.y, 0.0001f));
+    CHECK(almost_equal(local.y, moved.z, 0.0001f));
+}
+
+TEST_CASE("Rebase through an executor", "[rebase]") {
+    auto pool   = thread_pool(2);
+    auto origin = dvec3{6378100.125, -2500010.5, 1234560.75};
+
+    auto positions  = far_positions(1001);
+    auto serial     = std::vector<vec3>(positions.size());
+    auto pooled     = std::vector<vec3>(positions.size());
+    auto transforms = std::vector<dmat4>{};
+    for(const auto& position : positions) {
+        transforms.push_back(dmat4{
+            {1.0, 0.0, 0.0, position.x},
+            {0.0, 1.0, 0.0, position.y},
+            {0.0, 0.0, 1.0, position.z},
+            {0.0, 0.0, 0.0, 1.0},
+        });
+    }
+    auto matrices = std::vector<mat4>(transforms.size());
+
+    rebase(origin, positions, serial);
+    rebase(pool, origin, positions, pooled, 37);
+    rebase(pool, origin, transforms, matrices, 37);
+
+    auto all = true;
+    for(std::size_t i = 0; i < positions.size(); ++i) {
+        auto moved = matrices[i].z;
+        all        = all && same(serial[i], pooled[i]) && same(serial[i], vec3{moved.w, moved.x, moved.y});
+    }
+    CHECK(all);
+}
@@ -0,0 +1,145 @@
+#include "utils.hpp"
+#include <admat/soa.hpp>
+#include <snitch/snitch.hpp>
+
+#include <vector>
+
+using namespace admat;
+
+namespace {
+
+// 19 elements cover a full SIMD block at every width plus a scalar tail
+auto test_vec3s(float offset) -> std::vector<vec3> {
+    auto vecs = std::vector<vec3>{};
+    for(std::size_t i = 0; i < 19; ++i) {
+        auto f = static_cast<float>(i) + offset;
+        vecs.push_back(vec3{f * 0.5f - 3.0f, 2.0f - f * 0.25f, f * 0.1f + 1.0f});
+    }
+    return vecs;
+}
+
+auto test_vec4s(float offset) -> std::vector<vec4> {
+    auto vecs = std::vector<vec4>{};
+    for(const auto& vec : test_vec3s(offset)) {
+        vecs.push_back(vec4{vec.z - 2.0f, vec.x, vec.y, vec.z});
+    }
+    return vecs;
+}
+
+} // namespace
+
+TEST_CASE("soa conversion", "[soa]") {
+    auto vec3s = test_vec3s(0.0f);
+    auto vec4s = test_vec4s(0.0f);
+
+    auto soa3 = vec3_soa::from_aos(vec3s);
+    auto soa4 = vec4_soa::from_aos(vec4s);
+    REQUIRE(soa3.size() == vec3s.size());
+    REQUIRE(soa4.size() == vec4s.size());
+
+    auto back3 = std::vector<vec3>(vec3s.size());
+    auto back4 = std::vector<vec4>(vec4s.size());
+    soa3.to_aos(back3);
+    soa4.to_aos(back4);
+
+    for(std::size_t i = 0; i < vec3s.size(); ++i) {
+        CHECK(close(back3[i], vec3s[i]));
+        CHECK(close(back4[i], vec4s[i]));
+        CHECK(close(soa3[i], vec3s[i]));
+    }
+}
+
+TEST_CASE("soa dot and distance", "[soa]") {
+    auto lhs3 = test_vec3s(0.0f);
+    auto rhs3 = test_vec3s(7.0f);
+    auto lhs4 = test_vec4s(0.0f);
+    auto rhs4 = test_vec4s(3.0f);
+
+    auto dots3      = std::vector<float>(lhs3.size());
+    auto dots4      = std::vector<float>(lhs4.size());
+    auto distances3 = std::vector<float>(lhs3.size());
+    auto distances4 = std::vector<float>(lhs4.size());
+
+    dot(vec3_soa::from_aos(lhs3), vec3_soa::from_aos(rhs3), dots3);
+    dot(vec4_soa::from_aos(lhs4), vec4_soa::from_aos(rhs4), dots4);
+    distance(vec3_soa::from_aos(lhs3), vec3_soa::from_aos(rhs3), distances3);
+    distance(vec4_soa::from_aos(lhs4), vec4_soa::from_aos(rhs4), distances4);
+
+    for(std::size_t i = 0; i < lhs3.size(); ++i) {
+        CHECK(almost_equal(dots3[i], dot(lhs3[i], rhs3[i]), 0.0001f));
+        CHECK(almost_equal(dots4[i], dot(lhs4[i], rhs4[i]), 0.0001f));
+        CHECK(almost_equal(distances3[i], distance(lhs3[i], rhs3[i]), 0.0001f));
+        CHECK(almost_equal(distances4[i], distance(lhs4[i], rhs4[i]), 0.0001f));
+    }
+}
+
+TEST_CASE("soa cross and normalize", "[soa]") {
+    auto lhs = test_vec3s(0.0f);
+    auto rhs = test_vec3s(5.0f);
+    auto v4s = test_vec4s(1.0f);
+
+    auto crosses = vec3_soa{};
+    cross(vec3_soa::from_aos(lhs), vec3_soa::from_aos(rhs), crosses);
+
+    // In place
+    auto normals = vec3_soa::from_aos(lhs);
+    normalize(normals, normals);
+
+    auto normals4 = vec4_soa{};
+    normalize(vec4_soa::from_aos(v4s), normals4);
+
+    for(std::size_t i = 0; i < lhs.size(); ++i) {
+        CHECK(close(crosses[i], cross(lhs[i], rhs[i])));
+        CHECK(close(normals[i], normalize(lhs[i])));
+        CHECK(close(normals4[i], normalize(v4s[i])));
+    }
+}
+
+TEST_CASE("soa lerp and clamp", "[soa]") {
+    auto from3 = test_vec3s(0.0f);
+    auto to3   = test_vec3s(4.0f);
+    auto from4 = test_vec4s(0.0f);
+    auto to4   = test_vec4s(2.0f);
+
+    auto lerped3  = vec3_soa{};
+    auto lerped4  = vec4_soa{};
+    auto clamped3 = vec3_soa{};
+    auto clamped4 = vec4_soa{};
+
+    lerp(vec3_soa::from_aos(from3), vec3_soa::from_aos(to3), 0.3f, lerped3);
+    lerp(vec4_soa::from_aos(from4), vec4_soa::from_aos(to4), 0.3f, lerped4);
+    clamp(vec3_soa::from_aos(from3), -1.0f, 1.5f, clamped3);
+    clamp(vec4_soa::from_aos(from4), -1.0f, 1.5f, clamped4);
+
+    for(std::size_t i = 0; i < from3.size(); ++i) {
+        CHECK(close(lerped3[i], lerp(from3[i], to3[i], 0.3f)));
+        CHECK(close(lerped4[i], lerp(from4[i], to4[i], 0.3f)));
+        CHECK(close(clamped3[i], clamp(from3[i], -1.0f, 1.5f)));
+        CHECK(close(clamped4[i], clamp(from4[i], -1.0f, 1.5f)));
+    }
+}
+
+TEST_CASE("soa reflect and refract", "[soa]") {
+    auto incident = test_vec3s(0.0f);
+    auto normal   = std::vector<vec3>{};
+    for(const auto& vec : test_vec3s(2.0f)) {
+        normal.push_back(normalize(vec));
+    }
+
+    auto reflected = vec3_soa{};
+    reflect(vec3_soa::from_aos(incident), vec3_soa::from_aos(normal), reflected);
+
+    // A large ratio forces total internal reflection on some lanes
+    for(auto ratio : {0.66f, 1.0f, 3.5f}) {
+        auto refracted = vec3_soa{};
+        refract(vec3_soa::from_aos(incident), vec3_soa::from_aos(normal), ratio, refracted);
+
+        for(std::size_t i = 0; i < incident.size(); ++i) {
+            CHECK(close(refracted[i], refract(incident[i], normal[i], ratio)));
+        }
+    }
+
+    for(std::size_t i = 0; i < incident.size(); ++i) {
+        CHECK(close(reflected[i], reflect(incident[i], normal[i])));
+    }
+}
@@ -1,41 +1,45 @@
 #pragma once
 
-#include <bit>
-#include <cmath>
-#include <concepts>
+#include "almost_equal.hpp"
+#include <admat/mat.hpp>
+#include <admat/vec.hpp>
+
+#include <cstddef>
 #include <cstdint>
-#include <limits>
+#include <vector>
 
 namespace admat {
 
-template<std::floating_point T>
-constexpr auto almost_equal(T a, T b) -> bool {
-    using int_type = std::conditional_t<std::is_same_v<T, float>, std::int32_t, std::int64_t>;
-    auto a_int     = std::bit_cast<int_type>(a);
-    auto b_int     = std::bit_cast<int_type>(b);
-
-    // a & b are exactly the same in memory
-    if(a_int == b_int) {
-        return true;
+template<std::floating_point T, std::size_t N>
+constexpr auto close(const vec<T, N>& lhs, const vec<T, N>& rhs, T tolerance = T(0.0001)) -> bool {
+    for(std::size_t i = 0; i < N; ++i) {
+        if(!almost_equal(lhs[i], rhs[i], tolerance)) {
+            return false;
+        }
     }
+    return true;
+}
 
-    auto a_abs   = std::abs(a);
-    auto b_abs   = std::abs(b);
-    auto diff    = std::abs(a - b);
-    auto max_val = std::max(a_abs, b_abs); // a_abs > b_abs ? a_abs : b_abs;
-    auto denorm  = std::numeric_limits<decltype(max_val)>::denorm_min();
-    auto epsilon = std::numeric_limits<decltype(max_val)>::epsilon() * max_val;
-
-    if((a_int << 1) == 0 || (b_int << 1) == 0 || ((a_abs + b_abs) < denorm)) {
-        return diff <= (epsilon * denorm);
+template<std::floating_point T, std::size_t R, std::size_t C>
+constexpr auto close(const mat<T, R, C>& lhs, const mat<T, R, C>& rhs, T tolerance = T(0.0001)) -> bool {
+    for(std::size_t row = 0; row < R; ++row) {
+        for(std::size_t col = 0; col < C; ++col) {
+            if(!almost_equal(lhs[row, col], rhs[row, col], tolerance)) {
+                return false;
+            }
+        }
     }
+    return true;
+}
 
-    return (diff / std::min(a_abs + b_abs, max_val)) < epsilon;
+// Rotates, scales unevenly and translates
+inline auto test_matrix() -> mat4 {
+    return translation(1.0f, -2.0f, 3.0f) * rotation(vec3{0.3f, 1.0f, -0.5f}, 0.7f) * scaling(2.0f, 0.5f, 1.5f);
 }
 
-template<std::floating_point T>
-constexpr auto almost_equal(T a, T b, T diff) -> bool {
-    return std::abs(a - b) < diff;
+// Bit idx of a mask written by the cull and intersection kernels
+inline auto is_set(const std::vector<std::uint64_t>& bits, std::size_t idx) -> bool {
+    return ((bits[idx / 64] >> (idx % 64)) & 1) != 0;
 }
 
-} // namespace admat
\ No newline at end of file
+} // namespace admat
@@ -564,4 +564,44 @@ TEST_CASE("vec4 lerp") {
     CHECK(almost_equal(half_lerp.x, 3.0f, 0.000001f));
     CHECK(almost_equal(half_lerp.y, 5.0f, 0.000001f));
     CHECK(almost_equal(half_lerp.z, 1.0f, 0.000001f));
-}
\ No newline at end of file
+}
+
+TEST_CASE("vec4 constant evaluation") {
+    constexpr auto from = vec4{1.0f, -2.0f, 3.0f, -4.0f};
+    constexpr auto to   = vec4{4.0f, 3.0f, -2.0f, 1.0f};
+
+    constexpr auto sum     = (from + to) * 2.0f - to / 2.0f;
+    constexpr auto clamped = clamp(abs(from), 1.5f, 3.5f);
+    constexpr auto product = dot(from, to);
+
+    static_assert(almost_equal(sum.w, 8.0f, 0.000001f));
+    static_assert(almost_equal(clamped.z, 3.5f, 0.000001f));
+    static_assert(almost_equal(product, -12.0f, 0.000001f));
+
+    // The runtime (SIMD) path must agree with the constant-evaluated scalar path
+    auto rt_from = from;
+    auto rt_to   = to;
+
+    auto rt_sum     = (rt_from + rt_to) * 2.0f - rt_to / 2.0f;
+    auto rt_clamped = clamp(abs(rt_from), 1.5f, 3.5f);
+    auto rt_lerp    = lerp(rt_from, rt_to, 0.3f);
+
+    constexpr auto lerped = lerp(from, to, 0.3f);
+
+    CHECK(almost_equal(rt_sum.w, sum.w, 0.000001f));
+    CHECK(almost_equal(rt_sum.x, sum.x, 0.000001f));
+    CHECK(almost_equal(rt_sum.y, sum.y, 0.000001f));
+    CHECK(almost_equal(rt_sum.z, sum.z, 0.000001f));
+
+    CHECK(almost_equal(rt_clamped.w, clamped.w, 0.000001f));
+    CHECK(almost_equal(rt_clamped.x, clamped.x, 0.000001f));
+    CHECK(almost_equal(rt_clamped.y, clamped.y, 0.000001f));
+    CHECK(almost_equal(rt_clamped.z, clamped.z, 0.000001f));
+
+    CHECK(almost_equal(rt_lerp.w, lerped.w, 0.00001f));
+    CHECK(almost_equal(rt_lerp.x, lerped.x, 0.00001f));
+    CHECK(almost_equal(rt_lerp.y, lerped.y, 0.00001f));
+    CHECK(almost_equal(rt_lerp.z, lerped.z, 0.00001f));
+
+    CHECK(almost_equal(dot(rt_from, rt_to), product, 0.000001f));
+}